@@ -0,0 +1,46 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef MP3SPLT_ASYNC_H
+
+splt_async_split *splt_as_start(splt_state *state, int *error);
+splt_state *splt_as_get_state(splt_async_split *as);
+int splt_as_get_fd(splt_async_split *as);
+int splt_as_get_status(splt_async_split *as, float *percent_progress);
+void splt_as_put_progress(splt_async_split *as, float percent_progress);
+const splt_stats *splt_as_get_stats(splt_async_split *as);
+int splt_as_join(splt_async_split *as);
+
+#define MP3SPLT_ASYNC_H
+
+#endif
+
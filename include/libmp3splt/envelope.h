@@ -0,0 +1,57 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#ifndef MP3SPLT_ENVELOPE_H
+
+void splt_en_detector_init(splt_silence_detector *detector,
+    float threshold, float min, short output);
+int splt_en_detector_put(splt_state *state, splt_silence_detector *detector,
+    double time, float peak, short flush, int *error);
+void splt_en_free(splt_state *state);
+void splt_en_start_recording(splt_state *state);
+int splt_en_put_block(splt_state *state, double time, float peak, float level);
+void splt_en_start_levels(splt_state *state);
+void splt_en_put_level(splt_state *state, double time, float level, int found);
+void splt_en_end_levels(splt_state *state, int found);
+int splt_en_detect_silence(splt_state *state, float threshold,
+    float min, int *error);
+int splt_en_detect_silence_in(splt_state *state, double begin, double length,
+    float threshold, float min, int *error);
+float splt_en_auto_threshold(splt_state *state, float min,
+    int number_tracks, int *error);
+int splt_en_read_cache(splt_state *state, const char *fname, int *error);
+void splt_en_write_cache(splt_state *state, const char *fname, int *error);
+
+#define MP3SPLT_ENVELOPE_H
+
+#endif
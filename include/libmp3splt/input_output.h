@@ -39,6 +39,15 @@ int splt_io_check_if_file(splt_state *state, const char *fname);
 char *splt_io_get_linked_fname(const char *fname);
 #endif
 
+void splt_io_set_input_policy(splt_state *state, FILE *file);
+void splt_io_set_output_policy(splt_state *state, FILE *file, off_t size);
+void splt_io_input_consumed(splt_state *state, FILE *file, off_t offset);
+void splt_io_release_output(splt_state *state, FILE *file);
+void splt_io_free(splt_state *state);
+
+//the consumed input is dropped from the page cache by steps of this size
+#define SPLT_IO_DROP_STEP (8 * 1024 * 1024)
+
 #define MP3SPLT_IO_H
 
 #endif
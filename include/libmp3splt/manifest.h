@@ -0,0 +1,46 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#ifndef MP3SPLT_MANIFEST_H
+
+int splt_mf_is_enabled(splt_state *state);
+void splt_mf_open(splt_state *state, int *error);
+int splt_mf_put_segment(splt_state *state, const char *output_fname,
+    off_t offset, off_t length,
+    const void *prefix, unsigned long prefix_length,
+    const void *suffix, unsigned long suffix_length);
+void splt_mf_close(splt_state *state, int *error);
+
+#define MP3SPLT_MANIFEST_H
+
+#endif
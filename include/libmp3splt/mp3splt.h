@@ -175,8 +175,98 @@ typedef struct {
    * @brief How many syncerrors have been found
    */
   long int serrors_points_num;
+  //number of points allocated
+  long int serrors_points_alloc;
 } splt_syncerrors;
 
+/************************************/
+/* Structures for the statistics    */
+
+/**
+ * @brief Phases of the split for which the time is measured
+ *
+ * @see splt_stats
+ */
+typedef enum {
+  /**
+   * @brief Checking which plugin handles the input file
+   */
+  SPLT_PHASE_PLUGIN_PROBE,
+  /**
+   * @brief Opening the input file and parsing its header
+   */
+  SPLT_PHASE_INFO,
+  /**
+   * @brief Scanning the input file for silences
+   */
+  SPLT_PHASE_SILENCE_SCAN,
+  /**
+   * @brief Searching the begin and end of the split files
+   */
+  SPLT_PHASE_CUTPOINT_SEARCH,
+  /**
+   * @brief Writing the split files
+   */
+  SPLT_PHASE_WRITE,
+  /**
+   * @brief Reading and writing the tags
+   */
+  SPLT_PHASE_TAGS,
+} splt_phase;
+
+#define SPLT_NUMBER_OF_PHASES 6
+
+/**
+ * @brief Performance counters of the last split
+ *
+ * The times of a phase do not include the times of the phases
+ * that it contains.
+ *
+ * @see mp3splt_get_stats
+ */
+typedef struct {
+  /**
+   * @brief Elapsed time in seconds of each phase, indexed by #splt_phase
+   */
+  double wall_time[SPLT_NUMBER_OF_PHASES];
+  /**
+   * @brief Processor time in seconds of each phase, indexed by #splt_phase
+   */
+  double cpu_time[SPLT_NUMBER_OF_PHASES];
+  /**
+   * @brief Bytes read from the input file
+   */
+  off_t bytes_read;
+  /**
+   * @brief Bytes written to the split files
+   */
+  off_t bytes_written;
+  /**
+   * @brief mp3 frames or ogg pages parsed
+   */
+  unsigned long frames_parsed;
+  /**
+   * @brief Frames decoded to samples
+   */
+  unsigned long frames_decoded;
+  /**
+   * @brief Synchronisation errors found in the input file
+   */
+  unsigned long sync_errors;
+  /**
+   * @brief Seeks done on the input file
+   */
+  unsigned long seeks;
+  /**
+   * @brief Frames of a fast silence scan checked again at full quality
+   */
+  unsigned long frames_rechecked;
+  /**
+   * @brief Memory allocations made by the library, in all its threads
+   */
+  unsigned long allocations;
+} splt_stats;
+
 /***************************************/
 /* Structures for the output format    */
 
@@ -275,13 +365,73 @@ typedef struct {
 /*****************************/
 /* Structure for the silence */
 
+//the silences found, in the order of the scan
 struct splt_ssplit {
-  double begin_position;
-  double end_position;
-  long len;
-  struct splt_ssplit *next;
+  double *begin_position;
+  double *end_position;
+  long *len;
+  //number of silences
+  int number;
+  //allocated size of the arrays
+  int allocated;
 };
 
+//state of the silence detection, fed with one decoded block at a time
+typedef struct {
+  //the silence threshold, as a linear amplitude
+  float threshold;
+  //the minimum length of a silence, in seconds
+  float min;
+  short first;
+  int shot;
+  //number of consecutive silent blocks
+  int len;
+  double silence_begin;
+  double silence_end;
+  //number of silences found
+  int found;
+} splt_silence_detector;
+
+//the peak and level of each decoded block of the file; the silence
+//detection can be replayed from it for any threshold without decoding
+typedef struct {
+  //time of the block, in seconds
+  double *time;
+  //the highest sample of the block, as a linear amplitude
+  float *peak;
+  //the smoothed level at the end of the block, as a linear amplitude
+  float *level;
+  long number;
+  long allocated;
+  //if we record the blocks while scanning
+  short recording;
+  //added to the time of the recorded blocks, when scanning a part
+  //of the file
+  double time_offset;
+  //if the blocks were scanned at reduced quality
+  short fast_scan;
+  //if the peaks of a fast scan were checked again at full quality
+  //around 'scan_threshold'
+  short rechecked;
+  float scan_threshold;
+} splt_envelope;
+
+//the silence levels sent to the client, one for each 'resolution'
+//seconds of the file
+typedef struct {
+  //buffer given by the client and its size, or NULL
+  float *levels;
+  long number;
+  //number of entries of the buffer filled by the last scan
+  long filled;
+  //seconds of each entry
+  float resolution;
+  //the current entry, its end time and its highest linear level
+  long current;
+  double current_end;
+  float current_max;
+} splt_silence_levels;
+
 /**********************************/
 /* Structure for the split        */
 
@@ -372,6 +522,8 @@ typedef struct {
   void (*get_silence_level)(long time, float level, void *user_data);
   //user data set by the client for the 'get_silence_level' function
   void *silence_level_client_data;
+  //the decimated silence levels
+  splt_silence_levels silence_levels;
   //sends a message to the main program to tell him what
   //he is doing; the second parameter is the type of split
   void (*put_message)(const char *, splt_message_type );
@@ -589,9 +741,28 @@ typedef struct {
   int auto_increment_tracknumber_tags;
 
   /**
-   * if we enable the silence points log ('mp3splt.log')
+   * if we enable the silence log ('mp3splt.log'), caching the
+   * envelope of the file for the next silence detections
    */
   int enable_silence_log;
+  //if we choose the silence threshold from the file levels
+  int auto_threshold;
+  //if we scan for silence at reduced quality
+  int fast_scan;
+  //if we position the splitpoints with a seek index
+  int seek_index;
+  //if a thread reads ahead the non seekable input
+  int read_ahead;
+  //if a thread writes the split files behind the split
+  int write_behind;
+  //if the split files are synchronized to the disk before being closed
+  int sync_output;
+  //if the kernel is advised of the sequential read of the input
+  int io_advice;
+  //if the disk space of the split files is reserved when opened
+  int preallocate_output;
+  //size of the stdio buffers of the input and the split files
+  int io_buffer_size;
 
   /**
    * If we force the mp3 tags version to 1 or 2 or 1 & 2;
@@ -610,14 +781,27 @@ typedef struct {
 /**********************************/
 /* Main structure                 */
 
+//resources used by a worker thread of the split, see stats.c
+typedef struct
+{
+  //processor time in seconds
+  double cpu_time;
+  unsigned long allocations;
+} splt_thread_usage;
+
 //internal structures
 typedef struct
 {
   //if we have send the message frame mode enabled
   int frame_mode_enabled;
-  //if current_refresh_rate = refresh_rate, we call
-  //the progress callback
-  int current_refresh_rate;
+  //progress calls left before we read the clock again
+  int progress_countdown;
+  //progress calls between the last two clock readings
+  int progress_calls;
+  //when we have last read the clock
+  double progress_check_time;
+  //when we have last called the progress callback
+  double progress_time;
   //if set to SPLT_TRUE,
   //then we don't send messages to clients
   int messages_locked;
@@ -628,6 +812,15 @@ typedef struct
   //used for the normal split
   double split_begin;
   double split_end;
+  //the phase we are currently measuring, or -1
+  int current_phase;
+  //when the current phase has been entered
+  double phase_wall_start;
+  double phase_cpu_start;
+  //allocations of the split thread when the split started, and
+  //allocations of the worker threads
+  unsigned long allocations_start;
+  unsigned long worker_allocations;
 } splt_internal;
 
 /*
@@ -653,6 +846,10 @@ typedef struct {
   double (*split)(void *state, const char *final_fname, double begin_point,
       double end_point, int *error, int save_end_point);
   int (*scan_silence)(void *state, int *error);
+  int (*scan_silence_window)(void *state, double begin_point,
+      double end_point, int *error);
+  int (*stream_silence_split)(void *state, int *error);
+  int (*rewrite_tags)(void *state, const char *output_fname, int *error);
   void (*set_original_tags)(void *state, int *error);
   void (*init)(void *state, int *error);
   void (*end)(void *state, int *error);
@@ -690,12 +887,32 @@ typedef struct
   char *strerror_msg;
 } splt_error;
 
+//asynchronous split handle, see mp3splt_split_async
+typedef struct splt_async_split splt_async_split;
+
+//stdio buffers and page cache state of the input, see SPLT_OPT_IO_BUFFER_SIZE
+typedef struct {
+  char *input_buffer;
+  int input_buffer_size;
+  char *output_buffer;
+  int output_buffer_size;
+  //the input before this offset was dropped from the page cache
+  off_t input_dropped;
+} splt_io_policy;
+
+//queue of the data written behind the split, see SPLT_OPT_WRITE_BEHIND
+typedef struct splt_write_behind splt_write_behind;
+
+//the split journal, see mp3splt_set_journal_filename
+typedef struct splt_journal splt_journal;
+
 //structure for the splt state
 typedef struct {
 
   //if we cancel split or not
   //set to SPLT_TRUE cancels the split
-  short cancel_split;
+  //-may be set from another thread with an asynchronous split
+  volatile short cancel_split;
   //filename to split
   char *fname_to_split;
   //where the split file will be split
@@ -703,6 +920,15 @@ typedef struct {
 
   //if this is non null, we write a m3u from the split files
   char *m3u_filename;
+  //if this is non null, we write a manifest instead of the split files
+  char *manifest_filename;
+  //the manifest file while splitting
+  FILE *manifest;
+  //if this is non null, we record the split files in a journal and
+  //resume the split from it
+  char *journal_filename;
+  //the journal while splitting
+  splt_journal *journal;
 
   //tags of the original file to split
   splt_tags original_tags;
@@ -729,7 +955,9 @@ typedef struct {
   splt_internal iopts;
 
   //see the ssplit structure
-  struct splt_ssplit *silence_list;
+  struct splt_ssplit silence_list;
+  //see the splt_envelope structure
+  splt_envelope envelope;
 
   //proxy infos
   //splt_proxy proxy;
@@ -746,6 +974,18 @@ typedef struct {
 
   //filename of the silence log: 'mp3splt.log' in the original mp3splt
   char *silence_log_fname;
+
+  //non NULL while an asynchronous split is running
+  splt_async_split *async;
+
+  //writer thread of the split files, started on the first write
+  splt_write_behind *write_behind;
+
+  //see SPLT_OPT_IO_ADVICE and SPLT_OPT_IO_BUFFER_SIZE
+  splt_io_policy io;
+
+  //performance counters, see mp3splt_get_stats
+  splt_stats stats;
 } splt_state;
 
 /*****************************************/
@@ -811,6 +1051,7 @@ typedef enum {
   SPLT_ERROR_TIME_SPLIT_VALUE_INVALID = -34,
   SPLT_ERROR_LENGTH_SPLIT_VALUE_INVALID = -35,
   SPLT_ERROR_CANNOT_GET_TOTAL_TIME = -36,
+  SPLT_ERROR_CANNOT_START_ASYNC_SPLIT = -37,
 
   SPLT_FREEDB_ERROR_INITIALISE_SOCKET = -101,
   SPLT_FREEDB_ERROR_CANNOT_GET_HOST = -102,
@@ -873,6 +1114,22 @@ typedef enum {
   SPLT_PROGRESS_SCAN_SILENCE
 } splt_progress_messages;
 
+/**
+ * @brief Status of an asynchronous split
+ *
+ * Returned by #mp3splt_async_get_status
+ */
+typedef enum {
+  /**
+   * The split is still running
+   */
+  SPLT_ASYNC_RUNNING,
+  /**
+   * The split has finished; call #mp3splt_async_join to get its result
+   */
+  SPLT_ASYNC_FINISHED
+} splt_async_status;
+
 //options types: integer
 /**
  * @brief Integer options
@@ -1006,7 +1263,12 @@ typedef enum {
    */
   SPLT_OPT_AUTO_INCREMENT_TRACKNUMBER_TAGS,
   /**
-   * if we enable the silence points log ('mp3splt.log')
+   * if we enable the silence log ('mp3splt.log')
+   *
+   * The log caches the peak level of each decoded frame, keyed by the
+   * size, modification time and content of the file; the next silence
+   * splits of the same file detect the silence from it without
+   * decoding, whatever the threshold, minimum length and offset
    */
   SPLT_OPT_ENABLE_SILENCE_LOG,
   /**
@@ -1020,7 +1282,112 @@ typedef enum {
   /**
    *
    */
-  SPLT_OPT_REPLACE_TAGS_IN_TAGS
+  SPLT_OPT_REPLACE_TAGS_IN_TAGS,
+  /**
+   * if we choose the threshold of the #SPLT_OPTION_SILENCE_MODE split
+   * from the levels of the file
+   *
+   * The threshold is taken in the valley between the noise floor and
+   * the music in the histogram of the frame levels, or as the lowest
+   * threshold giving #SPLT_OPT_PARAM_NUMBER_TRACKS tracks if set;
+   * #SPLT_OPT_PARAM_THRESHOLD is set to the threshold chosen
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_AUTO_THRESHOLD,
+  /**
+   * if we scan for silence at reduced quality
+   *
+   * The frames are synthesized at half the sample rate and downmixed
+   * to one channel; the mp3 frames with a peak close to
+   * #SPLT_OPT_PARAM_THRESHOLD are checked again at full quality
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_FAST_SCAN,
+  /**
+   * if we position the splitpoints with a seek index when not in
+   * #SPLT_OPT_FRAME_MODE
+   *
+   * The index is built once per file by reading the frame headers
+   * and the offsets are interpolated between its entries, instead
+   * of being computed from the bitrate of the first frame
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_SEEK_INDEX,
+  /**
+   * if a thread reads ahead the input when
+   * #SPLT_OPT_INPUT_NOT_SEEKABLE is enabled
+   *
+   * The input is read in large blocks while the frames are parsed and
+   * the split files written, so that a pipe is emptied without waiting
+   * for the split; it has no effect on windows
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_READ_AHEAD,
+  /**
+   * if the split files are written by a thread
+   *
+   * The data of the split files is queued in large blocks and written
+   * while the input is read; a write error is returned by the next
+   * write or when the split file is closed. It has no effect on windows
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_WRITE_BEHIND,
+  /**
+   * if the split files are synchronized to the disk with fsync
+   * before being closed
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_SYNC_OUTPUT,
+  /**
+   * if the kernel is advised that the input is read sequentially
+   *
+   * The parts of the input already split are dropped from the page
+   * cache, so that splitting a large file doesn't evict the cache of
+   * the other programs
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_IO_ADVICE,
+  /**
+   * if the disk space of a split file is reserved when it is opened,
+   * from its size when known or estimated from the bitrate; this only
+   * works on linux
+   *
+   * The option can take the values #SPLT_TRUE or #SPLT_FALSE
+   *
+   * Default is #SPLT_FALSE
+   */
+  SPLT_OPT_PREALLOCATE_OUTPUT,
+  /**
+   * size in bytes of the stdio buffers of the input and of the split
+   * files
+   *
+   * The option can take positive integer values; 0 keeps the buffers
+   * of the C library
+   *
+   * Default is 0
+   */
+  SPLT_OPT_IO_BUFFER_SIZE
 } splt_int_options;
 
 //options types: long
@@ -1219,6 +1586,8 @@ int mp3splt_set_path_of_split(splt_state *state, const char *path);
 //returns possible error
 int mp3splt_set_filename_to_split(splt_state *state, const char *filename);
 int mp3splt_set_m3u_filename(splt_state *state, const char *filename);
+int mp3splt_set_manifest_filename(splt_state *state, const char *filename);
+int mp3splt_set_journal_filename(splt_state *state, const char *filename);
 int mp3splt_set_silence_log_filename(splt_state *state, const char *filename);
 
 /************************************/
@@ -1233,6 +1602,11 @@ int mp3splt_set_progress_function(splt_state *state,
 int mp3splt_set_silence_level_function(splt_state *state,
   void (*get_silence_cb)(long time, float level, void *user_data),
   void *user_data);
+//the silence levels (in dB) of each 'resolution' seconds of the file
+//are put in 'levels', of 'number' elements, while scanning for silence
+int mp3splt_set_silence_levels_buffer(splt_state *state,
+    float *levels, long number, float resolution);
+long mp3splt_get_silence_levels_filled(splt_state *state, int *error);
 
 /************************************/
 /* Splitpoints                      */
@@ -1304,6 +1678,36 @@ int mp3splt_split(splt_state *state);
 void mp3splt_stop_split(splt_state *state,
     int *error);
 
+//starts the split in a new thread and returns immediately
+//-the state must not be modified until mp3splt_async_join is called
+//-the progress callback is called from the split thread
+//-returns NULL if error
+splt_async_split *mp3splt_split_async(splt_state *state, int *error);
+
+//returns a file descriptor that becomes readable on progress
+//or when the split is finished; usable with poll/select/epoll
+int mp3splt_async_get_fd(splt_async_split *as);
+
+//non blocking: returns a value from #splt_async_status and
+//puts the current progress in 'percent_progress' if not NULL
+//-consumes the pending notifications of the file descriptor
+int mp3splt_async_get_status(splt_async_split *as,
+    float *percent_progress);
+
+//asks the split thread to stop as soon as possible
+void mp3splt_async_cancel(splt_async_split *as);
+
+//waits for the split to finish, frees the handle
+//and returns the result of the split
+int mp3splt_async_join(splt_async_split *as);
+
+//returns the performance counters of the current or last split
+//-during an asynchronous split, returns a copy of the counters taken
+//at the last progress, valid until the next call or mp3splt_async_join
+//-during a synchronous split, the counters can be read from the
+//callbacks of the split
+const splt_stats *mp3splt_get_stats(splt_state *state, int *error);
+
 /************************************/
 /*    Cddb and Cue functions        */
 
@@ -43,6 +43,13 @@ double splt_p_split(splt_state *state, const char *final_fname, double begin_poi
 int splt_p_simple_split(splt_state *state, const char *output_fname, off_t begin,
     off_t end);
 int splt_p_scan_silence(splt_state *state, int *error);
+int splt_p_can_scan_silence_window(splt_state *state);
+int splt_p_scan_silence_window(splt_state *state, double begin_point,
+    double end_point, int *error);
+int splt_p_can_stream_silence_split(splt_state *state);
+int splt_p_stream_silence_split(splt_state *state, int *error);
+int splt_p_can_rewrite_tags(splt_state *state);
+int splt_p_rewrite_tags(splt_state *state, const char *output_fname, int *error);
 void splt_p_set_original_tags(splt_state *state, int *error);
 
 //
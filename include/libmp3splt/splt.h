@@ -46,6 +46,12 @@
 #include "string_utils.h"
 #include "tags_utils.h"
 #include "input_output.h"
+#include "async.h"
+#include "stats.h"
+#include "manifest.h"
+#include "envelope.h"
+#include "write_behind.h"
+#include "journal.h"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -79,6 +85,8 @@ void splt_s_equal_length_split(splt_state *state, int *error);
 /* splt silence detection and split */
 
 int splt_s_set_silence_splitpoints(splt_state *state, int *error);
+char *splt_s_stream_track_begin(splt_state *state, long begin, int *error);
+char *splt_s_stream_track_end(splt_state *state, long end, int *error);
 void splt_s_silence_split(splt_state *state, int *error);
 
 /****************************/
@@ -86,20 +94,42 @@ void splt_s_silence_split(splt_state *state, int *error);
 
 void splt_s_wrap_split(splt_state *state, int *error);
 
+/****************************/
+/* splt split file */
+
+void splt_s_split_file(splt_state *state, int *error);
+
 /* other stuff:/ */
 
+//number of progress calls before the first clock reading
 #define SPLT_DEFAULT_PROGRESS_RATE 350
 #define SPLT_DEFAULT_PROGRESS_RATE2 50
+//seconds between two progress callbacks
+#define SPLT_PROGRESS_INTERVAL 0.1
+//clock readings per progress interval
+#define SPLT_PROGRESS_CHECKS 4
+//max number of progress calls between two clock readings
+#define SPLT_PROGRESS_MAX_CALLS 1000000
 
 #define SPLT_DEFAULTSILLEN 10
 #define SPLT_DEFAULTSHOT 25
 
 #define SPLT_VARCHAR '@'
 
-//max number of splitpoints 
-//for silence detection and for syncerrors
+//max number of splitpoints for syncerrors
 #define SPLT_MAXSYNC INT_MAX
-#define SPLT_MAXSILENCE INT_MAX
+//initial number of syncerror splitpoints allocated
+#define SPLT_SERRORS_ALLOC 64
+
+//initial number of silences allocated in the silence list
+#define SPLT_SILENCE_LIST_ALLOC 64
+
+//number of tracks used for the digits of the output filenames, when
+//we don't know how many tracks a stream has
+#define SPLT_STREAM_TRACKS_DIGITS 99
+
+//seconds of each silence level sent to the client
+#define SPLT_DEFAULT_SILENCE_LEVELS_RESOLUTION 0.2
 
 /* libmp3splt internals */
 #define SPLT_IERROR_INT -1
@@ -0,0 +1,50 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+#ifndef MP3SPLT_STATS_H
+
+double splt_st_wall_time();
+void splt_st_reset(splt_state *state);
+int splt_st_enter_phase(splt_state *state, int phase);
+void splt_st_leave_phase(splt_state *state, int previous_phase);
+void splt_st_update(splt_state *state);
+void splt_st_print_debug(splt_state *state);
+void splt_st_get_thread_usage(splt_thread_usage *usage);
+void splt_st_sum_thread_usage(splt_thread_usage *sum,
+    const splt_thread_usage *usage);
+void splt_st_add_thread_usage(splt_state *state, int phase,
+    const splt_thread_usage *usage, splt_thread_usage *collected);
+
+#define MP3SPLT_STATS_H
+
+#endif
+
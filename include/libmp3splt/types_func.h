@@ -54,12 +54,18 @@ char *splt_t_get_new_filename_path(splt_state *state);
 int splt_t_set_filename_to_split(splt_state *state, const char *filename);
 int splt_t_set_path_of_split(splt_state *state, const char *path);
 int splt_t_set_m3u_filename(splt_state *state, const char *filename);
+int splt_t_set_manifest_filename(splt_state *state, const char *filename);
+int splt_t_set_journal_filename(splt_state *state, const char *filename);
 int splt_t_set_silence_log_fname(splt_state *state, const char *filename);
 char *splt_t_get_filename_to_split(splt_state *state);
 char *splt_t_get_path_of_split(splt_state *state);
 char *splt_t_get_m3u_filename(splt_state *state);
+char *splt_t_get_manifest_filename(splt_state *state);
+char *splt_t_get_journal_filename(splt_state *state);
 char *splt_t_get_silence_log_fname(splt_state *state);
 char *splt_t_get_m3u_file_with_path(splt_state *state, int *error);
+char *splt_t_get_manifest_file_with_path(splt_state *state, int *error);
+char *splt_t_get_journal_file_with_path(splt_state *state, int *error);
 
 /********************************/
 /* types: current split access */
@@ -145,9 +151,12 @@ void splt_t_freedb_free_search(splt_state *state);
 /********************************/
 /* types: silence access */
 
-int splt_t_ssplit_new(struct splt_ssplit **silence_list, 
+int splt_t_ssplit_new(struct splt_ssplit *silence_list, 
     float begin_position, float end_position, int len, int *error);
-void splt_t_ssplit_free (struct splt_ssplit **silence_list);
+void splt_t_ssplit_free(struct splt_ssplit *silence_list);
+int splt_t_ssplit_get_longest(struct splt_ssplit *silence_list);
+int *splt_t_ssplit_select_longest(struct splt_ssplit *silence_list,
+    int number, int *error);
 
 /********************************/
 /* types: syncerrors access */
@@ -173,6 +182,7 @@ int splt_t_put_split_file(splt_state *state, const char *filename);
 void splt_t_put_progress_text(splt_state *state,int type);
 void splt_t_put_info_message_to_client(splt_state *state, char *message);
 void splt_t_put_debug_message_to_client(splt_state *state, char *message);
+void splt_t_reset_progress_rate(splt_state *state);
 void splt_t_update_progress(splt_state *state, double current_point,
     double total_points, int progress_stage,
     float progress_start, int refresh_rate);
@@ -40,6 +40,15 @@
 #include <direct.h>
 #endif
 
+/****************************/
+/* utils for memory */
+
+void *splt_u_malloc(size_t size);
+void *splt_u_realloc(void *ptr, size_t size);
+void *splt_u_calloc(size_t nmemb, size_t size);
+char *splt_u_strdup(const char *s);
+unsigned long splt_u_get_allocations();
+
 /****************************/
 /* utils for conversion */
 
@@ -71,8 +80,7 @@ char *splt_u_get_fname_with_path_and_extension(splt_state *state,
 /* utils for splitpoints */
 
 int splt_u_cut_splitpoint_extension(splt_state *state, int index);
-void splt_u_order_splitpoints(splt_state *state, int len);
-int splt_u_parse_ssplit_file(splt_state *state, FILE *log_file, int *error);
+int splt_u_order_splitpoints(splt_state *state, int len);
 
 /****************************/
 /* utils for the tags       */
@@ -93,7 +101,7 @@ void splt_u_error(int error_type, const char *function,
 /****************************/
 /* utils miscellaneous */
 
-float splt_u_silence_position(struct splt_ssplit *temp, float off);
+float splt_u_silence_position(struct splt_ssplit *silence_list, int i, float off);
 void splt_u_print_debug(splt_state *state, const char *message,
     double optional, const char *optional2);
 double splt_u_get_double_pos(long split);
@@ -109,6 +117,7 @@ int splt_u_mkdir(splt_state *state, const char *path);
 
 size_t splt_u_fwrite(splt_state *state, const void *ptr,
     size_t size, size_t nmemb, FILE *stream);
+int splt_u_fclose_output(splt_state *state, FILE *stream);
 
 #ifdef __WIN32__
 char *splt_u_win32_utf16_to_utf8(const wchar_t *source);
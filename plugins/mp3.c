@@ -35,6 +35,11 @@
 #ifdef __WIN32__
 #include <io.h>
 #include <fcntl.h>
+#else
+#include <pthread.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/syscall.h>
 #endif
 
 #include "splt.h"
@@ -203,12 +208,18 @@ static FILE *splt_mp3_open_file_read(splt_state *state, const char *filename,
       splt_t_set_error_data(state,filename);
       *error = SPLT_ERROR_CANNOT_OPEN_FILE;
     }
+    else
+    {
+      splt_io_set_input_policy(state, file_input);
+    }
   }
 
   return file_input;
 }
 
-static FILE *splt_mp3_open_file_write(splt_state *state, const char *output_fname, int *error)
+//'size' is the expected size of the file, 0 if unknown
+static FILE *splt_mp3_open_file_write(splt_state *state, const char *output_fname,
+    off_t size, int *error)
 {
   FILE *file_output = NULL;
 
@@ -228,6 +239,10 @@ static FILE *splt_mp3_open_file_write(splt_state *state, const char *output_fnam
       splt_t_set_error_data(state,output_fname);
       *error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
     }
+    else
+    {
+      splt_io_set_output_policy(state, file_output, size);
+    }
   }
 
   return file_output;
@@ -237,31 +252,282 @@ static FILE *splt_mp3_open_file_write(splt_state *state, const char *output_fnam
 /****************************/
 /* CRC functions */
 
-static unsigned long splt_mp3_c_crc(splt_state *state,
-    FILE *in, off_t begin, off_t end, int *error)
+//the tables of the slice-by-8 crc: the table 'k' gives the crc of a
+//byte followed by 'k' zero bytes
+static void splt_mp3_crc_slice_tables(unsigned long tables[8][256])
+{
+  int i, k;
+
+  for (i = 0;i < 256;i++)
+  {
+    tables[0][i] = splt_mp3_crctab[i];
+  }
+  for (k = 1;k < 8;k++)
+  {
+    for (i = 0;i < 256;i++)
+    {
+      unsigned long crc = tables[k-1][i];
+      tables[k][i] = (crc >> 8) ^ splt_mp3_crctab[crc & 0xFF];
+    }
+  }
+}
+
+//updates the crc with a buffer, 8 bytes at a time
+static unsigned long splt_mp3_crc_slice8(unsigned long tables[8][256],
+    unsigned long crc, const unsigned char *buf, size_t len)
+{
+  while (len >= 8)
+  {
+    unsigned long low = crc ^ ((unsigned long) buf[0] |
+        ((unsigned long) buf[1] << 8) | ((unsigned long) buf[2] << 16) |
+        ((unsigned long) buf[3] << 24));
+
+    crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+      tables[5][(low >> 16) & 0xFF] ^ tables[4][(low >> 24) & 0xFF] ^
+      tables[3][buf[4]] ^ tables[2][buf[5]] ^
+      tables[1][buf[6]] ^ tables[0][buf[7]];
+
+    buf += 8;
+    len -= 8;
+  }
+
+  while (len-- > 0)
+  {
+    crc = (crc >> 8) ^ splt_mp3_crctab[(crc ^ *buf++) & 0xFF];
+  }
+
+  return crc;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPLT_MP3_CRC_CLMUL
+
+#include <cpuid.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+
+//returns true if the processor has the carry-less multiplication
+static int splt_mp3_crc_has_clmul()
+{
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+  {
+    return SPLT_FALSE;
+  }
+
+  //pclmulqdq and sse4.1
+  return (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+}
+
+//folds the buffer with carry-less multiplications, as in "Fast CRC
+//Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+//(Intel, 2009); 'len' must be a multiple of 16 and at least 64
+__attribute__((target("pclmul,sse4.1")))
+static unsigned long splt_mp3_crc_clmul(unsigned long crc,
+    const unsigned char *buf, size_t len)
+{
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+  x1 = _mm_loadu_si128((const __m128i *) (buf + 0x00));
+  x2 = _mm_loadu_si128((const __m128i *) (buf + 0x10));
+  x3 = _mm_loadu_si128((const __m128i *) (buf + 0x20));
+  x4 = _mm_loadu_si128((const __m128i *) (buf + 0x30));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) crc));
+  buf += 64;
+  len -= 64;
+
+  //fold 4 blocks of 16 bytes in parallel
+  while (len >= 64)
+  {
+    x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+        _mm_loadu_si128((const __m128i *) (buf + 0x00)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+        _mm_loadu_si128((const __m128i *) (buf + 0x10)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+        _mm_loadu_si128((const __m128i *) (buf + 0x20)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+        _mm_loadu_si128((const __m128i *) (buf + 0x30)));
+    buf += 64;
+    len -= 64;
+  }
+
+  //fold the 4 blocks into one
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  //fold the remaining blocks of 16 bytes
+  while (len >= 16)
+  {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+        _mm_loadu_si128((const __m128i *) buf));
+    buf += 16;
+    len -= 16;
+  }
+
+  //fold 128 bits to 64 bits
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask32);
+  x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  //barrett reduction to 32 bits
+  x0 = _mm_and_si128(x1, mask32);
+  x0 = _mm_clmulepi64_si128(x0, poly, 0x10);
+  x0 = _mm_and_si128(x0, mask32);
+  x0 = _mm_clmulepi64_si128(x0, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x0);
+
+  return (unsigned long) (unsigned int) _mm_extract_epi32(x1, 1);
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define SPLT_MP3_CRC_ARM
+
+#include <arm_acle.h>
+
+//updates the crc with the armv8 crc32 instructions
+static unsigned long splt_mp3_crc_arm(unsigned long crc,
+    const unsigned char *buf, size_t len)
+{
+  uint32_t c = (uint32_t) crc;
+
+  while (len >= 8)
+  {
+    uint64_t word;
+    memcpy(&word, buf, 8);
+    c = __crc32d(c, word);
+    buf += 8;
+    len -= 8;
+  }
+  while (len-- > 0)
+  {
+    c = __crc32b(c, *buf++);
+  }
+
+  return c;
+}
+#endif
+
+//computes the crc of the bytes from 'begin' to 'end' of the file;
+//the file is read by blocks and the fastest available crc is chosen
+//at runtime
+//-only the cancel flag of 'state' is read, so that it can run in
+//another thread than the split; the bytes read are added to 'bytes_read'
+static unsigned long splt_mp3_crc_range(splt_state *state,
+    FILE *in, off_t begin, off_t end, off_t *bytes_read, int *error)
 {
-  register unsigned long crc;
-  int c;
+  unsigned long crc = 0xFFFFFFFF;
+  unsigned long tables[8][256];
+  unsigned char *buffer = NULL;
 
-  crc = 0xFFFFFFFF;
+#ifdef SPLT_MP3_CRC_CLMUL
+  int clmul = splt_mp3_crc_has_clmul();
+#endif
 
   if (fseeko(in, begin, SEEK_SET) == -1)
   {
-    splt_t_set_strerror_msg(state);
-    splt_t_set_error_data(state,splt_t_get_filename_to_split(state));
     *error = SPLT_ERROR_SEEKING_FILE;
     return 0;
   }
 
-  while(begin++ < end)
+  if ((buffer = splt_u_malloc(SPLT_MP3_CRC_BUFFER_SIZE)) == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return 0;
+  }
+
+  splt_mp3_crc_slice_tables(tables);
+
+  while (begin < end)
   {
-    c = fgetc(in);
-    crc = ((crc >> 8) & 0x00FFFFFF) ^ splt_mp3_crctab[(crc ^ c) & 0xFF];
+    size_t to_read = SPLT_MP3_CRC_BUFFER_SIZE;
+    if ((off_t) to_read > end - begin)
+    {
+      to_read = (size_t) (end - begin);
+    }
+
+    size_t len = fread(buffer, 1, to_read, in);
+    *bytes_read += len;
+    begin += to_read;
+
+    //like fgetc, missing bytes at the end of the file count as EOF
+    if (len < to_read)
+    {
+      memset(buffer + len, 0xFF, to_read - len);
+      len = to_read;
+    }
+
+    const unsigned char *buf = buffer;
+#if defined(SPLT_MP3_CRC_CLMUL)
+    if (clmul && (len >= 64))
+    {
+      size_t blocks = len & ~((size_t) 15);
+      crc = splt_mp3_crc_clmul(crc, buf, blocks);
+      buf += blocks;
+      len -= blocks;
+    }
+    crc = splt_mp3_crc_slice8(tables, crc, buf, len);
+#elif defined(SPLT_MP3_CRC_ARM)
+    crc = splt_mp3_crc_arm(crc, buf, len);
+#else
+    crc = splt_mp3_crc_slice8(tables, crc, buf, len);
+#endif
+
+    if (splt_t_split_is_canceled(state))
+    {
+      free(buffer);
+      *error = SPLT_SPLIT_CANCELLED;
+      return 0;
+    }
   }
 
+  free(buffer);
+
   return (crc ^ 0xFFFFFFFF);
 }
 
+//computes the crc of the bytes from 'begin' to 'end' of the file
+static unsigned long splt_mp3_c_crc(splt_state *state,
+    FILE *in, off_t begin, off_t end, int *error)
+{
+  unsigned long crc =
+    splt_mp3_crc_range(state, in, begin, end, &state->stats.bytes_read, error);
+
+  if (*error == SPLT_ERROR_SEEKING_FILE)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state,splt_t_get_filename_to_split(state));
+  }
+
+  return crc;
+}
+
 /****************************/
 /* mp3 utils */
 
@@ -308,15 +574,51 @@ static int splt_mp3_c_bitrate (unsigned long head)
   return ((head>>12)&0xf);
 }
 
+//fills the header table from the infos of the first header: every
+//header word is then checked and sized with one lookup
+static void splt_mp3_init_head_table(splt_mp3_state *mp3state)
+{
+  struct splt_mp3 *mp3f = &mp3state->mp3file;
+  unsigned long i;
+
+  for (i = 0;i < SPLT_MP3_HEAD_TABLE_SIZE;i++)
+  {
+    unsigned long headword = SPLT_MP3_HEAD_SYNC | (i << 9);
+    struct splt_mp3_head_entry *entry = &mp3state->head_table[i];
+
+    entry->index = splt_mp3_c_bitrate(headword);
+    entry->bitrate = splt_mp3_tabsel_123[1 - mp3f->mpgid][mp3f->layer-1][entry->index];
+    entry->framesize = (entry->bitrate*144000)/
+      (mp3f->freq<<(1 - mp3f->mpgid)) + ((headword>>9)&0x1);
+  }
+}
+
+//returns the header table entry of a header word
+static const struct splt_mp3_head_entry *splt_mp3_head_entry(
+    splt_mp3_state *mp3state, unsigned long headword)
+{
+  return &mp3state->head_table[SPLT_MP3_HEAD_INDEX(headword)];
+}
+
+//returns true if the header word is a valid mp3 header
+static int splt_mp3_head_is_valid(splt_mp3_state *mp3state,
+    unsigned long headword)
+{
+  return ((headword & SPLT_MP3_HEAD_SYNC) == SPLT_MP3_HEAD_SYNC) &&
+    splt_mp3_head_entry(mp3state, headword)->index;
+}
+
 //make mp3 header bitrate, padding, offset, framesize
-static struct splt_header splt_mp3_makehead (unsigned long headword, 
-    struct splt_mp3 mp3f, struct splt_header head, off_t ptr)
+static struct splt_header splt_mp3_makehead (splt_mp3_state *mp3state,
+    unsigned long headword, struct splt_header head, off_t ptr)
 {
+  const struct splt_mp3_head_entry *entry =
+    splt_mp3_head_entry(mp3state, headword);
+
   head.ptr = ptr;
-  head.bitrate = splt_mp3_tabsel_123[1 - mp3f.mpgid][mp3f.layer-1][splt_mp3_c_bitrate(headword)];
+  head.bitrate = entry->bitrate;
   head.padding = ((headword>>9)&0x1);
-  head.framesize = (head.bitrate*144000)/
-    (mp3f.freq<<(1 - mp3f.mpgid)) + head.padding;
+  head.framesize = entry->framesize;
 
   return head;
 }
@@ -333,7 +635,7 @@ static off_t splt_mp3_findhead (splt_mp3_state *mp3state, off_t start)
   {
     return -1;
   }
-  while (!(splt_mp3_c_bitrate(mp3state->headw)))
+  while (!splt_mp3_head_is_valid(mp3state, mp3state->headw))
   {
     if (feof(mp3state->file_input)) 
     {
@@ -361,7 +663,7 @@ static off_t splt_mp3_findvalidhead (splt_mp3_state *mp3state, off_t start)
     {
       break;
     }
-    h = splt_mp3_makehead (mp3state->headw, mp3state->mp3file, h, start);
+    h = splt_mp3_makehead(mp3state, mp3state->headw, h, start);
     begin = splt_mp3_findhead(mp3state, (start + 1));
   } while (begin!=(start + h.framesize));
 
@@ -388,9 +690,237 @@ static int splt_mp3_xing_info_off(splt_mp3_state *mp3state)
   return 0;
 }
 
+/****************************/
+/* mp3 read ahead */
+
+#ifndef __WIN32__
+
+//a block of the input read by the reader thread
+struct splt_mp3_read_ahead_block {
+  unsigned char *data;
+  size_t length;
+};
+
+//ring of blocks filled by the reader thread and emptied by the plugin
+struct splt_mp3_read_ahead {
+  FILE *in;
+  pthread_t thread;
+  //the mutex only guards the counters of the blocks; the data of a block
+  //belongs either to the reader or to the plugin
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct splt_mp3_read_ahead_block blocks[SPLT_MP3_READ_AHEAD_BLOCKS];
+  //number of blocks filled and taken since the beginning
+  unsigned long filled;
+  unsigned long taken;
+  //set by the reader at the end of the input
+  short end_of_input;
+  //set by the plugin to stop the reader
+  short stop;
+  //position of the plugin in the block 'taken'
+  size_t position;
+  //set when a read of the plugin reached the end of the input, like feof
+  short eof;
+  //resources used by the reader thread
+  splt_thread_usage usage;
+};
+
+static void *splt_mp3_read_ahead_thread(void *data)
+{
+  struct splt_mp3_read_ahead *ra = data;
+
+  while (! ra->end_of_input)
+  {
+    pthread_mutex_lock(&ra->mutex);
+    while (!ra->stop &&
+        (ra->filled - ra->taken) == SPLT_MP3_READ_AHEAD_BLOCKS)
+    {
+      pthread_cond_wait(&ra->cond, &ra->mutex);
+    }
+    short stop = ra->stop;
+    pthread_mutex_unlock(&ra->mutex);
+
+    if (stop)
+    {
+      break;
+    }
+
+    struct splt_mp3_read_ahead_block *block =
+      &ra->blocks[ra->filled % SPLT_MP3_READ_AHEAD_BLOCKS];
+    size_t length =
+      fread(block->data, 1, SPLT_MP3_READ_AHEAD_BLOCK_SIZE, ra->in);
+
+    pthread_mutex_lock(&ra->mutex);
+    block->length = length;
+    if (length > 0)
+    {
+      ra->filled++;
+    }
+    if (length < SPLT_MP3_READ_AHEAD_BLOCK_SIZE)
+    {
+      ra->end_of_input = SPLT_TRUE;
+    }
+    pthread_cond_signal(&ra->cond);
+    pthread_mutex_unlock(&ra->mutex);
+  }
+
+  splt_st_get_thread_usage(&ra->usage);
+
+  return NULL;
+}
+
+//stops the reader thread and frees the ring
+static void splt_mp3_read_ahead_stop(splt_state *state,
+    struct splt_mp3_read_ahead *ra)
+{
+  int i = 0;
+
+  pthread_mutex_lock(&ra->mutex);
+  ra->stop = SPLT_TRUE;
+  pthread_cond_signal(&ra->cond);
+  pthread_mutex_unlock(&ra->mutex);
+
+  pthread_join(ra->thread, NULL);
+
+  //the input is read ahead while the split files are written
+  splt_st_add_thread_usage(state, SPLT_PHASE_WRITE, &ra->usage, NULL);
+
+  pthread_cond_destroy(&ra->cond);
+  pthread_mutex_destroy(&ra->mutex);
+  for (i = 0;i < SPLT_MP3_READ_AHEAD_BLOCKS;i++)
+  {
+    free(ra->blocks[i].data);
+  }
+  free(ra);
+}
+
+//starts the thread reading the input in the ring
+//-returns NULL if error
+static struct splt_mp3_read_ahead *splt_mp3_read_ahead_start(FILE *in, int *error)
+{
+  int i = 0;
+
+  struct splt_mp3_read_ahead *ra = splt_u_malloc(sizeof(struct splt_mp3_read_ahead));
+  if (ra == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
+  }
+  memset(ra, 0x0, sizeof(struct splt_mp3_read_ahead));
+  ra->in = in;
+
+  for (i = 0;i < SPLT_MP3_READ_AHEAD_BLOCKS;i++)
+  {
+    ra->blocks[i].data = splt_u_malloc(SPLT_MP3_READ_AHEAD_BLOCK_SIZE);
+    if (ra->blocks[i].data == NULL)
+    {
+      goto error;
+    }
+  }
+
+  pthread_mutex_init(&ra->mutex, NULL);
+  pthread_cond_init(&ra->cond, NULL);
+
+  if (pthread_create(&ra->thread, NULL, splt_mp3_read_ahead_thread, ra) != 0)
+  {
+    pthread_cond_destroy(&ra->cond);
+    pthread_mutex_destroy(&ra->mutex);
+    goto error;
+  }
+
+  return ra;
+
+error:
+  for (i = 0;i < SPLT_MP3_READ_AHEAD_BLOCKS;i++)
+  {
+    free(ra->blocks[i].data);
+  }
+  free(ra);
+  *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  return NULL;
+}
+
+//copies up to 'size' bytes of the ring in 'ptr'
+//-returns the number of bytes copied, less than 'size' at the end of
+//the input
+static size_t splt_mp3_read_ahead_read(struct splt_mp3_read_ahead *ra,
+    unsigned char *ptr, size_t size)
+{
+  size_t copied = 0;
+
+  while (copied < size)
+  {
+    pthread_mutex_lock(&ra->mutex);
+    while (ra->filled == ra->taken && !ra->end_of_input)
+    {
+      pthread_cond_wait(&ra->cond, &ra->mutex);
+    }
+    short empty = (ra->filled == ra->taken);
+    pthread_mutex_unlock(&ra->mutex);
+
+    if (empty)
+    {
+      ra->eof = SPLT_TRUE;
+      break;
+    }
+
+    struct splt_mp3_read_ahead_block *block =
+      &ra->blocks[ra->taken % SPLT_MP3_READ_AHEAD_BLOCKS];
+    size_t length = block->length - ra->position;
+    if (length > size - copied)
+    {
+      length = size - copied;
+    }
+
+    memcpy(ptr + copied, block->data + ra->position, length);
+    ra->position += length;
+    copied += length;
+
+    //gives the block back to the reader
+    if (ra->position == block->length)
+    {
+      pthread_mutex_lock(&ra->mutex);
+      ra->taken++;
+      ra->position = 0;
+      pthread_cond_signal(&ra->cond);
+      pthread_mutex_unlock(&ra->mutex);
+    }
+  }
+
+  return copied;
+}
+
+#endif
+
+//reads from the input file, or from the read ahead ring if used
+static size_t splt_mp3_read_input(splt_mp3_state *mp3state, void *ptr, size_t size)
+{
+#ifndef __WIN32__
+  if (mp3state->read_ahead)
+  {
+    return splt_mp3_read_ahead_read(mp3state->read_ahead, ptr, size);
+  }
+#endif
+
+  return fread(ptr, 1, size, mp3state->file_input);
+}
+
+//like feof on the input file, or on the read ahead ring if used
+static int splt_mp3_input_eof(splt_mp3_state *mp3state)
+{
+#ifndef __WIN32__
+  if (mp3state->read_ahead)
+  {
+    return mp3state->read_ahead->eof;
+  }
+#endif
+
+  return feof(mp3state->file_input);
+}
+
 //get a frame
 //-returns a negative value if error
-static int splt_mp3_get_frame(splt_mp3_state *mp3state)
+static int splt_mp3_get_frame(splt_state *state, splt_mp3_state *mp3state)
 {
   if(mp3state->stream.buffer==NULL || 
       mp3state->stream.error==MAD_ERROR_BUFLEN)
@@ -398,7 +928,7 @@ static int splt_mp3_get_frame(splt_mp3_state *mp3state)
     size_t readSize, remaining;
     unsigned char *readStart;
 
-    if (feof(mp3state->file_input))
+    if (splt_mp3_input_eof(mp3state))
     {
       return -2;
     }
@@ -417,7 +947,7 @@ static int splt_mp3_get_frame(splt_mp3_state *mp3state)
       remaining=0;
     }
 
-    readSize=fread(readStart, 1, readSize, mp3state->file_input);
+    readSize=splt_mp3_read_input(mp3state, readStart, readSize);
     if (readSize <= 0)
     {
       return -2;
@@ -425,6 +955,7 @@ static int splt_mp3_get_frame(splt_mp3_state *mp3state)
 
     mp3state->buf_len = readSize + remaining;
     mp3state->bytes += readSize;
+    state->stats.bytes_read += readSize;
     //does not set any error
     mad_stream_buffer(&mp3state->stream, mp3state->inputBuffer, 
         readSize+remaining);
@@ -432,7 +963,13 @@ static int splt_mp3_get_frame(splt_mp3_state *mp3state)
   }
 
   //mad_frame_decode() returns -1 if error, 0 if no error
-  return mad_frame_decode(&mp3state->frame,&mp3state->stream);
+  int ret = mad_frame_decode(&mp3state->frame,&mp3state->stream);
+  if (ret == 0)
+  {
+    state->stats.frames_parsed++;
+  }
+
+  return ret;
 }
 
 //used by mp3split and mp3_scan_silence
@@ -447,7 +984,7 @@ static int splt_mp3_get_valid_frame(splt_state *state, int *error)
   int ok = 0;
   do
   {
-    int ret = splt_mp3_get_frame(mp3state);
+    int ret = splt_mp3_get_frame(state, mp3state);
     if(ret != 0)
     {
       if (ret == -2)
@@ -458,6 +995,7 @@ static int splt_mp3_get_valid_frame(splt_state *state, int *error)
       {
         //syncerrors
         state->syncerrors++;
+        state->stats.sync_errors++;
         if ((mp3state->syncdetect) && (state->syncerrors>SPLT_MAXSYNC))
         {
           splt_mp3_checksync(mp3state);
@@ -549,53 +1087,147 @@ static off_t splt_mp3_getid3v2_end_offset(FILE *in, off_t start)
   return 0;
 }
 
-//frees the splt_mp3_state structure,
-//used in the splt_t_state_free() function
-static void splt_mp3_state_free(splt_state *state)
+#ifndef NO_ID3TAG
+//reads the ID3v2 and ID3v1 tags of the input file in the mp3 state, so
+//that the original tags are taken without opening the file again;
+//the position in the file is kept
+static void splt_mp3_read_original_tag_bytes(splt_state *state,
+    splt_mp3_state *mp3state, int *error)
 {
-  splt_mp3_state *mp3state = state->codec;
+  FILE *file_input = mp3state->file_input;
 
-  if (mp3state)
+  if (file_input == stdin ||
+      splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
   {
-    if (mp3state->mp3file.xingbuffer)
-    {
-      free(mp3state->mp3file.xingbuffer);
-      mp3state->mp3file.xingbuffer = NULL;
-    }
-
-    //we free the state
-    free(mp3state);
-    state->codec = NULL;
+    return;
   }
-}
 
-/****************************/
-/* mp3 tags */
-
-//returns the genre of the song, mp3splt used this in cddb search
-static unsigned char splt_mp3_getgenre(const char *genre_string)
-{
-  if (genre_string == NULL)
+  off_t position = ftello(file_input);
+  if (position == -1)
   {
-    return 0xFF;
+    return;
   }
 
-  int i = 0;
-  for (i=0; i < SPLT_MP3_GENRENUM; i++)
+  off_t id3v2_end_offset = splt_mp3_getid3v2_end_offset(file_input, 0);
+  if (id3v2_end_offset != 0)
   {
-    if (strncmp(genre_string, splt_mp3_id3v1_categories[i],
-          strlen(genre_string)) == 0)
+    unsigned long id3v2_size = (unsigned long) id3v2_end_offset + 10;
+    mp3state->id3v2_bytes = splt_u_malloc(sizeof(unsigned char) * id3v2_size);
+    if (! mp3state->id3v2_bytes)
     {
-      return splt_mp3_id3genre[i];
+      *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      return;
     }
-  }
-
-  return 0xFF;
-}
-
-#ifndef NO_ID3TAG
 
-/* get libid3tag original tags */
+    rewind(file_input);
+
+    if (fread(mp3state->id3v2_bytes, 1, id3v2_size, file_input) != id3v2_size)
+    {
+      free(mp3state->id3v2_bytes);
+      mp3state->id3v2_bytes = NULL;
+    }
+    else
+    {
+      mp3state->id3v2_length = id3v2_size;
+    }
+  }
+
+  off_t id3v1_offset = splt_mp3_getid3v1_offset(file_input);
+  if (id3v1_offset != 0)
+  {
+    if (fseeko(file_input, id3v1_offset, SEEK_END) != -1)
+    {
+      if (fread(mp3state->id3v1_bytes, 1, 128, file_input) == 128)
+      {
+        mp3state->has_id3v1 = SPLT_TRUE;
+      }
+    }
+  }
+
+  if (fseeko(file_input, position, SEEK_SET) == -1)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
+    *error = SPLT_ERROR_SEEKING_FILE;
+    return;
+  }
+
+  mp3state->original_tags_read = SPLT_TRUE;
+}
+#endif
+
+//frees the shared tags and the bytes of the ID3v2 template
+static void splt_mp3_id3v2_template_free(struct splt_mp3_id3v2_template *template)
+{
+  free(template->artist);
+  free(template->album);
+  free(template->year);
+  free(template->comment);
+  free(template->bytes);
+  memset(template, 0x0, sizeof(struct splt_mp3_id3v2_template));
+}
+
+//frees the splt_mp3_state structure,
+//used in the splt_t_state_free() function
+static void splt_mp3_state_free(splt_state *state)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  if (mp3state)
+  {
+    if (mp3state->mp3file.xingbuffer)
+    {
+      free(mp3state->mp3file.xingbuffer);
+      mp3state->mp3file.xingbuffer = NULL;
+    }
+
+    if (mp3state->seek_index)
+    {
+      free(mp3state->seek_index);
+      mp3state->seek_index = NULL;
+    }
+
+    splt_mp3_id3v2_template_free(&mp3state->id3v2_template);
+
+    if (mp3state->id3v2_bytes)
+    {
+      free(mp3state->id3v2_bytes);
+      mp3state->id3v2_bytes = NULL;
+    }
+
+    //we free the state
+    free(mp3state);
+    state->codec = NULL;
+  }
+}
+
+/****************************/
+/* mp3 tags */
+
+//returns the genre of the song, mp3splt used this in cddb search
+static unsigned char splt_mp3_getgenre(const char *genre_string)
+{
+  if (genre_string == NULL)
+  {
+    return 0xFF;
+  }
+
+  int i = 0;
+  for (i=0; i < SPLT_MP3_GENRENUM; i++)
+  {
+    if (strncmp(genre_string, splt_mp3_id3v1_categories[i],
+          strlen(genre_string)) == 0)
+    {
+      return splt_mp3_id3genre[i];
+    }
+  }
+
+  return 0xFF;
+}
+
+#ifndef NO_ID3TAG
+
+/* get libid3tag original tags */
 
 static id3_byte_t *splt_mp3_get_id3v2_tag_bytes(FILE *file, id3_length_t *length)
 {
@@ -607,7 +1239,7 @@ static id3_byte_t *splt_mp3_get_id3v2_tag_bytes(FILE *file, id3_length_t *length
   if (id3v2_end_offset != 0)
   {
     unsigned long id3v2_size = (unsigned long) id3v2_end_offset + 10;
-    bytes = malloc(sizeof(unsigned char) * id3v2_size);
+    bytes = splt_u_malloc(sizeof(unsigned char) * id3v2_size);
 
     if (! bytes)
     {
@@ -644,7 +1276,7 @@ static id3_byte_t *splt_mp3_get_id3v1_tag_bytes(FILE *file, id3_length_t *length
   {
     if (fseeko(file, id3v1_offset, SEEK_END) !=-1)
     {
-      bytes = malloc(sizeof(unsigned char) * 128);
+      bytes = splt_u_malloc(sizeof(unsigned char) * 128);
 
       if (! bytes)
       {
@@ -733,6 +1365,30 @@ end:
   return bytes;
 }
 
+//returns the tag bytes read with the mp3 infos and sets the
+//'tags_version' to the version of the tags; the bytes belong to the
+//mp3 state
+static const id3_byte_t *splt_mp3_get_read_id3_tag_bytes(splt_mp3_state *mp3state,
+    id3_length_t *length, int *tags_version)
+{
+  *length = 0;
+
+  if (mp3state->id3v2_bytes)
+  {
+    *tags_version = mp3state->has_id3v1 ? 12 : 2;
+    *length = mp3state->id3v2_length;
+    return mp3state->id3v2_bytes;
+  }
+  else if (mp3state->has_id3v1)
+  {
+    *tags_version = 1;
+    *length = 128;
+    return mp3state->id3v1_bytes;
+  }
+
+  return NULL;
+}
+
 //puts a original field on id3 conforming to frame_type
 static int splt_mp3_put_original_libid3_frame(splt_state *state,
     const struct id3_tag *id3tag, const char *frame_type, int id_type)
@@ -847,9 +1503,22 @@ static void splt_mp3_get_original_tags(const char *filename,
   //get out the tags from the file; id3_file_open doesn't work with win32 utf16 filenames
   id3_length_t id3_tag_length = 0;
   int tags_version = 0;
-  id3_byte_t *id3_tag_bytes =
-    splt_mp3_get_id3_tag_bytes(state, filename, &id3_tag_length, tag_error,
+  id3_byte_t *id3_tag_bytes = NULL;
+  const id3_byte_t *tag_bytes = NULL;
+
+  //the tags read with the mp3 infos don't need to open the file again
+  splt_mp3_state *mp3state = state->codec;
+  if (mp3state && mp3state->original_tags_read)
+  {
+    tag_bytes = splt_mp3_get_read_id3_tag_bytes(mp3state, &id3_tag_length,
         &tags_version);
+  }
+  else
+  {
+    id3_tag_bytes = splt_mp3_get_id3_tag_bytes(state, filename, &id3_tag_length,
+        tag_error, &tags_version);
+    tag_bytes = id3_tag_bytes;
+  }
 
   /*//client feedback
   if (tags_version == 1)
@@ -863,9 +1532,9 @@ static void splt_mp3_get_original_tags(const char *filename,
 
   if (*tag_error >= 0)
   {
-    if (id3_tag_bytes)
+    if (tag_bytes)
     {
-      id3tag = id3_tag_parse(id3_tag_bytes, id3_tag_length);
+      id3tag = id3_tag_parse(tag_bytes, id3_tag_length);
 
       if (id3tag)
       {
@@ -1037,7 +1706,7 @@ static char *splt_mp3_build_libid3tag(const char *title, const char *artist,
   if (bytes_length > 0)
   {
     //allocate memory for the tags
-    bytes = malloc(sizeof(id3_byte_t) * bytes_length);
+    bytes = splt_u_malloc(sizeof(id3_byte_t) * bytes_length);
     if (!bytes)
     {
       goto error;
@@ -1066,1968 +1735,4392 @@ error:
   return NULL;
 }
 
-#else
+/****************************/
+/* mp3 ID3v2 template */
 
-//returns a id3v1 buffer as string
-//return must be freed
-//-returns NULL if error
-static char *splt_mp3_build_simple_id3v1(const char *title, const char *artist,
-    const char *album, const char *year, unsigned char genre, 
-    const char *comment, int track, int *error, unsigned long *number_of_bytes)
+//returns SPLT_TRUE if both tags are NULL or equal
+static short splt_mp3_same_tag(const char *tag1, const char *tag2)
 {
-  char *id = NULL;
-  char buffer[30] = { '\0' };
-  int j = 3,i = 0;
-
-  if ((id = malloc(sizeof(char) * 128)) != NULL)
+  if (tag1 == NULL || tag2 == NULL)
   {
-    memset(id,'\0',128);
+    return tag1 == tag2;
+  }
 
-    strncpy(id, SPLT_MP3_TAG, 4);
+  return strcmp(tag1, tag2) == 0;
+}
 
-    memset(buffer, '\0', 30);
-    if (title!=NULL) strncpy(buffer, title, 30);
-    for (i=0; i<30; i++) id[j++]=buffer[i];
+static unsigned long splt_mp3_get_syncsafe(const unsigned char *ptr)
+{
+  return ((unsigned long) (ptr[0] & 0x7f) << 21) |
+    ((unsigned long) (ptr[1] & 0x7f) << 14) |
+    ((unsigned long) (ptr[2] & 0x7f) << 7) |
+    (unsigned long) (ptr[3] & 0x7f);
+}
 
-    memset(buffer, '\0', 30);
-    if (artist!=NULL) strncpy(buffer, artist, 30);
-    for (i=0; i<30; i++) id[j++]=buffer[i];
+static void splt_mp3_put_syncsafe(unsigned char *ptr, unsigned long value)
+{
+  ptr[0] = (value >> 21) & 0x7f;
+  ptr[1] = (value >> 14) & 0x7f;
+  ptr[2] = (value >> 7) & 0x7f;
+  ptr[3] = value & 0x7f;
+}
 
-    memset(buffer, '\0', 30);
-    if (album!=NULL) strncpy(buffer, album, 30);
-    for (i=0; i<30; i++) id[j++]=buffer[i];
+//writes the utf8 string as big endian utf16 in 'utf16', which must hold
+//2 * strlen(utf8) bytes
+//-returns the number of bytes written, or -1 if the string is not valid
+//utf8; libid3tag is used for such strings
+static long splt_mp3_utf8_to_utf16be(const char *utf8, unsigned char *utf16)
+{
+  const unsigned char *ptr = (const unsigned char *) utf8;
+  long length = 0;
 
-    memset(buffer, '\0', 30);
-    if (year!=NULL) strncpy(buffer, year, 4);
-    for (i=0; i<4; i++) id[j++]=buffer[i];
+  while (*ptr)
+  {
+    unsigned long c = *ptr++;
+    unsigned long min = 0;
+    int following = 0;
 
-    memset(buffer, '\0', 30);
-    if (comment!=NULL) strncpy(buffer, comment, 30);
-    for (i=0; i<30; i++) 
+    if (c >= 0x80)
     {
-      id[j++]=buffer[i];
+      if ((c & 0xe0) == 0xc0) { c &= 0x1f; following = 1; min = 0x80; }
+      else if ((c & 0xf0) == 0xe0) { c &= 0x0f; following = 2; min = 0x800; }
+      else if ((c & 0xf8) == 0xf0) { c &= 0x07; following = 3; min = 0x10000; }
+      else { return -1; }
     }
-    //if we have a positive track
-    if (track != -INT_MAX)
+
+    for (;following > 0;following--)
     {
-      if (track != 0x00)
+      if ((*ptr & 0xc0) != 0x80)
       {
-        id[j-1] = (char) track;
+        return -1;
       }
-    }      
-    id[j] = (char) genre;
-  }
-  else
-  {
-    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    return NULL;
-  }
-
-  *number_of_bytes = 128;
-
-  return id;
-}
-#endif
+      c = (c << 6) | (*ptr++ & 0x3f);
+    }
 
-//returns a id3v2 or id3v1 buffer as array of char
-//return must be freed
-//-returns NULL if error
-static char *splt_mp3_build_id3_tags(splt_state *state,
-    const char *title, const char *artist,
-    const char *album, const char *year, unsigned char genre, 
-    const char *comment, int track, int *error,
-    unsigned long *number_of_bytes, int version)
-{
-  char *id = NULL;
+    if (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+    {
+      return -1;
+    }
 
-#ifdef NO_ID3TAG
-  if (version == 1)
-  {
-    splt_u_print_debug(state,"Setting ID3v1 tags without libid3tag", 0,NULL);
-    id = splt_mp3_build_simple_id3v1(title, artist, album, year, genre, comment, track,
-        error, number_of_bytes);
-  }
-#else
-  if (version == 1)
-  {
-    splt_u_print_debug(state,"Setting ID3v1 tags with libid3tag", 0,NULL);
-    id = splt_mp3_build_libid3tag(title, artist, album, year, genre, comment, track,
-        error, number_of_bytes, 1);
-  }
-  else
-  {
-    splt_u_print_debug(state,"Setting ID3v2 tags with libid3tag", 0,NULL);
-    id = splt_mp3_build_libid3tag(title, artist, album, year, genre, comment, track,
-        error, number_of_bytes, 2);
+    if (c >= 0x10000)
+    {
+      unsigned long high = 0xd800 | ((c - 0x10000) >> 10);
+      unsigned long low = 0xdc00 | ((c - 0x10000) & 0x3ff);
+      utf16[length++] = high >> 8;
+      utf16[length++] = high & 0xff;
+      utf16[length++] = low >> 8;
+      utf16[length++] = low & 0xff;
+    }
+    else
+    {
+      utf16[length++] = c >> 8;
+      utf16[length++] = c & 0xff;
+    }
   }
-#endif
 
-  return id;
+  return length;
 }
 
-//put the song tags
-//return a buffer containing the tags: must be freed
-static char *splt_mp3_build_tags(const char *filename, splt_state *state, int *error,
-    unsigned long *number_of_bytes, int id3_version)
+//looks in the template for the frame 'frame_id' holding the one
+//character text 'text', and takes its text prefix
+//-returns SPLT_FALSE if the frame is not found or not as expected
+static short splt_mp3_id3v2_template_frame(struct splt_mp3_id3v2_template *template,
+    const char *frame_id, char text, unsigned long *frame_offset,
+    unsigned long *frame_length)
 {
-  char *id3_data = NULL;
+  unsigned long offset = SPLT_MP3_ID3V2_HEADER;
 
-  if (splt_t_get_int_option(state,SPLT_OPT_TAGS) != SPLT_NO_TAGS)
+  while (offset + SPLT_MP3_ID3V2_HEADER <= template->length &&
+      template->bytes[offset] != '\0')
   {
-    splt_tags *tags = splt_tu_get_current_tags(state);
+    unsigned char *frame = template->bytes + offset;
+    unsigned long body_length = splt_mp3_get_syncsafe(frame + 4);
+    unsigned long length = SPLT_MP3_ID3V2_HEADER + body_length;
 
-    if (tags)
+    if (offset + length > template->length)
     {
-      char *artist_or_performer = splt_u_get_artist_or_performer_ptr(tags);
-      id3_data = splt_mp3_build_id3_tags(state,
-          tags->title, artist_or_performer, tags->album,
-          tags->year, tags->genre, tags->comment,
-          tags->track, error, number_of_bytes, id3_version);
+      return SPLT_FALSE;
     }
-  }
 
-  return id3_data;
-}
-
-//writes id3v1 tags to 'file_output'
-int splt_mp3_write_id3v1_tags(splt_state *state, FILE *file_output,
-    const char *output_fname)
-{
-  const char *filename = splt_t_get_filename_to_split(state);
-  unsigned long number_of_bytes = 0;
-  int error = SPLT_OK;
+    if (memcmp(frame, frame_id, 4) == 0)
+    {
+      unsigned char *body = frame + SPLT_MP3_ID3V2_HEADER;
+      int prefix_length = (int) body_length - 2;
 
-  char *id3_tags = splt_mp3_build_tags(filename, state, &error, &number_of_bytes, 1);
+      if (prefix_length < 1 || prefix_length > SPLT_MP3_ID3V2_PREFIX_MAX ||
+          body[prefix_length] != '\0' || body[prefix_length + 1] != text)
+      {
+        return SPLT_FALSE;
+      }
 
-  if ((error >= 0) && (id3_tags) && (number_of_bytes > 0))
-  {
-    if (file_output)
-    {
-      if (fseeko(file_output, splt_mp3_getid3v1_offset(file_output), SEEK_END)!=-1)
+      //the title and the track must be written the same way
+      if (template->text_prefix_length == 0)
       {
-        if (splt_u_fwrite(state, id3_tags, 1, number_of_bytes, file_output) < number_of_bytes)
-        {
-          splt_t_set_error_data(state, output_fname);
-          error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-        }
+        memcpy(template->text_prefix, body, prefix_length);
+        template->text_prefix_length = prefix_length;
       }
-      else
+      else if (template->text_prefix_length != prefix_length ||
+          memcmp(template->text_prefix, body, prefix_length) != 0)
       {
-        splt_t_set_strerror_msg(state);
-        splt_t_set_error_data(state, output_fname);
-        error = SPLT_ERROR_SEEKING_FILE;
+        return SPLT_FALSE;
       }
+
+      *frame_offset = offset;
+      *frame_length = length;
+
+      return SPLT_TRUE;
     }
-  }
 
-  if (id3_tags)
-  {
-    free(id3_tags);
-    id3_tags = NULL;
+    offset += length;
   }
 
-  return error;
+  return SPLT_FALSE;
 }
 
-#ifndef NO_ID3TAG
-int splt_mp3_write_id3v2_tags(splt_state *state, FILE *file_output,
-    const char *output_fname, off_t *end_offset)
+//renders the shared tags once with libid3tag, with a one character title
+//and track to find their frames
+static void splt_mp3_id3v2_template_build(struct splt_mp3_id3v2_template *template,
+    const char *artist, const char *album, const char *year,
+    unsigned char genre, const char *comment, short has_track, int *error)
 {
-  const char *filename = splt_t_get_filename_to_split(state);
-  unsigned long number_of_bytes = 0;
-  int error = SPLT_OK;
+  splt_mp3_id3v2_template_free(template);
+
+  template->genre = genre;
+  template->has_track = has_track;
+
+  template->artist = splt_su_safe_strdup(artist, error);
+  if (*error < 0) { return; }
+  template->album = splt_su_safe_strdup(album, error);
+  if (*error < 0) { return; }
+  template->year = splt_su_safe_strdup(year, error);
+  if (*error < 0) { return; }
+  template->comment = splt_su_safe_strdup(comment, error);
+  if (*error < 0) { return; }
+
+  template->bytes = (unsigned char *) splt_mp3_build_libid3tag("x", artist,
+      album, year, genre, comment, has_track ? 0 : -INT_MAX, error,
+      &template->length, 2);
+  if (*error < 0 || template->bytes == NULL)
+  {
+    return;
+  }
 
-  char *id3_tags = splt_mp3_build_tags(filename, state, &error, &number_of_bytes, 2);
+  //ID3v2.4 tag without extended header, footer nor unsynchronisation
+  if (template->length < SPLT_MP3_ID3V2_HEADER ||
+      memcmp(template->bytes, "ID3\x04", 4) != 0 ||
+      template->bytes[5] != 0)
+  {
+    return;
+  }
 
-  if ((error >= 0) && (id3_tags) && (number_of_bytes > 0))
+  if (! splt_mp3_id3v2_template_frame(template, "TIT2", 'x',
+        &template->title_offset, &template->title_length))
   {
-    if (splt_u_fwrite(state, id3_tags, 1, number_of_bytes, file_output) < number_of_bytes)
-    {
-      splt_t_set_error_data(state, output_fname);
-      error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-    }
-    else
-    {
-      if (end_offset != NULL)
-      {
-        *end_offset = number_of_bytes;
-      }
-    }
+    return;
   }
 
-  if (id3_tags)
+  if (has_track)
   {
-    free(id3_tags);
-    id3_tags = NULL;
+    if (! splt_mp3_id3v2_template_frame(template, "TRCK", '0',
+          &template->track_offset, &template->track_length))
+    {
+      return;
+    }
   }
 
-  return error;
+  template->usable = SPLT_TRUE;
 }
-#endif
 
-//returns the output tags version
-int splt_mp3_get_output_tags_version(splt_state *state)
+//writes the text frame of the template at 'frame_offset' with the new text
+//-returns the number of bytes written
+static unsigned long splt_mp3_id3v2_put_frame(struct splt_mp3_id3v2_template *template,
+    unsigned long frame_offset, unsigned char *text, long text_length,
+    unsigned char *ptr)
 {
-#ifdef NO_ID3TAG
-  splt_u_print_debug(state,"Output tags version is ID3v1 without libid3tag", 0,NULL);
-  return 1;
-#else
-  int original_tags_version = state->original_tags.tags_version;
-  int force_tags_version = splt_t_get_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION);
+  unsigned long body_length = template->text_prefix_length + text_length;
 
-  int output_tags_version = original_tags_version;
-  if (force_tags_version != 0)
+  memcpy(ptr, template->bytes + frame_offset, 4);
+  splt_mp3_put_syncsafe(ptr + 4, body_length);
+  memcpy(ptr + 8, template->bytes + frame_offset + 8, 2);
+  memcpy(ptr + SPLT_MP3_ID3V2_HEADER, template->text_prefix,
+      template->text_prefix_length);
+  memcpy(ptr + SPLT_MP3_ID3V2_HEADER + template->text_prefix_length,
+      text, text_length);
+
+  return SPLT_MP3_ID3V2_HEADER + body_length;
+}
+
+//copies the template with the title and track frames of the split file
+//-returns NULL with *error == SPLT_OK if libid3tag must render the tags
+static char *splt_mp3_id3v2_template_render(struct splt_mp3_id3v2_template *template,
+    const char *title, const char *track, int *error, unsigned long *number_of_bytes)
+{
+  unsigned char *title_utf16 = NULL;
+  unsigned char *track_utf16 = NULL;
+  unsigned char *bytes = NULL;
+
+  title_utf16 = splt_u_malloc(strlen(title) * 2 + 1);
+  track_utf16 = splt_u_malloc(strlen(track) * 2 + 1);
+  if (title_utf16 == NULL || track_utf16 == NULL)
   {
-    output_tags_version = force_tags_version;
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto end;
   }
 
-  if ((output_tags_version == 0) &&
-      (splt_t_get_int_option(state, SPLT_OPT_TAGS) == SPLT_CURRENT_TAGS))
+  long title_length = splt_mp3_utf8_to_utf16be(title, title_utf16);
+  long track_length = splt_mp3_utf8_to_utf16be(track, track_utf16);
+  if (title_length < 0 || track_length < 0)
   {
-    char *filename = splt_t_get_filename_to_split(state);
-    if (strcmp(filename, "-") != 0)
-    {
-      output_tags_version = 12;
-    }
+    goto end;
   }
 
-  splt_u_print_debug(state,"Output tags version is ID3v", output_tags_version, NULL);
+  unsigned long length = template->length - template->title_length +
+    SPLT_MP3_ID3V2_HEADER + template->text_prefix_length + title_length;
+  if (template->has_track)
+  {
+    length += SPLT_MP3_ID3V2_HEADER + template->text_prefix_length +
+      track_length - template->track_length;
+  }
 
-  return output_tags_version;
-#endif
-}
+  bytes = splt_u_malloc(length);
+  if (bytes == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto end;
+  }
 
-/****************************/
-/* mp3 infos */
+  //the title frame comes before the track frame
+  unsigned char *ptr = bytes;
+  unsigned long copied = template->title_offset;
+  memcpy(ptr, template->bytes, copied);
+  ptr += copied;
+  ptr += splt_mp3_id3v2_put_frame(template, template->title_offset,
+      title_utf16, title_length, ptr);
+  copied += template->title_length;
 
-//puts in the state informations about mp3 file
-//must be called before splt_mp3_split()
-//enables framemode if xing header found 
-//xing header is often associated with VBR (variable bit rate)
-static splt_mp3_state *splt_mp3_info(FILE *file_input, splt_state *state,
-    int framemode, int *error)
-{
-  splt_mp3_state *mp3state = state->codec;
+  if (template->has_track)
+  {
+    memcpy(ptr, template->bytes + copied, template->track_offset - copied);
+    ptr += template->track_offset - copied;
+    ptr += splt_mp3_id3v2_put_frame(template, template->track_offset,
+        track_utf16, track_length, ptr);
+    copied = template->track_offset + template->track_length;
+  }
 
-  int prev = -1;
-  long len;
+  memcpy(ptr, template->bytes + copied, template->length - copied);
 
-  if ((mp3state = malloc(sizeof(splt_mp3_state)))==NULL)
+  splt_mp3_put_syncsafe(bytes + 6, length - SPLT_MP3_ID3V2_HEADER);
+  *number_of_bytes = length;
+
+end:
+  if (title_utf16)
   {
-    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    return NULL;
+    free(title_utf16);
+    title_utf16 = NULL;
+  }
+  if (track_utf16)
+  {
+    free(track_utf16);
+    track_utf16 = NULL;
   }
-  memset(mp3state, 0x0, sizeof(splt_mp3_state));
-
-  char *filename = splt_t_get_filename_to_split(state);
 
-  //always quiet
-  mp3state->syncdetect = 0;
+  return (char *) bytes;
+}
 
-  //we initialise default values
-  mp3state->frames = 1;
-  mp3state->end = 0;
-  mp3state->first = 1;
-  mp3state->file_input = file_input;
-  mp3state->framemode = framemode;
-  mp3state->headw = 0;
-  mp3state->mp3file.xing = 0;
-  mp3state->mp3file.xing_offset = 0;
-  mp3state->mp3file.xingbuffer = NULL;
-  //ignore flength error (ex for non seekable stdin)
-  mp3state->mp3file.len = splt_u_flength(state, file_input, filename, error);
-  splt_t_set_total_time(state, 0);
-  mp3state->data_ptr = NULL;
-  mp3state->data_len = 0;
-  mp3state->buf_len = 0;
-  mp3state->bytes = 0;
+//returns the ID3v2 tags of a split file from the template of the shared
+//tags, rebuilt when they change; the first tags of a template are
+//compared to the ones of libid3tag, which renders the tags if the
+//template cannot be used
+//-returns NULL if error
+static char *splt_mp3_build_id3v2_tags(splt_state *state,
+    const char *title, const char *artist,
+    const char *album, const char *year, unsigned char genre, 
+    const char *comment, int track, int *error,
+    unsigned long *number_of_bytes)
+{
+  splt_mp3_state *mp3state = state->codec;
+  char *id = NULL;
 
-  //we initialise the mad structures
-  splt_mp3_init_stream_frame(mp3state);
-  mad_synth_init(&mp3state->synth);
+  if (mp3state == NULL || title == NULL)
+  {
+    return splt_mp3_build_libid3tag(title, artist, album, year, genre,
+        comment, track, error, number_of_bytes, 2);
+  }
 
-  mad_timer_reset(&mp3state->timer);
+  struct splt_mp3_id3v2_template *template = &mp3state->id3v2_template;
+  short has_track = track != -INT_MAX;
 
-  //we read mp3 infos and set pointers to read the mp3 data
-  do
+  if (template->bytes == NULL ||
+      ! splt_mp3_same_tag(template->artist, artist) ||
+      ! splt_mp3_same_tag(template->album, album) ||
+      ! splt_mp3_same_tag(template->year, year) ||
+      ! splt_mp3_same_tag(template->comment, comment) ||
+      template->genre != genre || template->has_track != has_track)
   {
-    int ret = splt_mp3_get_frame(mp3state);
+    splt_mp3_id3v2_template_build(template, artist, album, year, genre,
+        comment, has_track, error);
+    if (*error < 0)
+    {
+      splt_mp3_id3v2_template_free(template);
+      return NULL;
+    }
+  }
 
-    if (ret == -2)
+  if (template->usable)
+  {
+    char track_str[255] = { '\0' };
+    if (has_track)
     {
-      splt_t_set_error_data(state,filename);
-      *error = SPLT_ERROR_INVALID;
-      goto function_end;
+      snprintf(track_str,254,"%d",track);
     }
 
-    if ((prev == 0) &&
-        ((ret == 0) || (mp3state->stream.error == MAD_ERROR_BUFLEN)))
+    id = splt_mp3_id3v2_template_render(template, title, track_str,
+        error, number_of_bytes);
+    if (*error < 0)
     {
-      break;
+      return NULL;
     }
 
-    //if we have succeeded to read a frame
-    if (ret == 0)
+    if (id && template->checked)
     {
-      //we set pointer to the frame
-      mp3state->data_ptr = (unsigned char *) mp3state->stream.this_frame;
-      //we set length of frame
-      if(mp3state->stream.next_frame!=NULL)
-      {
-        mp3state->data_len = (long) (mp3state->stream.next_frame - mp3state->stream.this_frame);
-      }
+      return id;
+    }
+  }
 
-      if (mp3state->stream.anc_bitlen > 64)
-      {
-        int tag = 0;
-        struct mad_bitptr ptr = mp3state->stream.anc_ptr;
-        struct mad_bitptr start = ptr;
-        //we search for xing (variable bit rate)
-        unsigned long xing_word = mad_bit_read(&ptr, 32);
-        if ((xing_word==SPLT_MP3_XING_MAGIC) ||
-            (xing_word==SPLT_MP3_INFO_MAGIC))
-        {
-          tag = 1;
-        }
-        //Handle misplaced Xing header in mp3 files with CRC
-        else 
-        {
-          if (xing_word == ((SPLT_MP3_XING_MAGIC << 16) & 0xffffffffL) 
-              || xing_word == ((SPLT_MP3_INFO_MAGIC << 16) & 0xffffffffL))
-          {
-            ptr = start;
-            mad_bit_skip(&ptr, 16);
-            tag = 1;
-          }
-        }
+  unsigned long libid3tag_bytes = 0;
+  char *libid3tag_id = splt_mp3_build_libid3tag(title, artist, album, year,
+      genre, comment, track, error, &libid3tag_bytes, 2);
 
-        //if we have xing, put infos
-        if (tag)
-        {
-          xing_word = mad_bit_read(&ptr, 32);
-          if (xing_word & SPLT_MP3_XING_FRAMES)
-          {
-            mad_timer_t total;
-            mp3state->frames = mad_bit_read(&ptr, 32);
-            total = mp3state->frame.header.duration;
-            mad_timer_multiply(&total, mp3state->frames);
-            float total_time_milliseconds = (float) mad_timer_count(total, MAD_UNITS_MILLISECONDS);
-            total_time_milliseconds /= 10.f;
-            splt_t_set_total_time(state, (long) ceilf(total_time_milliseconds));
-          }
+  if (id)
+  {
+    if (libid3tag_id && libid3tag_bytes == *number_of_bytes &&
+        memcmp(id, libid3tag_id, libid3tag_bytes) == 0)
+    {
+      template->checked = SPLT_TRUE;
+    }
+    else
+    {
+      splt_u_print_debug(state,"The ID3v2 template differs from libid3tag",
+          0,NULL);
+      template->usable = SPLT_FALSE;
+    }
 
-          if (xing_word & SPLT_MP3_XING_BYTES)
-          {
-            if (mp3state->mp3file.len == 0)
-              mp3state->mp3file.len = mad_bit_read(&ptr, 32);
-          }
+    free(id);
+    id = NULL;
+  }
 
-          if (splt_t_get_int_option(state, SPLT_OPT_XING))
-          {
-            mp3state->mp3file.xing = mp3state->data_len;
+  *number_of_bytes = libid3tag_bytes;
 
-            if ((mp3state->mp3file.xingbuffer = 
-                  malloc(mp3state->mp3file.xing))==NULL)
-            {
-              *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-              goto function_end;
-            }
+  return libid3tag_id;
+}
 
-            memcpy(mp3state->mp3file.xingbuffer, mp3state->data_ptr,
-                mp3state->mp3file.xing);
-            mp3state->mp3file.xing_offset = splt_mp3_xing_info_off(mp3state);
-          }
+#else
 
-          //set framemode true (because VBR)
-          splt_t_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
-          mp3state->framemode = 1;
-          //print message to client because frame mode enabled
-          if (!splt_t_messages_locked(state))
-          {
-            if (!splt_t_get_iopt(state, SPLT_INTERNAL_FRAME_MODE_ENABLED))
-            {
-              int split_mode =
-                splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+//returns a id3v1 buffer as string
+//return must be freed
+//-returns NULL if error
+static char *splt_mp3_build_simple_id3v1(const char *title, const char *artist,
+    const char *album, const char *year, unsigned char genre, 
+    const char *comment, int track, int *error, unsigned long *number_of_bytes)
+{
+  char *id = NULL;
+  char buffer[30] = { '\0' };
+  int j = 3,i = 0;
 
-              if (split_mode != SPLT_OPTION_WRAP_MODE &&
-                  split_mode != SPLT_OPTION_ERROR_MODE)
-              {
-                splt_t_put_info_message_to_client(state,
-                    _(" info: found Xing or Info header. Switching to frame mode... \n"));
-                splt_t_set_iopt(state, SPLT_INTERNAL_FRAME_MODE_ENABLED, SPLT_TRUE);
-              }
-            }
-          }
-          continue;
-        }
-      }
-    }
+  if ((id = splt_u_malloc(sizeof(char) * 128)) != NULL)
+  {
+    memset(id,'\0',128);
 
-    prev = ret;
-  } while (1);
+    strncpy(id, SPLT_MP3_TAG, 4);
 
-  len = (long) (mp3state->buf_len - (mp3state->data_ptr - mp3state->inputBuffer));
+    memset(buffer, '\0', 30);
+    if (title!=NULL) strncpy(buffer, title, 30);
+    for (i=0; i<30; i++) id[j++]=buffer[i];
 
-  if (len < 0)
-  {
-    splt_t_set_error_data(state,filename);
-    *error = SPLT_ERROR_INVALID;
-    goto function_end;
-  }
-
-  //we put useful infos in the state
-  mp3state->mp3file.firsth = (off_t) (mp3state->bytes - len);
-  mp3state->bytes = mp3state->mp3file.firsth;
-  mp3state->headw = 
-    (unsigned long) ((mp3state->data_ptr[0] << 24) | 
-        (mp3state->data_ptr[1] << 16) |
-        (mp3state->data_ptr[2] << 8) | (mp3state->data_ptr[3]));
-  mp3state->mp3file.mpgid = (int) ((mp3state->headw >> 19)&1);
-  mp3state->mp3file.layer = mp3state->frame.header.layer;
-
-  mp3state->mp3file.freq = mp3state->frame.header.samplerate;
-  mp3state->mp3file.bitrate = mp3state->frame.header.bitrate/SPLT_MP3_BYTE;
-
-  mp3state->mp3file.firsthead = 
-    splt_mp3_makehead(mp3state->headw, mp3state->mp3file, mp3state->mp3file.firsthead, mp3state->mp3file.firsth);
+    memset(buffer, '\0', 30);
+    if (artist!=NULL) strncpy(buffer, artist, 30);
+    for (i=0; i<30; i++) id[j++]=buffer[i];
 
-  mp3state->mp3file.fps = (float) (mp3state->mp3file.freq*(2-mp3state->mp3file.mpgid));
-  mp3state->mp3file.fps /= SPLT_MP3_PCM;
+    memset(buffer, '\0', 30);
+    if (album!=NULL) strncpy(buffer, album, 30);
+    for (i=0; i<30; i++) id[j++]=buffer[i];
 
-  //we put the channels stuff (mono, stereo)
-  switch(mp3state->frame.header.mode)
-  {
-    case MAD_MODE_SINGLE_CHANNEL:
-      mp3state->mp3file.channels = 0;
-      break;
-    case MAD_MODE_DUAL_CHANNEL:
-      mp3state->mp3file.channels = 1;
-      break;
-    case MAD_MODE_JOINT_STEREO:
-      mp3state->mp3file.channels = 2;
-      break;
-    case MAD_MODE_STEREO:
-      mp3state->mp3file.channels = 3;
-      break;
-    default:
-      mp3state->mp3file.channels = 4;
-      break;
-  }
+    memset(buffer, '\0', 30);
+    if (year!=NULL) strncpy(buffer, year, 4);
+    for (i=0; i<4; i++) id[j++]=buffer[i];
 
-  //we put the total time for constant bit rate
-  //if it was not set for the variable bit rate
-  if (splt_t_get_total_time(state) == 0)
-  {
-    if (mp3state->mp3file.len > 0)
+    memset(buffer, '\0', 30);
+    if (comment!=NULL) strncpy(buffer, comment, 30);
+    for (i=0; i<30; i++) 
     {
-      long temp = (long)
-        (((double)(mp3state->mp3file.len - mp3state->mp3file.firsth)
-          / (double)mp3state->mp3file.bitrate) * 100.0);
-      splt_t_set_total_time(state, temp);
+      id[j++]=buffer[i];
     }
+    //if we have a positive track
+    if (track != -INT_MAX)
+    {
+      if (track != 0x00)
+      {
+        id[j-1] = (char) track;
+      }
+    }      
+    id[j] = (char) genre;
+  }
+  else
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
   }
 
-function_end:
-  //we free memory allocated by mad_frame_decode(..)
-  //TODO: memory leak
-  //splt_mp3_finish_stream_frame(mp3state);
-  mad_synth_finish(&mp3state->synth);
+  *number_of_bytes = 128;
 
-  return mp3state;
+  return id;
 }
+#endif
 
-static void splt_mp3_end(splt_state *state, int *error)
+//returns a id3v2 or id3v1 buffer as array of char
+//return must be freed
+//-returns NULL if error
+static char *splt_mp3_build_id3_tags(splt_state *state,
+    const char *title, const char *artist,
+    const char *album, const char *year, unsigned char genre, 
+    const char *comment, int track, int *error,
+    unsigned long *number_of_bytes, int version)
 {
-  splt_mp3_state *mp3state = state->codec;
-  if (mp3state)
+  char *id = NULL;
+
+#ifdef NO_ID3TAG
+  if (version == 1)
   {
-    splt_mp3_finish_stream_frame(mp3state);
-    if (mp3state->file_input)
-    {
-      if (mp3state->file_input != stdin)
-      {
-        if (fclose(mp3state->file_input) != 0)
-        {
-          splt_t_set_strerror_msg(state);
-          splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
-          *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
-        }
-      }
-      mp3state->file_input = NULL;
-    }
-    //we free the mp3 state 
-    splt_mp3_state_free(state);
+    splt_u_print_debug(state,"Setting ID3v1 tags without libid3tag", 0,NULL);
+    id = splt_mp3_build_simple_id3v1(title, artist, album, year, genre, comment, track,
+        error, number_of_bytes);
   }
-  state->codec = NULL;
+#else
+  if (version == 1)
+  {
+    splt_u_print_debug(state,"Setting ID3v1 tags with libid3tag", 0,NULL);
+    id = splt_mp3_build_libid3tag(title, artist, album, year, genre, comment, track,
+        error, number_of_bytes, 1);
+  }
+  else
+  {
+    splt_u_print_debug(state,"Setting ID3v2 tags with libid3tag", 0,NULL);
+    id = splt_mp3_build_id3v2_tags(state, title, artist, album, year, genre,
+        comment, track, error, number_of_bytes);
+  }
+#endif
+
+  return id;
 }
 
-//gets the mp3 info and puts it in the state
-static void splt_mp3_get_info(splt_state *state, FILE *file_input, int *error)
+//put the song tags
+//return a buffer containing the tags: must be freed
+static char *splt_mp3_build_tags(const char *filename, splt_state *state, int *error,
+    unsigned long *number_of_bytes, int id3_version)
 {
-  //checks if valid mp3 file
-  //before last argument, if framemode or not
-  //last argument if we put messages to clients or not
-  state->codec = splt_mp3_info(file_input, state,
-        splt_t_get_int_option(state,SPLT_OPT_FRAME_MODE), error);
-  //if error
-  if ((*error < 0) || (state->codec == NULL))
+  char *id3_data = NULL;
+
+  if (splt_t_get_int_option(state,SPLT_OPT_TAGS) != SPLT_NO_TAGS)
   {
-    if (state->codec != NULL)
+    splt_tags *tags = splt_tu_get_current_tags(state);
+
+    if (tags)
     {
-      splt_mp3_end(state, error);
+      char *artist_or_performer = splt_u_get_artist_or_performer_ptr(tags);
+      id3_data = splt_mp3_build_id3_tags(state,
+          tags->title, artist_or_performer, tags->album,
+          tags->year, tags->genre, tags->comment,
+          tags->track, error, number_of_bytes, id3_version);
     }
-    return;
   }
-  //print informations about the current file to the client
-  else
+
+  return id3_data;
+}
+
+//writes id3v1 tags to 'file_output'
+int splt_mp3_write_id3v1_tags(splt_state *state, FILE *file_output,
+    const char *output_fname)
+{
+  const char *filename = splt_t_get_filename_to_split(state);
+  unsigned long number_of_bytes = 0;
+  int error = SPLT_OK;
+
+  int phase = splt_st_enter_phase(state, SPLT_PHASE_TAGS);
+
+  char *id3_tags = splt_mp3_build_tags(filename, state, &error, &number_of_bytes, 1);
+
+  if ((error >= 0) && (id3_tags) && (number_of_bytes > 0))
   {
-    if ((! splt_t_messages_locked(state)) &&
-        (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) != SPLT_OPTION_WRAP_MODE) &&
-        (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) != SPLT_OPTION_ERROR_MODE))
+    if (file_output)
     {
-      splt_mp3_state *mp3state = state->codec;
-      struct splt_mp3 *mfile = &mp3state->mp3file;
-      //codec infos
-      char mpeg_infos[2048] = { '\0' };
-      snprintf(mpeg_infos,2048, _(" info: MPEG %d Layer %d - %d Hz - %s"),
-          (2-mfile->mpgid), mfile->layer, mfile->freq, splt_mp3_chan[mfile->channels]);
-      //frame mode or bitrate
-      char frame_mode_infos[256] = { '\0' };
-      if (mp3state->framemode)
+      //the data written behind the split must be written before seeking
+      if (splt_wb_flush(state, file_output) != 0)
       {
-        if (splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
-        {
-          snprintf(frame_mode_infos,256,_(" - FRAME MODE NS"));
-        }
-        else
-        {
-          snprintf(frame_mode_infos,256,_(" - FRAME MODE"));
-        }
+        splt_t_set_strerror_msg(state);
+        splt_t_set_error_data(state, output_fname);
+        error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
       }
-      else if (splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
+      else if (fseeko(file_output, splt_mp3_getid3v1_offset(file_output), SEEK_END)!=-1)
       {
-        snprintf(frame_mode_infos,256,_(" - NS - %d Kb/s"),
-            mfile->bitrate * SPLT_MP3_BYTE / 1000);
+        if (splt_u_fwrite(state, id3_tags, 1, number_of_bytes, file_output) < number_of_bytes)
+        {
+          splt_t_set_error_data(state, output_fname);
+          error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+        }
       }
       else
       {
-        snprintf(frame_mode_infos,256,_(" - %d Kb/s"),
-            mfile->bitrate * SPLT_MP3_BYTE / 1000);
+        splt_t_set_strerror_msg(state);
+        splt_t_set_error_data(state, output_fname);
+        error = SPLT_ERROR_SEEKING_FILE;
       }
-      //total time
-      char total_time[256] = { '\0' };
-      int total_seconds = (int) (splt_t_get_total_time(state) / 100);
-      int minutes = total_seconds / 60;
-      int seconds = total_seconds % 60;
-      snprintf(total_time,256,_(" - Total time: %dm.%02ds"), minutes, seconds%60);
-      //put all the infos together
-      char all_infos[3072] = { '\0' };
-      snprintf(all_infos,3071,"%s%s%s\n",mpeg_infos,frame_mode_infos,total_time);
-      splt_t_put_info_message_to_client(state, all_infos);
     }
   }
-}
 
-/****************************/
-/* mp3 scan for silence */
-
-//used by mp3_scan_silence, and compare with threshold, returns 0 if
-//silence spot > threshold, 1 otherwise
-//-computes one frame
-static int splt_mp3_silence(splt_mp3_state *mp3state, int channels, mad_fixed_t threshold)
-{
-  int i, j;
-  mad_fixed_t sample;
-  int silence = 1;
-
-  for (j=0; j<channels; j++)
+  if (id3_tags)
   {
-    for(i=0; i<mp3state->synth.pcm.length; i++)
-    {
-      //get silence spot ?
-      sample = mad_f_abs(mp3state->synth.pcm.samples[j][i]);
-      mp3state->temp_level = mp3state->temp_level * 0.999 + sample * 0.001;
-
-      if (sample > threshold)
-      {
-        silence = 0;
-      }
-    }
+    free(id3_tags);
+    id3_tags = NULL;
   }
 
-  return silence;
+  splt_st_leave_phase(state, phase);
+
+  return error;
 }
 
-//scan for silence
-//-returns the number of silence points found
-//and -1 if error; the error is set in the '*error' parameter
-static int splt_mp3_scan_silence(splt_state *state, off_t begin, 
-    unsigned long length, float threshold, 
-    float min, short output, int *error)
+#ifndef NO_ID3TAG
+int splt_mp3_write_id3v2_tags(splt_state *state, FILE *file_output,
+    const char *output_fname, off_t *end_offset)
 {
-  int len = 0, found = 0, shot;
-  short first, flush = 0, stop = 0;
-  unsigned long silence_begin = 0, silence_end = 0, time;
-  //unsigned long count = 0;
-  off_t pos;
-  mad_fixed_t th;
-
-  splt_mp3_state *mp3state = state->codec;
-
-  splt_t_put_progress_text(state,SPLT_PROGRESS_SCAN_SILENCE);
-
-  pos = begin;
-  th = mad_f_tofixed(splt_u_convertfromdB(threshold));
-
-  //we seek to the begin
-  if (fseeko(mp3state->file_input, begin, SEEK_SET)==-1)
-  {
-    splt_t_set_strerror_msg(state);
-    splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
-    *error = SPLT_ERROR_SEEKING_FILE;
-    return -1;
-  }
-
-  first = output;
-  shot = SPLT_DEFAULTSHOT;
-
-  //initialise mad stuff
-  splt_mp3_init_stream_frame(mp3state);
-  mad_synth_init(&mp3state->synth);
+  const char *filename = splt_t_get_filename_to_split(state);
+  unsigned long number_of_bytes = 0;
+  int error = SPLT_OK;
 
-  mad_timer_reset(&mp3state->timer);
+  int phase = splt_st_enter_phase(state, SPLT_PHASE_TAGS);
 
-  mp3state->temp_level = 0.0;
+  char *id3_tags = splt_mp3_build_tags(filename, state, &error, &number_of_bytes, 2);
 
-  //we do the effective scan
-  do
+  if ((error >= 0) && (id3_tags) && (number_of_bytes > 0))
   {
-    int mad_err = SPLT_OK;
-    switch (splt_mp3_get_valid_frame(state, &mad_err))
+    if (splt_u_fwrite(state, id3_tags, 1, number_of_bytes, file_output) < number_of_bytes)
     {
-      case 1:
-        //1 we have a valid frame
-        //we get mad infos and put them in the mp3state
-        mad_timer_add(&mp3state->timer, mp3state->frame.header.duration);
-        mad_synth_frame(&mp3state->synth,&mp3state->frame);
-        time = (unsigned long) mad_timer_count(mp3state->timer, MAD_UNITS_CENTISECONDS);
-
-        if (length > 0)
-        {
-          if (time >= length)
-          {
-            flush = 1;
-            stop = 1;
-          }
-        }
-
-        if ((!flush) && (splt_mp3_silence(mp3state, MAD_NCHANNELS(&mp3state->frame.header), th)))
-        {
-          if (len == 0) silence_begin = time;
-          if (first == 0) 
-          {
-            len++;
-          }
-          if (shot < SPLT_DEFAULTSHOT)
-            shot+=2;
-          silence_end = time;
-        }
-        else
-        {
-          if (len > SPLT_DEFAULTSILLEN)
-          {
-            if ((flush) || (shot <= 0))
-            {
-              double begin_position, end_position;
-              begin_position = (double) (silence_begin / 100.f);
-              end_position = (double) (silence_end / 100.f);
-              len = (int) (silence_end - silence_begin);
-
-              if ((end_position - begin_position - min) >= 0.f)
-              {
-                if (splt_t_ssplit_new(&state->silence_list, begin_position, end_position,
-                      len, error) == -1)
-                {
-                  stop = 1;
-                  found = -1;
-                  break;
-                }
-                found++;
-              }
-
-              len = 0;
-              shot = SPLT_DEFAULTSHOT;
-            }
-          }
-          else 
-          {
-            len = 0;
-          }
-
-          if ((first) && (shot <= 0))
-          {
-            first = 0;
-          }
-
-          if (shot > 0) 
-          {
-            shot--;
-          }
-        }
-
-        if (mp3state->mp3file.len > 0)
-        {
-          pos = ftello(mp3state->file_input);
-
-          //if (count++ % 10 == 0)
-          {
-            float level = splt_u_convert2dB(mad_f_todouble(mp3state->temp_level));
-            if (state->split.get_silence_level)
-            {
-              state->split.get_silence_level(time, level, state->split.silence_level_client_data);
-            }
-            state->split.p_bar->silence_db_level = level;
-            state->split.p_bar->silence_found_tracks = found;
-          }
-
-          //if we don't have silence split,
-          //put the 1/4 of progress
-          if (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) != 
-              SPLT_OPTION_SILENCE_MODE)
-          {
-            splt_t_update_progress(state,(double)(time),
-                (double)(length), 4,1/(float)4,
-                SPLT_DEFAULT_PROGRESS_RATE);
-          }
-          else
-          {
-            //if we have cancelled the split
-            if (splt_t_split_is_canceled(state))
-            {
-              stop = 1;
-            }
-            splt_t_update_progress(state,(double)pos,
-                (double)(mp3state->mp3file.len),
-                1,0,SPLT_DEFAULT_PROGRESS_RATE);
-          }
-        }
-        break;
-      case 0:
-        //0 we do nothing
-        break;
-      case -1:
-        // -1 means eof
-        stop = 1;
-        break;
-      case -3:
-        //error from libmad
-        stop = 1;
-        *error = mad_err;
-        found = -1;
-        break;
-      default:
-        break;
+      splt_t_set_error_data(state, output_fname);
+      error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    }
+    else
+    {
+      if (end_offset != NULL)
+      {
+        *end_offset = number_of_bytes;
+      }
     }
-  } while (!stop && (found < SPLT_MAXSILENCE));
+  }
 
-  //only if we have silence mode, we set progress to 100%
-  if (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) == 
-      SPLT_OPTION_SILENCE_MODE)
+  if (id3_tags)
   {
-    splt_t_update_progress(state,1.0,1.0,1,1,1);
+    free(id3_tags);
+    id3_tags = NULL;
   }
 
-  //we finish with mad_*
-  splt_mp3_finish_stream_frame(mp3state);
-  mad_synth_finish(&mp3state->synth);
+  splt_st_leave_phase(state, phase);
 
-  return found;
+  return error;
 }
+#endif
 
-/****************************/
-/* mp3 split */
-
-static off_t splt_mp3_write_data_ptr(splt_state *state, const char *filename,
-    const char *output_fname, FILE *file_output, int *error)
+//returns the output tags version
+int splt_mp3_get_output_tags_version(splt_state *state)
 {
-  splt_mp3_state *mp3state = state->codec;
-
-  long len = (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
+#ifdef NO_ID3TAG
+  splt_u_print_debug(state,"Output tags version is ID3v1 without libid3tag", 0,NULL);
+  return 1;
+#else
+  int original_tags_version = state->original_tags.tags_version;
+  int force_tags_version = splt_t_get_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION);
 
-  if (len < 0)
+  int output_tags_version = original_tags_version;
+  if (force_tags_version != 0)
   {
-    splt_t_set_error_data(state, filename);
-    *error = SPLT_ERROR_WHILE_READING_FILE;
-    return len;
+    output_tags_version = force_tags_version;
   }
 
-  if (splt_u_fwrite(state, mp3state->data_ptr, 1, len, file_output) < len)
+  if ((output_tags_version == 0) &&
+      (splt_t_get_int_option(state, SPLT_OPT_TAGS) == SPLT_CURRENT_TAGS))
   {
-    splt_t_set_error_data(state,output_fname);
-    *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-    return len;
+    char *filename = splt_t_get_filename_to_split(state);
+    if (strcmp(filename, "-") != 0)
+    {
+      output_tags_version = 12;
+    }
   }
 
-  mp3state->data_len = 0;
+  splt_u_print_debug(state,"Output tags version is ID3v", output_tags_version, NULL);
 
-  return len;
+  return output_tags_version;
+#endif
 }
 
-
-//used for the mp3 sync errors, dewrap and mp3 seekable split(for header)
-//returns 0 if no errors, SPLT_ defined errors if ones
-//It justs copies the data of the input file from a begin offset
-//to an end offset, and, eventually, a Xing frame (for VBR)
-//at the beginning and a ID3v1 at the end, to an outputfile.
-static int splt_mp3_simple_split(splt_state *state, const char *output_fname,
-    off_t begin, off_t end, int do_write_tags, short write_first_frame)
+//rewrites the tags of the split file 'output_fname' with the current
+//tags, in place: the new ID3v2 tag is padded to the size of the ID3v2
+//tag of the file and the ID3v1 tag is overwritten, appended or removed
+//returns SPLT_TRUE if the tags have been rewritten
+static int splt_mp3_rewrite_tags(splt_state *state, const char *output_fname,
+    int *error)
 {
-  splt_u_print_debug(state,"We do mp3 simple split on output...",0,output_fname);
-  splt_u_print_debug(state,"Mp3 simple split offset begin is",begin,NULL);
-  splt_u_print_debug(state,"Mp3 simple split offset end is",end,NULL);
-
-  splt_mp3_state *mp3state = state->codec;
-
-  int error = SPLT_OK_SPLIT;
-
-  FILE *file_output = NULL;
-  off_t position = 0;
-  unsigned char buffer[SPLT_MP3_READBSIZE] = { '\0' };
-  long readed = 0;
-  //for the progress
-  off_t temp_end = 0;
-  //the start point of the split
-  long start = begin;
-  int split_mode = splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
-
-  splt_t_put_progress_text(state, SPLT_PROGRESS_CREATE);
-
-  char *filename = splt_t_get_filename_to_split(state);
+  const char *filename = splt_t_get_filename_to_split(state);
+  int output_tags_version = splt_mp3_get_output_tags_version(state);
+  int rewritten = SPLT_FALSE;
 
-  position = ftello(mp3state->file_input); // Save current position
+  char *id3v2 = NULL, *id3v1 = NULL;
+  unsigned long id3v2_len = 0, id3v1_len = 0;
+  FILE *file = NULL;
 
-  if (fseeko(mp3state->file_input, begin, SEEK_SET)==-1)
+#ifndef NO_ID3TAG
+  if (output_tags_version == 2 || output_tags_version == 12)
   {
-    return SPLT_ERROR_BEGIN_OUT_OF_FILE;
+    id3v2 = splt_mp3_build_tags(filename, state, error, &id3v2_len, 2);
+    if (*error < 0) { goto function_end; }
+  }
+#endif
+  if (output_tags_version == 1 || output_tags_version == 12)
+  {
+    id3v1 = splt_mp3_build_tags(filename, state, error, &id3v1_len, 1);
+    if (*error < 0) { goto function_end; }
   }
 
-  //get the file size
-  off_t st_size;
-  char *fname_to_split = splt_t_get_filename_to_split(state);
-  if(splt_u_stat(fname_to_split, NULL, &st_size) == 0)
+  if ((file = splt_u_fopen(output_fname, "rb+")) == NULL)
   {
-    mp3state->end2 = st_size;
+    goto function_end;
   }
-  else
+
+  off_t old_id3v2_len = splt_mp3_getid3v2_end_offset(file, 0);
+  if (old_id3v2_len > 0)
   {
-    splt_t_set_strerror_msg(state);
-    splt_t_set_error_data(state,fname_to_split);
-    return SPLT_ERROR_CANNOT_OPEN_FILE;
+    //the padding of a ID3v2 tag cannot be followed by a footer
+    if ((fseeko(file, (off_t) 5, SEEK_SET) == -1) || (fgetc(file) & 0x10))
+    {
+      goto function_end;
+    }
+    old_id3v2_len += SPLT_MP3_ID3V2_HEADER;
   }
 
-  if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  //the audio data is not moved
+  if ((id3v2_len > old_id3v2_len) || ((id3v2_len == 0) && (old_id3v2_len > 0)))
   {
-    file_output = splt_mp3_open_file_write(state, output_fname, &error);
-    if (error < 0) { return error; }
+    splt_u_print_debug(state,"The new ID3v2 tag does not fit in",0,output_fname);
+    goto function_end;
   }
 
-  int output_tags_version = splt_mp3_get_output_tags_version(state);
+  off_t id3v1_offset = 0;
+  if (fseeko(file, (off_t) 0, SEEK_END) == -1 ||
+      (id3v1_offset = ftello(file)) == -1)
+  {
+    goto function_end;
+  }
+  if ((id3v1_offset - 128 >= old_id3v2_len) &&
+      (splt_mp3_getid3v1_offset(file) != 0))
+  {
+    id3v1_offset -= 128;
+  }
 
 #ifndef NO_ID3TAG
-  //write id3 tags version 2 at the start of the file, if necessary
-  if (do_write_tags && (output_tags_version == 2 || output_tags_version == 12))
+  if (id3v2_len > 0)
   {
-    int err = SPLT_OK;
-    if ((err = splt_mp3_write_id3v2_tags(state, file_output,
-            output_fname, NULL)) < 0)
+    if (((unsigned char *) id3v2)[5] & 0x10)
+    {
+      goto function_end;
+    }
+    splt_mp3_put_syncsafe((unsigned char *) id3v2 + 6,
+        old_id3v2_len - SPLT_MP3_ID3V2_HEADER);
+
+    if ((fseeko(file, (off_t) 0, SEEK_SET) == -1) ||
+        (fwrite(id3v2, 1, id3v2_len, file) < id3v2_len))
     {
-      error = err;
       goto function_end;
     }
+
+    off_t padding = 0;
+    for (padding = id3v2_len;padding < old_id3v2_len;padding++)
+    {
+      if (fputc(0, file) == EOF)
+      {
+        goto function_end;
+      }
+    }
   }
 #endif
 
-  if (mp3state->mp3file.xing != 0)
+  if (id3v1_len > 0)
   {
-    if (splt_t_get_int_option(state, SPLT_OPT_XING))
+    if ((fseeko(file, id3v1_offset, SEEK_SET) == -1) ||
+        (fwrite(id3v1, 1, id3v1_len, file) < id3v1_len))
     {
-      //error mode split must only contain original file data
-      if (state->options.split_mode != SPLT_OPTION_ERROR_MODE)
-      {
-        if (splt_u_fwrite(state, mp3state->mp3file.xingbuffer, 1, 
-              mp3state->mp3file.xing, file_output) < mp3state->mp3file.xing)
-        {
-          splt_t_set_error_data(state, output_fname);
-          error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-          goto function_end;
-        }
-      }
+      goto function_end;
     }
   }
-
-  if (write_first_frame)
+  else if ((fflush(file) == EOF) ||
+      (ftruncate(fileno(file), id3v1_offset) == -1))
   {
-    splt_mp3_write_data_ptr(state, filename, output_fname, file_output, &error);
-    if (error < 0) { goto function_end; }
+    goto function_end;
   }
 
-  while (!feof(mp3state->file_input))
-  {
-    readed = SPLT_MP3_READBSIZE;
-    if (end != -1)
-    {
-      if (begin >= end) 
-      {
-        break;
-      }
-      if ((end - begin) < SPLT_MP3_READBSIZE)
-      {
-        readed = end - begin;
-      }
-    }
-
-    if ((readed = fread(buffer, 1, readed, mp3state->file_input))==-1)
-    {
-      break;
-    }
-
-    if (splt_u_fwrite(state, buffer, 1, readed, file_output) < readed)
-    {
-      splt_t_set_error_data(state,output_fname);
-      error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-      goto function_end;
-    }
-    begin += readed;
-
-    //we update the progress bar
-    if ((split_mode == SPLT_OPTION_WRAP_MODE) ||
-        (split_mode == SPLT_OPTION_ERROR_MODE) ||
-        ((split_mode == SPLT_OPTION_NORMAL_MODE)
-         && (!splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST)) 
-         && (!splt_t_get_int_option(state, SPLT_OPT_FRAME_MODE))))
-    {
-      temp_end = end;
-      //for the last split
-      if (end == -1)
-      {
-        temp_end = mp3state->end2;
-      }
-
-      splt_t_update_progress(state,(double)(begin-start),
-          (double)(temp_end-start),1,0,
-          SPLT_DEFAULT_PROGRESS_RATE);
-    }
-    else
-    {
-      //if auto adjust, we have 50%
-      if (splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST))
-      {
-        splt_t_update_progress(state,(double)(begin-start),
-            (double)(end-start),
-            2,0.5, SPLT_DEFAULT_PROGRESS_RATE);
-      }
-      else
-      {
-        if (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE)
-            == SPLT_OPTION_TIME_MODE)
-        {
-          temp_end = end;
-          //for the last split
-          if (end == -1)
-          {
-            temp_end = mp3state->end2;
-          }
-
-          //if framemode
-          if (splt_t_get_int_option(state, SPLT_OPT_FRAME_MODE))
-          {
-            splt_t_update_progress(state,(double)(begin-start),
-                (double)(temp_end-start),
-                2,0.5, SPLT_DEFAULT_PROGRESS_RATE);
-          }
-          else
-          {
-            splt_t_update_progress(state,(double)(begin-start),
-                (double)(temp_end-start),
-                1,0, SPLT_DEFAULT_PROGRESS_RATE);
-          }
-        }
-        else
-        {
-          splt_t_update_progress(state,(double)(begin-start),
-              (double)(end-start),
-              2,0.5, SPLT_DEFAULT_PROGRESS_RATE);
-        }
-      }
-    }
-  }
+  rewritten = SPLT_TRUE;
 
-  //write id3 tags version 1 at the end of the file, if necessary
-  if (do_write_tags && (output_tags_version == 1 || output_tags_version == 12))
+function_end:
+  if (file)
   {
-    int err = SPLT_OK;
-    if ((err = splt_mp3_write_id3v1_tags(state, file_output, output_fname)) < 0)
+    if (splt_u_fclose_output(state, file) != 0)
     {
-      error = err;
-      goto function_end;
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, output_fname);
+      *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+      rewritten = SPLT_FALSE;
     }
+    file = NULL;
   }
-
-  if (fseeko(mp3state->file_input, position, SEEK_SET)==-1)
+  if (id3v2)
   {
-    splt_t_set_strerror_msg(state);
-    splt_t_set_error_data(state, filename);
-    goto function_end;
+    free(id3v2);
+    id3v2 = NULL;
   }
-
-function_end:
-  if (file_output)
+  if (id3v1)
   {
-    if (file_output != stdout)
-    {
-      if (fclose(file_output) != 0)
-      {
-        splt_t_set_strerror_msg(state);
-        splt_t_set_error_data(state, filename);
-        return SPLT_ERROR_CANNOT_CLOSE_FILE;
-      }
-    }
-    file_output = NULL;
+    free(id3v1);
+    id3v1 = NULL;
   }
 
-  return error;
+  return rewritten;
 }
 
-//the main mp3 split function
-//filename is our filename
-//state is our state
-//fbegin_sec is the begin splitpoint
-//fend_sec is the end splitpoint
-//adjustoption is if we adjust with silence detection or not
-//seekable is if we split in seekable mode or not
-//threshold - see manual
-//must be called after splt_mp3_info()
-//returns possible error in '*error'
-static double splt_mp3_split(const char *output_fname, splt_state *state,
-    double fbegin_sec, double fend_sec, int *error, int save_end_point)
-{
-  splt_u_print_debug(state,"Mp3 split...",0,NULL);
-  splt_u_print_debug(state,"Output filename is",0,output_fname);
-  splt_u_print_debug(state,"Begin position",fbegin_sec,NULL);
-  splt_u_print_debug(state,"End position",fend_sec,NULL);
+/****************************/
+/* mp3 infos */
 
+//puts in the state informations about mp3 file
+//must be called before splt_mp3_split()
+//enables framemode if xing header found 
+//xing header is often associated with VBR (variable bit rate)
+static splt_mp3_state *splt_mp3_info(FILE *file_input, splt_state *state,
+    int framemode, int *error)
+{
   splt_mp3_state *mp3state = state->codec;
 
-  int adjustoption = splt_t_get_int_option(state, SPLT_OPT_PARAM_GAP);
-  short seekable = ! splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE);
-  float threshold = splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD);
-
-  short fend_sec_is_not_eof =
-    !splt_u_fend_sec_is_bigger_than_total_time(state, fend_sec);
+  int prev = -1;
+  long len;
 
-  short eof=0, check_bitrate=0;
+  if ((mp3state = splt_u_malloc(sizeof(splt_mp3_state)))==NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
+  }
+  memset(mp3state, 0x0, sizeof(splt_mp3_state));
 
   char *filename = splt_t_get_filename_to_split(state);
 
-  FILE *file_output = NULL;
-  short writing = 0, finished=0;
-  unsigned long fbegin=0;
-  off_t wrote = 0;
-  long len = 0;
-  //for the progress
-  unsigned long stopped_frames = 0;
-  int progress_adjust_val = 2;
+  //always quiet
+  mp3state->syncdetect = 0;
 
-  if (adjustoption) 
+  //we initialise default values
+  mp3state->frames = 1;
+  mp3state->end = 0;
+  mp3state->first = 1;
+  mp3state->file_input = file_input;
+  mp3state->framemode = framemode;
+  mp3state->headw = 0;
+  mp3state->mp3file.xing = 0;
+  mp3state->mp3file.xing_offset = 0;
+  mp3state->mp3file.xingbuffer = NULL;
+  //ignore flength error (ex for non seekable stdin)
+  mp3state->mp3file.len = splt_u_flength(state, file_input, filename, error);
+  splt_t_set_total_time(state, 0);
+
+#ifndef __WIN32__
+  //a thread reads the non seekable input while we parse and write it
+  if (splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE) &&
+      splt_t_get_int_option(state, SPLT_OPT_READ_AHEAD))
   {
-    progress_adjust_val = 4;
+    int read_ahead_error = SPLT_OK;
+    mp3state->read_ahead = splt_mp3_read_ahead_start(file_input, &read_ahead_error);
+    if (read_ahead_error < 0)
+    {
+      *error = read_ahead_error;
+      goto function_end;
+    }
   }
+#endif
 
-  splt_t_put_progress_text(state,SPLT_PROGRESS_CREATE);
+#ifndef NO_ID3TAG
+  //the original tags are read here, once for the whole split
+  int tags_error = SPLT_OK;
+  splt_mp3_read_original_tag_bytes(state, mp3state, &tags_error);
+  if (tags_error < 0)
+  {
+    *error = tags_error;
+    goto function_end;
+  }
+#endif
+  mp3state->data_ptr = NULL;
+  mp3state->data_len = 0;
+  mp3state->buf_len = 0;
+  mp3state->bytes = 0;
 
-  double sec_end_time = fend_sec;
+  //we initialise the mad structures
+  splt_mp3_init_stream_frame(mp3state);
+  mad_synth_init(&mp3state->synth);
 
-  //if not seekable
-  if (!seekable)
+  mad_timer_reset(&mp3state->timer);
+  //the frame mode split of a non seekable input counts the samples
+  //from the start of the stream
+  mp3state->samples = 0;
+
+  //we read mp3 infos and set pointers to read the mp3 data
+  do
   {
-    if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+    int ret = splt_mp3_get_frame(state, mp3state);
+
+    if (ret == -2)
     {
-      file_output = splt_mp3_open_file_write(state, output_fname, error);
-      if (*error < 0) { return sec_end_time; };
+      splt_t_set_error_data(state,filename);
+      *error = SPLT_ERROR_INVALID;
+      goto function_end;
     }
 
-    int output_tags_version = splt_mp3_get_output_tags_version(state);
-
-    off_t id3v2_end_offset = 0;
-#ifndef NO_ID3TAG
-    //write id3 tags version 2 at the start of the file
-    if (output_tags_version == 2 || output_tags_version == 12)
+    if ((prev == 0) &&
+        ((ret == 0) || (mp3state->stream.error == MAD_ERROR_BUFLEN)))
     {
-      int err = SPLT_OK;
-      if ((err = splt_mp3_write_id3v2_tags(state, file_output,
-              output_fname, &id3v2_end_offset)) < 0)
-      {
-        *error = err;
-        goto bloc_end;
-      }
+      break;
     }
-#endif
 
-    //if we have the framemode
-    if (mp3state->framemode)
+    //if we have succeeded to read a frame
+    if (ret == 0)
     {
-      splt_u_print_debug(state,"Starting not seekable mp3 frame mode...",0,NULL);
-
-      long begin_c, end_c, time;
-      //convert seconds to hundreths
-      begin_c = (long) (fbegin_sec * 100);
-      if (fend_sec > 0)
+      //we set pointer to the frame
+      mp3state->data_ptr = (unsigned char *) mp3state->stream.this_frame;
+      //we set length of frame
+      if(mp3state->stream.next_frame!=NULL)
       {
-        end_c = (long) (fend_sec * 100);
-      }
-      else 
-      {
-        end_c = 0;
+        mp3state->data_len = (long) (mp3state->stream.next_frame - mp3state->stream.this_frame);
       }
-      time = 0;
 
-      do
+      if (mp3state->stream.anc_bitlen > 64)
       {
-        //we write xing if necessary
-        if (!writing && (time >= begin_c))
+        int tag = 0;
+        struct mad_bitptr ptr = mp3state->stream.anc_ptr;
+        struct mad_bitptr start = ptr;
+        //we search for xing (variable bit rate)
+        unsigned long xing_word = mad_bit_read(&ptr, 32);
+        if ((xing_word==SPLT_MP3_XING_MAGIC) ||
+            (xing_word==SPLT_MP3_INFO_MAGIC))
         {
-          writing = 1;
-          fbegin = mp3state->frames;
-
-          if (mp3state->mp3file.xing > 0)
+          tag = 1;
+        }
+        //Handle misplaced Xing header in mp3 files with CRC
+        else 
+        {
+          if (xing_word == ((SPLT_MP3_XING_MAGIC << 16) & 0xffffffffL) 
+              || xing_word == ((SPLT_MP3_INFO_MAGIC << 16) & 0xffffffffL))
           {
-            wrote = splt_u_fwrite(state, mp3state->mp3file.xingbuffer,
-                1, mp3state->mp3file.xing, file_output);
-            if (wrote < mp3state->mp3file.xing)
-            {
-              splt_t_set_error_data(state,output_fname);
-              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-              goto bloc_end;
-            }
+            ptr = start;
+            mad_bit_skip(&ptr, 16);
+            tag = 1;
           }
         }
 
-        //we do the split
-        if (writing)
+        //if we have xing, put infos
+        if (tag)
         {
-          if (mp3state->data_len > 0)
+          xing_word = mad_bit_read(&ptr, 32);
+          if (xing_word & SPLT_MP3_XING_FRAMES)
           {
-            if ((len = splt_u_fwrite(state, mp3state->data_ptr, 1, mp3state->data_len, file_output))
-                < mp3state->data_len)
-            {
-              splt_t_set_error_data(state,output_fname);
-              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-              goto bloc_end;
-            }
-            wrote = (off_t) (wrote + len);
-            mp3state->data_len = 0;
+            mad_timer_t total;
+            mp3state->frames = mad_bit_read(&ptr, 32);
+            total = mp3state->frame.header.duration;
+            mad_timer_multiply(&total, mp3state->frames);
+            float total_time_milliseconds = (float) mad_timer_count(total, MAD_UNITS_MILLISECONDS);
+            total_time_milliseconds /= 10.f;
+            splt_t_set_total_time(state, (long) ceilf(total_time_milliseconds));
           }
 
-          if ((end_c > 0) && (time >= end_c))
-          {
-            finished = 1;
-          }
-          if (eof || finished)
+          if (xing_word & SPLT_MP3_XING_BYTES)
           {
-            finished = 1;
-            if (eof) { *error = SPLT_OK_SPLIT_EOF; }
-            break;
+            if (mp3state->mp3file.len == 0)
+              mp3state->mp3file.len = mad_bit_read(&ptr, 32);
           }
-        }
-
-        //progress bar
-        if (splt_t_get_int_option(state,SPLT_OPT_SPLIT_MODE)
-            == SPLT_OPTION_TIME_MODE)
-        {
-          splt_t_update_progress(state,(double)(time-begin_c),
-              (double)(end_c-begin_c),1,0,
-              SPLT_DEFAULT_PROGRESS_RATE);
-        }
-        else
-        {
-          splt_t_update_progress(state,(double)(time),
-              (double)(end_c),1,0,
-              SPLT_DEFAULT_PROGRESS_RATE);
-        }
-
-        int mad_err = SPLT_OK;
-        switch (splt_mp3_get_valid_frame(state, &mad_err))
-        {
-          case 1:
-            mad_timer_add(&mp3state->timer, mp3state->frame.header.duration);
-            mp3state->frames++;
-            time = (unsigned long) mad_timer_count(mp3state->timer, MAD_UNITS_CENTISECONDS);
-            break;
-          case 0:
-            break;
-          case -1:
-            eof = 1;
-            *error = SPLT_OK_SPLIT_EOF;
-            break;
-          case -3:
-            //error from libmad
-            *error = mad_err;
-            goto bloc_end;
-            break;
-          default:
-            break;
-        }
-
-      } while (!finished);
-    }
-    //if we don't have the framemode
-    else
-    {
-      splt_u_print_debug(state,"Starting mp3 not seekable non frame mode...",0,NULL);
-
-      off_t begin = 0, end = 0;
-      if (fend_sec_is_not_eof)
-      {
-        end = (off_t) (fend_sec * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
-      }
-      else
-      {
-        end = -1;
-      }
-
-      //find begin point because no 'end' saved point
-      if (mp3state->end == 0)
-      {
-        begin = (off_t) (fbegin_sec * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
 
-        if ((mp3state->bytes == begin) && (mp3state->data_len > 0))
-        {
-          wrote += splt_mp3_write_data_ptr(state, filename, output_fname, file_output, error);
-          if (*error < 0) { goto bloc_end; }
-        }
-        else
-        {
-          while (mp3state->bytes < begin)
+          if (splt_t_get_int_option(state, SPLT_OPT_XING))
           {
-            off_t to_read;
-            if (feof(mp3state->file_input))
-            {
-              *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
-              goto bloc_end;
-            }
-            to_read = (begin - mp3state->bytes);
-            if (to_read > SPLT_MAD_BSIZE)
-              to_read = SPLT_MAD_BSIZE;
-            if ((mp3state->data_len = fread(mp3state->inputBuffer, 1, to_read, mp3state->file_input))<=0)
+            mp3state->mp3file.xing = mp3state->data_len;
+
+            if ((mp3state->mp3file.xingbuffer = 
+                  splt_u_malloc(mp3state->mp3file.xing))==NULL)
             {
-              *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
-              goto bloc_end;
+              *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+              goto function_end;
             }
-            mp3state->bytes+=mp3state->data_len;
+
+            memcpy(mp3state->mp3file.xingbuffer, mp3state->data_ptr,
+                mp3state->mp3file.xing);
+            mp3state->mp3file.xing_offset = splt_mp3_xing_info_off(mp3state);
           }
 
-          int mad_err = SPLT_OK;
-          splt_mp3_init_stream_frame(mp3state);
-          switch (splt_mp3_get_valid_frame(state, &mad_err))
+          //set framemode true (because VBR)
+          splt_t_set_int_option(state, SPLT_OPT_FRAME_MODE, SPLT_TRUE);
+          mp3state->framemode = 1;
+          //print message to client because frame mode enabled
+          if (!splt_t_messages_locked(state))
           {
-            case 1:
-              len = (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
-              if (len < 0)
-              {
-                splt_t_set_error_data(state,filename);
-                *error = SPLT_ERROR_WHILE_READING_FILE;
-                goto bloc_end;
-              }
-              if (splt_u_fwrite(state, mp3state->data_ptr, 1, len, file_output) < len)
+            if (!splt_t_get_iopt(state, SPLT_INTERNAL_FRAME_MODE_ENABLED))
+            {
+              int split_mode =
+                splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+
+              if (split_mode != SPLT_OPTION_WRAP_MODE &&
+                  split_mode != SPLT_OPTION_ERROR_MODE)
               {
-                splt_t_set_error_data(state,output_fname);
-                *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-                goto bloc_end;
+                splt_t_put_info_message_to_client(state,
+                    _(" info: found Xing or Info header. Switching to frame mode... \n"));
+                splt_t_set_iopt(state, SPLT_INTERNAL_FRAME_MODE_ENABLED, SPLT_TRUE);
               }
-              wrote = (off_t) (wrote + len);
-              mp3state->data_len = 0;
-              break;
-            case 0:
-              break;
-            case -1:
-              eof = 1;
-              *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
-              break;
-            case -3:
-              //error from libmad
-              *error = mad_err;
-              goto bloc_end;
-              break;
-            default:
-              break;
+            }
           }
+          continue;
         }
       }
-      //set the 'begin' as the saved 'end'
-      else
-      {
-        len = (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
-        if (len < 0)
-        {
-          splt_t_set_error_data(state,filename);
-          *error = SPLT_ERROR_WHILE_READING_FILE;
-          goto bloc_end;
-        }
-        if (splt_u_fwrite(state, mp3state->data_ptr, 1, len, file_output) < len)
-        {
-          splt_t_set_error_data(state,output_fname);
-          *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-          goto bloc_end;
-        }
-        wrote = (off_t) (wrote + len);
-        mp3state->data_len = 0;
-        begin = mp3state->end;
-      }
-
-      long split_begin_point = mp3state->bytes;
-      //while not end of file, read write:
-      while (!eof)
-      {
-        off_t to_read = SPLT_MAD_BSIZE;
-        if (end > 0)
-        {
-          to_read = (end - mp3state->bytes);
-          if (to_read <= 0)
-          {
-            break;
-          }
-          if (to_read > SPLT_MAD_BSIZE)
-            to_read = SPLT_MAD_BSIZE;
-        }
-
-        if (feof(mp3state->file_input) || 
-            ((mp3state->data_len = 
-              fread(mp3state->inputBuffer, 1, to_read, mp3state->file_input))<=0))
-        {
-          eof = 1;
-          *error = SPLT_OK_SPLIT_EOF;
-          break;
-        }
+    }
 
-        if (splt_u_fwrite(state, mp3state->inputBuffer, 1,
-              mp3state->data_len, file_output) < mp3state->data_len)
-        {
-          splt_t_set_error_data(state,output_fname);
-          *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-          goto bloc_end;
-        }
+    prev = ret;
+  } while (1);
 
-        mp3state->bytes += mp3state->data_len;
+  len = (long) (mp3state->buf_len - (mp3state->data_ptr - mp3state->inputBuffer));
 
-        splt_t_update_progress(state, (double) (mp3state->bytes-split_begin_point),
-            (double)(end-split_begin_point), 1,0,SPLT_DEFAULT_PROGRESS_RATE);
-      }
+  if (len < 0)
+  {
+    splt_t_set_error_data(state,filename);
+    *error = SPLT_ERROR_INVALID;
+    goto function_end;
+  }
 
-      splt_mp3_save_end_point(state, mp3state, save_end_point, end);
+  //we put useful infos in the state
+  mp3state->mp3file.firsth = (off_t) (mp3state->bytes - len);
+  mp3state->bytes = mp3state->mp3file.firsth;
+  mp3state->headw = 
+    (unsigned long) ((mp3state->data_ptr[0] << 24) | 
+        (mp3state->data_ptr[1] << 16) |
+        (mp3state->data_ptr[2] << 8) | (mp3state->data_ptr[3]));
+  mp3state->mp3file.mpgid = (int) ((mp3state->headw >> 19)&1);
+  mp3state->mp3file.layer = mp3state->frame.header.layer;
 
-      if (!eof)
+  mp3state->mp3file.freq = mp3state->frame.header.samplerate;
+  mp3state->mp3file.bitrate = mp3state->frame.header.bitrate/SPLT_MP3_BYTE;
+
+  splt_mp3_init_head_table(mp3state);
+  mp3state->mp3file.firsthead = 
+    splt_mp3_makehead(mp3state, mp3state->headw, mp3state->mp3file.firsthead, mp3state->mp3file.firsth);
+
+  mp3state->mp3file.fps = (float) (mp3state->mp3file.freq*(2-mp3state->mp3file.mpgid));
+  mp3state->mp3file.fps /= SPLT_MP3_PCM;
+
+  //we put the channels stuff (mono, stereo)
+  switch(mp3state->frame.header.mode)
+  {
+    case MAD_MODE_SINGLE_CHANNEL:
+      mp3state->mp3file.channels = 0;
+      break;
+    case MAD_MODE_DUAL_CHANNEL:
+      mp3state->mp3file.channels = 1;
+      break;
+    case MAD_MODE_JOINT_STEREO:
+      mp3state->mp3file.channels = 2;
+      break;
+    case MAD_MODE_STEREO:
+      mp3state->mp3file.channels = 3;
+      break;
+    default:
+      mp3state->mp3file.channels = 4;
+      break;
+  }
+
+  //we put the total time for constant bit rate
+  //if it was not set for the variable bit rate
+  if (splt_t_get_total_time(state) == 0)
+  {
+    if (mp3state->mp3file.len > 0)
+    {
+      long temp = (long)
+        (((double)(mp3state->mp3file.len - mp3state->mp3file.firsth)
+          / (double)mp3state->mp3file.bitrate) * 100.0);
+      splt_t_set_total_time(state, temp);
+    }
+  }
+
+function_end:
+  //we free memory allocated by mad_frame_decode(..)
+  //TODO: memory leak
+  //splt_mp3_finish_stream_frame(mp3state);
+  mad_synth_finish(&mp3state->synth);
+
+  return mp3state;
+}
+
+static void splt_mp3_end(splt_state *state, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  if (mp3state)
+  {
+    splt_mp3_finish_stream_frame(mp3state);
+#ifndef __WIN32__
+    if (mp3state->read_ahead)
+    {
+      splt_mp3_read_ahead_stop(state, mp3state->read_ahead);
+      mp3state->read_ahead = NULL;
+    }
+#endif
+    if (mp3state->file_input)
+    {
+      if (mp3state->file_input != stdin)
       {
-        //take the whole last frame : might result in more frames
-        //but if we don't do it, we might have less frames
-        int mad_err = SPLT_OK;
-        splt_mp3_init_stream_frame(mp3state);
-        switch (splt_mp3_get_valid_frame(state, &mad_err))
+        if (fclose(mp3state->file_input) != 0)
         {
-          case 1:
-            len = (long) (mp3state->data_ptr - mp3state->inputBuffer);
-            if (len < 0)
-            {
-              splt_t_set_error_data(state,filename);
-              *error = SPLT_ERROR_WHILE_READING_FILE;
-              goto bloc_end;
-            }
-            if (splt_u_fwrite(state, mp3state->inputBuffer, 1, len, file_output) < len)
-            {
-              splt_t_set_error_data(state,output_fname);
-              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
-              goto bloc_end;
-            }
-            break;
-          case 0:
-            break;
-          case -1:
-            eof = 1;
-            *error = SPLT_OK_SPLIT_EOF;
-            break;
-          case -3:
-            *error = mad_err;
-            goto bloc_end;
-            break;
-          default:
-            break;
+          splt_t_set_strerror_msg(state);
+          splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
+          *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
         }
       }
+      mp3state->file_input = NULL;
     }
+    //we free the mp3 state 
+    splt_mp3_state_free(state);
+  }
+  state->codec = NULL;
+}
 
-    //we write id3 and other stuff
-    if (file_output)
+//gets the mp3 info and puts it in the state
+static void splt_mp3_get_info(splt_state *state, FILE *file_input, int *error)
+{
+  //checks if valid mp3 file
+  //before last argument, if framemode or not
+  //last argument if we put messages to clients or not
+  state->codec = splt_mp3_info(file_input, state,
+        splt_t_get_int_option(state,SPLT_OPT_FRAME_MODE), error);
+  //if error
+  if ((*error < 0) || (state->codec == NULL))
+  {
+    if (state->codec != NULL)
     {
-      if (mp3state->mp3file.xing > 0)
+      splt_mp3_end(state, error);
+    }
+    return;
+  }
+  //print informations about the current file to the client
+  else
+  {
+    if ((! splt_t_messages_locked(state)) &&
+        (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) != SPLT_OPTION_WRAP_MODE) &&
+        (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) != SPLT_OPTION_ERROR_MODE))
+    {
+      splt_mp3_state *mp3state = state->codec;
+      struct splt_mp3 *mfile = &mp3state->mp3file;
+      //codec infos
+      char mpeg_infos[2048] = { '\0' };
+      snprintf(mpeg_infos,2048, _(" info: MPEG %d Layer %d - %d Hz - %s"),
+          (2-mfile->mpgid), mfile->layer, mfile->freq, splt_mp3_chan[mfile->channels]);
+      //frame mode or bitrate
+      char frame_mode_infos[256] = { '\0' };
+      if (mp3state->framemode)
       {
-        if (fseeko(file_output, mp3state->mp3file.xing_offset+4+id3v2_end_offset, SEEK_SET)!=-1)
+        if (splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
         {
-          unsigned long headw = (unsigned long) (mp3state->frames - fbegin + 1); // Frames
-          fputc((headw >> 24) & 0xFF, file_output);
-          fputc((headw >> 16) & 0xFF, file_output);
-          fputc((headw >> 8) & 0xFF, file_output);
-          fputc((headw >> 0) & 0xFF, file_output);
-          headw = (unsigned long) (wrote); // Bytes
-          fputc((headw >> 24) & 0xFF, file_output);
-          fputc((headw >> 16) & 0xFF, file_output);
-          fputc((headw >> 8) & 0xFF, file_output);
-          fputc((headw >> 0) & 0xFF, file_output);
+          snprintf(frame_mode_infos,256,_(" - FRAME MODE NS"));
         }
         else
         {
-          splt_t_set_strerror_msg(state);
-          splt_t_set_error_data(state, output_fname);
-          *error = SPLT_ERROR_SEEKING_FILE;
-          goto bloc_end;
+          snprintf(frame_mode_infos,256,_(" - FRAME MODE"));
         }
       }
-
-      //write id3 tags version 1 at the end of the file
-      if (output_tags_version == 1 || output_tags_version == 12)
+      else if (splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
       {
-        int err = SPLT_OK;
-        if ((err = splt_mp3_write_id3v1_tags(state, file_output, output_fname)) < 0)
-        {
-          *error = err;
-          goto bloc_end;
-        }
+        snprintf(frame_mode_infos,256,_(" - NS - %d Kb/s"),
+            mfile->bitrate * SPLT_MP3_BYTE / 1000);
+      }
+      else
+      {
+        snprintf(frame_mode_infos,256,_(" - %d Kb/s"),
+            mfile->bitrate * SPLT_MP3_BYTE / 1000);
       }
+      //total time
+      char total_time[256] = { '\0' };
+      int total_seconds = (int) (splt_t_get_total_time(state) / 100);
+      int minutes = total_seconds / 60;
+      int seconds = total_seconds % 60;
+      snprintf(total_time,256,_(" - Total time: %dm.%02ds"), minutes, seconds%60);
+      //put all the infos together
+      char all_infos[3072] = { '\0' };
+      snprintf(all_infos,3071,"%s%s%s\n",mpeg_infos,frame_mode_infos,total_time);
+      splt_t_put_info_message_to_client(state, all_infos);
     }
+  }
+}
 
-bloc_end:
-    if (file_output)
+/****************************/
+/* mp3 scan for silence */
+
+//used by mp3_scan_silence, returns the highest sample of the frame
+//-computes one frame
+static mad_fixed_t splt_mp3_silence(splt_mp3_state *mp3state, int channels)
+{
+  int i, j;
+  mad_fixed_t sample;
+  mad_fixed_t peak = 0;
+
+  for (j=0; j<channels; j++)
+  {
+    for(i=0; i<mp3state->synth.pcm.length; i++)
     {
-      if (file_output != stdout)
+      //get silence spot ?
+      sample = mad_f_abs(mp3state->synth.pcm.samples[j][i]);
+      mp3state->temp_level = mp3state->temp_level * 0.999 + sample * 0.001;
+
+      if (sample > peak)
       {
-        if (fclose(file_output) != 0)
-        {
-          splt_t_set_strerror_msg(state);
-          splt_t_set_error_data(state, output_fname);
-          *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
-        }
+        peak = sample;
       }
     }
-    file_output = NULL;
+  }
 
-    if (*error == SPLT_OK) { *error = SPLT_OK_SPLIT; }
+  return peak;
+}
 
-    return sec_end_time;
-  }
-  //if seekable:
-  else
+//starts the synthesis of the frames for a silence scan
+static void splt_mp3_init_silence_synth(splt_state *state,
+    splt_mp3_state *mp3state, float threshold)
+{
+  mad_synth_init(&mp3state->synth);
+
+  mp3state->fast_scan = splt_t_get_int_option(state, SPLT_OPT_FAST_SCAN);
+  if (mp3state->fast_scan)
   {
-    short write_first_frame = SPLT_FALSE;
-    off_t begin = 0, end = 0;
-    //if framemode
-    if (mp3state->framemode)
+    mp3state->recheck_low = mad_f_tofixed(
+        splt_u_convertfromdB(threshold - SPLT_MP3_RECHECK_MARGIN));
+    mp3state->recheck_high = mad_f_tofixed(
+        splt_u_convertfromdB(threshold + SPLT_MP3_RECHECK_MARGIN));
+    mp3state->recheck_current = 0;
+    mp3state->recheck_previous = SPLT_FALSE;
+    mad_frame_init(&mp3state->recheck_frame);
+    mad_synth_init(&mp3state->recheck_synth);
+
+    if (state->envelope.recording)
     {
-      splt_u_print_debug(state,"Starting seekable mp3 frame mode...",0,NULL);
+      state->envelope.rechecked = SPLT_TRUE;
+      state->envelope.scan_threshold = threshold;
+    }
+  }
+}
 
-      unsigned long fbegin, fend, adjust;
-      fbegin = fend = adjust = 0;
-      //prefer to split a bit before the start than loosing some frame
-      //so we don't 'ceilf'
-      fbegin = fbegin_sec * mp3state->mp3file.fps;
+static void splt_mp3_finish_silence_synth(splt_mp3_state *mp3state)
+{
+  mad_synth_finish(&mp3state->synth);
 
-      if (fend_sec_is_not_eof)
-      {
-        //if adjustoption
-        if (adjustoption)
-        {
-          if (fend_sec_is_not_eof)
-          {
-            float adj = (float) (adjustoption);
-            float len = (fend_sec - fbegin_sec);
-            if (adj > len)
-            {
-              adj = len;
-            }
-            if (fend_sec > adj)
-            {
-              fend_sec -= adj;
-            }
-            adjust = (unsigned long) (adj * 100.f);
-          }
-          else 
-          {
-            adjust = 0;
-          }
-        }
-        //prefer to split a bit after the end than loosing some frame
-        //before the end
-        fend = (unsigned long) ceilf(fend_sec * mp3state->mp3file.fps);
-      }
-      else 
+  if (mp3state->fast_scan)
+  {
+    mp3state->frame.options &= ~MAD_OPTION_HALFSAMPLERATE;
+    mad_frame_finish(&mp3state->recheck_frame);
+    mad_synth_finish(&mp3state->recheck_synth);
+  }
+}
+
+//synthesizes again the current frame at full quality, after the
+//previous frame to fill the synthesis filter
+//returns the highest sample of the frame
+static mad_fixed_t splt_mp3_recheck_silence(splt_state *state,
+    splt_mp3_state *mp3state)
+{
+  struct mad_frame *frame = &mp3state->recheck_frame;
+  int current = mp3state->recheck_current;
+
+  state->stats.frames_rechecked++;
+
+  frame->options = 0;
+  if (mp3state->recheck_previous)
+  {
+    frame->header = mp3state->recheck_header[1 - current];
+    memcpy(frame->sbsample, mp3state->recheck_sbsample[1 - current],
+        sizeof(frame->sbsample));
+    mad_synth_frame(&mp3state->recheck_synth, frame);
+  }
+  frame->header = mp3state->recheck_header[current];
+  memcpy(frame->sbsample, mp3state->recheck_sbsample[current],
+      sizeof(frame->sbsample));
+  mad_synth_frame(&mp3state->recheck_synth, frame);
+
+  struct mad_pcm *pcm = &mp3state->recheck_synth.pcm;
+  mad_fixed_t peak = 0;
+  int i, j;
+  for (j = 0;j < pcm->channels;j++)
+  {
+    for (i = 0;i < pcm->length;i++)
+    {
+      mad_fixed_t sample = mad_f_abs(pcm->samples[j][i]);
+      if (sample > peak)
       {
-        fend = 0xFFFFFFFF;
+        peak = sample;
       }
+    }
+  }
 
-      splt_u_print_debug(state,"Finding begin...",0,NULL);
+  return peak;
+}
 
-      if (mp3state->end == 0)
+//synthesizes the decoded frame and returns its highest sample; the
+//fast scan synthesizes one downmixed channel at half the sample rate
+static mad_fixed_t splt_mp3_silence_frame(splt_state *state,
+    splt_mp3_state *mp3state)
+{
+  struct mad_frame *frame = &mp3state->frame;
+
+  if (!mp3state->fast_scan)
+  {
+    mad_synth_frame(&mp3state->synth, frame);
+    return splt_mp3_silence(mp3state, MAD_NCHANNELS(&frame->header));
+  }
+
+  //keep the frame at full quality
+  int current = mp3state->recheck_current;
+  mp3state->recheck_header[current] = frame->header;
+  memcpy(mp3state->recheck_sbsample[current], frame->sbsample,
+      sizeof(frame->sbsample));
+
+  //downmix the subband samples, keeping the louder channel of each
+  //sample: an average would cancel channels in opposite phase
+  if (MAD_NCHANNELS(&frame->header) == 2)
+  {
+    int slots = MAD_NSBSAMPLES(&frame->header);
+    int s, sb;
+    for (s = 0;s < slots;s++)
+    {
+      for (sb = 0;sb < 32;sb++)
       {
-        if (mp3state->first)
+        if (mad_f_abs(frame->sbsample[1][s][sb]) >
+            mad_f_abs(frame->sbsample[0][s][sb]))
         {
-          mp3state->h.ptr = mp3state->mp3file.firsthead.ptr;
-          mp3state->h.framesize = mp3state->mp3file.firsthead.framesize;
-          begin = mp3state->mp3file.firsthead.ptr;
-          mp3state->first = 0;
+          frame->sbsample[0][s][sb] = frame->sbsample[1][s][sb];
         }
+      }
+    }
+    frame->header.mode = MAD_MODE_SINGLE_CHANNEL;
+  }
+  frame->options |= MAD_OPTION_HALFSAMPLERATE;
 
-        splt_t_put_progress_text(state,SPLT_PROGRESS_PREPARE);
+  mad_synth_frame(&mp3state->synth, frame);
+  mad_fixed_t peak = splt_mp3_silence(mp3state, 1);
 
-        // Finds begin by counting frames
-        while (mp3state->frames < fbegin)
-        {
-          begin = splt_mp3_findhead(mp3state, mp3state->h.ptr + mp3state->h.framesize);
-          if (begin == -1) { *error = SPLT_ERROR_BEGIN_OUT_OF_FILE; goto bloc_end2; }
+  if ((peak >= mp3state->recheck_low) && (peak <= mp3state->recheck_high))
+  {
+    peak = splt_mp3_recheck_silence(state, mp3state);
+  }
 
-          //count the number of syncerrors
-          if ((begin!=mp3state->h.ptr + mp3state->h.framesize)&&(state->syncerrors>=0)) 
-          {
-            state->syncerrors++;
-          }
-          if ((mp3state->syncdetect)&&(state->syncerrors> SPLT_MAXSYNC))
-          {
-            splt_mp3_checksync(mp3state);
-          }
+  mp3state->recheck_previous = SPLT_TRUE;
+  mp3state->recheck_current = 1 - current;
 
-          mp3state->h = splt_mp3_makehead(mp3state->headw, mp3state->mp3file, mp3state->h, begin);
-          mp3state->frames++;
+  return peak;
+}
 
-          //if we have adjust mode, then put only 25%
-          //else put 50%
-          if (adjustoption)
-          {
-            splt_t_update_progress(state,(double)(mp3state->frames),
-                (double)fend, 8,
-                0,SPLT_DEFAULT_PROGRESS_RATE);
-          }
-          else
-          {
-            splt_t_update_progress(state,(double)(mp3state->frames),
-                (double)fend,progress_adjust_val,
-                0,SPLT_DEFAULT_PROGRESS_RATE);
-          }
-        }
-      }
-      else
-      {
-        begin = mp3state->end;
-      }
+//converts seconds to a number of samples of the input file
+static unsigned long long splt_mp3_seconds_to_samples(splt_mp3_state *mp3state,
+    double seconds)
+{
+  if (seconds <= 0)
+  {
+    return 0;
+  }
 
-      splt_u_print_debug(state,"Begin is...",begin,NULL);
+  return (unsigned long long) (seconds * mp3state->mp3file.freq + 0.5);
+}
 
-      if (mp3state->mp3file.len > 0)
-      {
-        if (begin >= mp3state->mp3file.len) // If we can check, we just do that :)
-        {
-          *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
-          goto bloc_end2;
-        }
-      }
+//advances the sample clock by the frame just decoded
+static void splt_mp3_count_samples(splt_mp3_state *mp3state)
+{
+  mp3state->samples += SPLT_MP3_FRAME_SAMPLES(&mp3state->frame.header);
+}
 
-      splt_t_put_progress_text(state,SPLT_PROGRESS_PREPARE);
+//scan for silence
+//-returns the number of silence points found
+//and -1 if error; the error is set in the '*error' parameter
+static int splt_mp3_scan_silence(splt_state *state, off_t begin, 
+    unsigned long length, float threshold, 
+    float min, short output, int *error)
+{
+  int found = 0;
+  short flush = 0, stop = 0;
+  double time;
+  //unsigned long count = 0;
+  off_t pos;
+  splt_silence_detector detector;
 
-      long int frames_begin = mp3state->frames;
-      // Finds end by counting frames
-      while (mp3state->frames <= fend)
-      {
-        mp3state->frames++;
-        end = splt_mp3_findhead(mp3state, mp3state->h.ptr + mp3state->h.framesize);
-        if (end == -1)
+  splt_mp3_state *mp3state = state->codec;
+
+  splt_t_put_progress_text(state,SPLT_PROGRESS_SCAN_SILENCE);
+
+  pos = begin;
+
+  //we seek to the begin
+  state->stats.seeks++;
+  if (fseeko(mp3state->file_input, begin, SEEK_SET)==-1)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
+    *error = SPLT_ERROR_SEEKING_FILE;
+    return -1;
+  }
+
+  splt_en_detector_init(&detector, threshold, min, output);
+
+  //initialise mad stuff
+  splt_mp3_init_stream_frame(mp3state);
+  splt_mp3_init_silence_synth(state, mp3state, threshold);
+
+  //the length is in hundreths of seconds
+  unsigned long long length_samples =
+    splt_mp3_seconds_to_samples(mp3state, length / 100.0);
+  double seconds_per_sample = 1.0 / mp3state->mp3file.freq;
+  mp3state->samples = 0;
+
+  mp3state->temp_level = 0.0;
+
+  splt_en_start_levels(state);
+
+  //we do the effective scan
+  do
+  {
+    int mad_err = SPLT_OK;
+    switch (splt_mp3_get_valid_frame(state, &mad_err))
+    {
+      case 1:
+        //1 we have a valid frame
+        //we get mad infos and put them in the mp3state
+        splt_mp3_count_samples(mp3state);
+        state->stats.frames_decoded++;
+        time = mp3state->samples * seconds_per_sample;
+
+        if (length > 0)
         {
-          end = mp3state->h.ptr + mp3state->h.framesize; // Last valid offset
-          eof=1;
-          *error = SPLT_OK_SPLIT_EOF;
-          break;
+          if (mp3state->samples >= length_samples)
+          {
+            flush = 1;
+            stop = 1;
+          }
         }
 
-        //count the number of syncerrors
-        if ((end != mp3state->h.ptr + mp3state->h.framesize)&&(state->syncerrors>=0))
+        mad_fixed_t peak = splt_mp3_silence_frame(state, mp3state);
+        int en_err = splt_en_put_block(state, time,
+            (float) mad_f_todouble(peak),
+            (float) mad_f_todouble(mp3state->temp_level));
+        if (en_err < 0)
         {
-          state->syncerrors++;
+          *error = en_err;
+          stop = 1;
+          found = -1;
+          break;
         }
-        if ((mp3state->syncdetect)&&(state->syncerrors>SPLT_MAXSYNC))
+        if (splt_en_detector_put(state, &detector, time,
+              (float) mad_f_todouble(peak), flush, error) == -1)
         {
-          splt_mp3_checksync(mp3state);
+          stop = 1;
+          found = -1;
+          break;
         }
+        found = detector.found;
 
-        mp3state->h = splt_mp3_makehead (mp3state->headw, mp3state->mp3file, mp3state->h, end);
+        splt_en_put_level(state, time,
+            (float) mad_f_todouble(mp3state->temp_level), found);
 
-        //if we have a progress callback function
-        //time split only calculates the end of the 
-        //split
-        int split_mode = splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
-        if (((split_mode == SPLT_OPTION_TIME_MODE) || 
-              (split_mode == SPLT_OPTION_SILENCE_MODE))
-            && (!splt_t_get_int_option(state,SPLT_OPT_AUTO_ADJUST)))
-        {
-          splt_t_update_progress(state, (double)(mp3state->frames-fbegin),
-              (double)(fend-fbegin), progress_adjust_val,
-              0, SPLT_DEFAULT_PROGRESS_RATE);
-        }
-        else
+        if (mp3state->mp3file.len > 0)
         {
-          if (adjustoption)
+          pos = ftello(mp3state->file_input);
+
+          //if we don't have silence split,
+          //put the 1/4 of progress
+          if (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) != 
+              SPLT_OPTION_SILENCE_MODE)
           {
-            if(adjust)
-            {
-              if (split_mode == SPLT_OPTION_TIME_MODE)
-              {
-                splt_t_update_progress(state,
-                    (double)(mp3state->frames-frames_begin),
-                    (double)(fend-frames_begin),
-                    4,0,SPLT_DEFAULT_PROGRESS_RATE);
-              }
-              else
-              {
-                splt_t_update_progress(state,
-                    (double)(mp3state->frames-frames_begin),
-                    (double)(fend-frames_begin),
-                    8,1/(float)8,SPLT_DEFAULT_PROGRESS_RATE);
-              }
-            }
+            splt_t_update_progress(state,(double)(mp3state->samples),
+                (double)(length_samples), 4,1/(float)4,
+                SPLT_DEFAULT_PROGRESS_RATE);
           }
           else
           {
-            splt_t_update_progress(state,
-                (double)(mp3state->frames-stopped_frames),
-                (double)(fend-stopped_frames),
-                progress_adjust_val,
-                0,SPLT_DEFAULT_PROGRESS_RATE);
+            splt_t_update_progress(state,(double)pos,
+                (double)(mp3state->mp3file.len),
+                1,0,SPLT_DEFAULT_PROGRESS_RATE);
           }
         }
 
-        //if adjust option, scans for silence
-        if ((adjust) && (mp3state->frames >= fend))
+        //if we have cancelled the split
+        if (splt_t_split_is_canceled(state))
         {
-          int silence_points_found =
-            splt_mp3_scan_silence(state, end, 2 * adjust, threshold, 0.f, 0, error);
-          //if error, go out
-          if (silence_points_found == -1)
-          {
-            goto bloc_end2;
-          }
-          else if (silence_points_found > 0)
-          {
-            adjust = (unsigned long) (splt_u_silence_position(state->silence_list, mp3state->off) 
-                * mp3state->mp3file.fps);
-          }
-          else
-          {
-            adjust = (unsigned long) (adjustoption * mp3state->mp3file.fps);
-          }
-          fend += adjust;
-          end = splt_mp3_findhead(mp3state, end);
-
-          sec_end_time = mp3state->frames / mp3state->mp3file.fps;
-
-          splt_t_ssplit_free(&state->silence_list);
-          adjust=0;
-          //progress
+          stop = 1;
+        }
+        break;
+      case 0:
+        //0 we do nothing
+        break;
+      case -1:
+        // -1 means eof
+        stop = 1;
+        break;
+      case -3:
+        //error from libmad
+        stop = 1;
+        *error = mad_err;
+        found = -1;
+        break;
+      default:
+        break;
+    }
+  } while (!stop);
+
+  splt_en_end_levels(state, found);
+
+  //only if we have silence mode, we set progress to 100%
+  if (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE) == 
+      SPLT_OPTION_SILENCE_MODE)
+  {
+    splt_t_update_progress(state,1.0,1.0,1,1,1);
+  }
+
+  //we finish with mad_*
+  splt_mp3_finish_stream_frame(mp3state);
+  splt_mp3_finish_silence_synth(mp3state);
+
+  return found;
+}
+
+/****************************/
+/* mp3 seek index */
+
+//builds the seek index by walking the frame headers of the file,
+//keeping the offset of one frame every SPLT_MP3_SEEK_INDEX_SECONDS
+//returns -1 on error
+static int splt_mp3_build_seek_index(splt_state *state, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  unsigned long step =
+    (unsigned long) (SPLT_MP3_SEEK_INDEX_SECONDS * mp3state->mp3file.fps);
+  if (step == 0)
+  {
+    step = 1;
+  }
+
+  long allocated = 64;
+  struct splt_mp3_seek_entry *entries =
+    splt_u_malloc(sizeof(struct splt_mp3_seek_entry) * allocated);
+  if (entries == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return -1;
+  }
+
+  long number = 0;
+  unsigned long frames = 0;
+  struct splt_header h = mp3state->mp3file.firsthead;
+  off_t offset = h.ptr;
+
+  int result = -1;
+
+  //the index is built in the middle of a split
+  int progress_type = state->split.p_bar->progress_type;
+  splt_t_put_progress_text(state, SPLT_PROGRESS_PREPARE);
+
+  while (offset != -1)
+  {
+    //reads the header word at 'offset'
+    if (splt_mp3_findhead(mp3state, offset) != offset)
+    {
+      break;
+    }
+
+    if ((frames % step) == 0)
+    {
+      if (number == allocated)
+      {
+        allocated *= 2;
+        struct splt_mp3_seek_entry *more =
+          splt_u_realloc(entries, sizeof(struct splt_mp3_seek_entry) * allocated);
+        if (more == NULL)
+        {
+          free(entries);
+          *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+          goto function_end;
+        }
+        entries = more;
+      }
+      entries[number].frame = frames;
+      entries[number].offset = offset;
+      number++;
+    }
+
+    //the next frame follows, unless there is garbage to skip: then we
+    //check the header found to avoid a false sync
+    h = splt_mp3_makehead(mp3state, mp3state->headw, h, offset);
+    off_t next = h.ptr + h.framesize;
+    offset = splt_mp3_findhead(mp3state, next);
+    if ((offset != -1) && (offset != next))
+    {
+      offset = splt_mp3_findvalidhead(mp3state, next);
+    }
+    frames++;
+    state->stats.frames_parsed++;
+
+    if (splt_t_split_is_canceled(state))
+    {
+      free(entries);
+      *error = SPLT_SPLIT_CANCELLED;
+      goto function_end;
+    }
+
+    if (mp3state->mp3file.len > 0)
+    {
+      splt_t_update_progress(state, (double) h.ptr,
+          (double) mp3state->mp3file.len, 1, 0, SPLT_DEFAULT_PROGRESS_RATE);
+    }
+  }
+
+  mp3state->seek_index = entries;
+  mp3state->seek_index_number = number;
+  mp3state->seek_index_step = step;
+  result = 0;
+
+function_end:
+  splt_t_put_progress_text(state, progress_type);
+
+  return result;
+}
+
+//returns the estimated offset of the time 'seconds', interpolated
+//between the entries of the seek index
+static off_t splt_mp3_seek_index_offset(splt_mp3_state *mp3state,
+    double seconds)
+{
+  struct splt_mp3_seek_entry *entries = mp3state->seek_index;
+  long number = mp3state->seek_index_number;
+
+  double frame = seconds * mp3state->mp3file.fps;
+  if (frame < 0)
+  {
+    frame = 0;
+  }
+
+  long i = (long) (frame / mp3state->seek_index_step);
+
+  //after the last entry, we continue with the bitrate of the file
+  if (i >= number - 1)
+  {
+    struct splt_mp3_seek_entry *last = &entries[number - 1];
+    return (off_t) (last->offset +
+        (frame - last->frame) / mp3state->mp3file.fps * mp3state->mp3file.bitrate);
+  }
+
+  double ratio = (frame - entries[i].frame) /
+    (double) (entries[i+1].frame - entries[i].frame);
+
+  return (off_t) (entries[i].offset +
+      ratio * (entries[i+1].offset - entries[i].offset));
+}
+
+//returns the estimated offset of the time 'seconds' of the input file
+//when not in frame mode; returns -1 on error
+static off_t splt_mp3_seconds_to_offset(splt_state *state, double seconds,
+    short *from_index, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  *from_index = SPLT_FALSE;
+
+  if (splt_t_get_int_option(state, SPLT_OPT_SEEK_INDEX))
+  {
+    if (mp3state->seek_index == NULL)
+    {
+      if (splt_mp3_build_seek_index(state, error) == -1)
+      {
+        return -1;
+      }
+    }
+
+    if (mp3state->seek_index_number > 0)
+    {
+      *from_index = SPLT_TRUE;
+      return splt_mp3_seek_index_offset(mp3state, seconds);
+    }
+  }
+
+  return (off_t) (seconds * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
+}
+
+/****************************/
+/* mp3 split */
+
+static off_t splt_mp3_write_data_ptr(splt_state *state, const char *filename,
+    const char *output_fname, FILE *file_output, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  long len = (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
+
+  if (len < 0)
+  {
+    splt_t_set_error_data(state, filename);
+    *error = SPLT_ERROR_WHILE_READING_FILE;
+    return len;
+  }
+
+  if (splt_u_fwrite(state, mp3state->data_ptr, 1, len, file_output) < len)
+  {
+    splt_t_set_error_data(state,output_fname);
+    *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    return len;
+  }
+
+  mp3state->data_len = 0;
+
+  return len;
+}
+
+
+//puts the split file in the manifest instead of writing it:
+//the prefix is the same as the one written by splt_mp3_simple_split
+//(ID3v2, Xing frame and the first frame from the input buffer),
+//the suffix is the ID3v1 and the data is the range 'begin'-'end'
+//of the input file
+static int splt_mp3_put_manifest_segment(splt_state *state, const char *output_fname,
+    off_t begin, off_t end, int do_write_tags, short write_first_frame)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  int error = SPLT_OK;
+  const char *filename = splt_t_get_filename_to_split(state);
+  int output_tags_version = splt_mp3_get_output_tags_version(state);
+
+  char *id3v2 = NULL, *id3v1 = NULL, *prefix = NULL;
+  unsigned long id3v2_len = 0, id3v1_len = 0;
+  unsigned long xing_len = 0, prefix_len = 0;
+  long first_frame_len = 0;
+
+  int phase = splt_st_enter_phase(state, SPLT_PHASE_TAGS);
+#ifndef NO_ID3TAG
+  if (do_write_tags && (output_tags_version == 2 || output_tags_version == 12))
+  {
+    id3v2 = splt_mp3_build_tags(filename, state, &error, &id3v2_len, 2);
+  }
+#endif
+  if ((error >= 0) && do_write_tags &&
+      (output_tags_version == 1 || output_tags_version == 12))
+  {
+    id3v1 = splt_mp3_build_tags(filename, state, &error, &id3v1_len, 1);
+  }
+  splt_st_leave_phase(state, phase);
+  if (error < 0) { goto function_end; }
+
+  if ((mp3state->mp3file.xing != 0) &&
+      splt_t_get_int_option(state, SPLT_OPT_XING) &&
+      (state->options.split_mode != SPLT_OPTION_ERROR_MODE))
+  {
+    xing_len = mp3state->mp3file.xing;
+  }
+
+  if (write_first_frame)
+  {
+    first_frame_len =
+      (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
+    if (first_frame_len < 0)
+    {
+      splt_t_set_error_data(state, filename);
+      error = SPLT_ERROR_WHILE_READING_FILE;
+      goto function_end;
+    }
+    mp3state->data_len = 0;
+  }
+
+  prefix_len = id3v2_len + xing_len + first_frame_len;
+  if (prefix_len > 0)
+  {
+    if ((prefix = splt_u_malloc(prefix_len)) == NULL)
+    {
+      error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      goto function_end;
+    }
+    if (id3v2_len > 0)
+    {
+      memcpy(prefix, id3v2, id3v2_len);
+    }
+    memcpy(prefix + id3v2_len, mp3state->mp3file.xingbuffer, xing_len);
+    memcpy(prefix + id3v2_len + xing_len, mp3state->data_ptr, first_frame_len);
+  }
+
+  //for the last split
+  if (end == -1)
+  {
+    end = mp3state->end2;
+  }
+
+  error = splt_mf_put_segment(state, output_fname, begin, end - begin,
+      prefix, prefix_len, id3v1, id3v1_len);
+
+function_end:
+  if (id3v2)
+  {
+    free(id3v2);
+    id3v2 = NULL;
+  }
+  if (id3v1)
+  {
+    free(id3v1);
+    id3v1 = NULL;
+  }
+  if (prefix)
+  {
+    free(prefix);
+    prefix = NULL;
+  }
+
+  return error;
+}
+
+//used for the mp3 sync errors, dewrap and mp3 seekable split(for header)
+//returns 0 if no errors, SPLT_ defined errors if ones
+//It justs copies the data of the input file from a begin offset
+//to an end offset, and, eventually, a Xing frame (for VBR)
+//at the beginning and a ID3v1 at the end, to an outputfile.
+static int splt_mp3_simple_split(splt_state *state, const char *output_fname,
+    off_t begin, off_t end, int do_write_tags, short write_first_frame)
+{
+  splt_u_print_debug(state,"We do mp3 simple split on output...",0,output_fname);
+  splt_u_print_debug(state,"Mp3 simple split offset begin is",begin,NULL);
+  splt_u_print_debug(state,"Mp3 simple split offset end is",end,NULL);
+
+  splt_mp3_state *mp3state = state->codec;
+
+  int error = SPLT_OK_SPLIT;
+
+  FILE *file_output = NULL;
+  off_t position = 0;
+  unsigned char buffer[SPLT_MP3_READBSIZE] = { '\0' };
+  long readed = 0;
+  //for the progress
+  off_t temp_end = 0;
+  //the start point of the split
+  long start = begin;
+  int split_mode = splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+
+  splt_t_put_progress_text(state, SPLT_PROGRESS_CREATE);
+
+  char *filename = splt_t_get_filename_to_split(state);
+
+  position = ftello(mp3state->file_input); // Save current position
+
+  state->stats.seeks++;
+  if (fseeko(mp3state->file_input, begin, SEEK_SET)==-1)
+  {
+    return SPLT_ERROR_BEGIN_OUT_OF_FILE;
+  }
+
+  //get the file size
+  off_t st_size;
+  char *fname_to_split = splt_t_get_filename_to_split(state);
+  if(splt_u_stat(fname_to_split, NULL, &st_size) == 0)
+  {
+    mp3state->end2 = st_size;
+  }
+  else
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state,fname_to_split);
+    return SPLT_ERROR_CANNOT_OPEN_FILE;
+  }
+
+  //with a manifest, we don't write any data
+  if (splt_mf_is_enabled(state))
+  {
+    //when pretending, the manifest is left untouched like the split files
+    if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+    {
+      int err = splt_mp3_put_manifest_segment(state, output_fname,
+          begin, end, do_write_tags, write_first_frame);
+      if (err < 0) { error = err; }
+    }
+    else if (write_first_frame)
+    {
+      mp3state->data_len = 0;
+    }
+
+    state->stats.seeks++;
+    if ((fseeko(mp3state->file_input, position, SEEK_SET)==-1) && (error >= 0))
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, filename);
+      error = SPLT_ERROR_SEEKING_FILE;
+    }
+
+    return error;
+  }
+
+  if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  {
+    off_t size = ((end == -1) ? mp3state->end2 : end) - begin;
+    file_output = splt_mp3_open_file_write(state, output_fname,
+        size + mp3state->mp3file.xing, &error);
+    if (error < 0) { return error; }
+  }
+
+  int output_tags_version = splt_mp3_get_output_tags_version(state);
+
+#ifndef NO_ID3TAG
+  //write id3 tags version 2 at the start of the file, if necessary
+  if (do_write_tags && (output_tags_version == 2 || output_tags_version == 12))
+  {
+    int err = SPLT_OK;
+    if ((err = splt_mp3_write_id3v2_tags(state, file_output,
+            output_fname, NULL)) < 0)
+    {
+      error = err;
+      goto function_end;
+    }
+  }
+#endif
+
+  if (mp3state->mp3file.xing != 0)
+  {
+    if (splt_t_get_int_option(state, SPLT_OPT_XING))
+    {
+      //error mode split must only contain original file data
+      if (state->options.split_mode != SPLT_OPTION_ERROR_MODE)
+      {
+        if (splt_u_fwrite(state, mp3state->mp3file.xingbuffer, 1, 
+              mp3state->mp3file.xing, file_output) < mp3state->mp3file.xing)
+        {
+          splt_t_set_error_data(state, output_fname);
+          error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+          goto function_end;
+        }
+      }
+    }
+  }
+
+  if (write_first_frame)
+  {
+    splt_mp3_write_data_ptr(state, filename, output_fname, file_output, &error);
+    if (error < 0) { goto function_end; }
+  }
+
+  while (!feof(mp3state->file_input))
+  {
+    readed = SPLT_MP3_READBSIZE;
+    if (end != -1)
+    {
+      if (begin >= end) 
+      {
+        break;
+      }
+      if ((end - begin) < SPLT_MP3_READBSIZE)
+      {
+        readed = end - begin;
+      }
+    }
+
+    if ((readed = fread(buffer, 1, readed, mp3state->file_input))==-1)
+    {
+      break;
+    }
+    state->stats.bytes_read += readed;
+
+    if (splt_u_fwrite(state, buffer, 1, readed, file_output) < readed)
+    {
+      splt_t_set_error_data(state,output_fname);
+      error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+      goto function_end;
+    }
+    begin += readed;
+
+    if (splt_t_split_is_canceled(state))
+    {
+      error = SPLT_SPLIT_CANCELLED;
+      goto function_end;
+    }
+
+    //we update the progress bar
+    if ((split_mode == SPLT_OPTION_WRAP_MODE) ||
+        (split_mode == SPLT_OPTION_ERROR_MODE) ||
+        ((split_mode == SPLT_OPTION_NORMAL_MODE)
+         && (!splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST)) 
+         && (!splt_t_get_int_option(state, SPLT_OPT_FRAME_MODE))))
+    {
+      temp_end = end;
+      //for the last split
+      if (end == -1)
+      {
+        temp_end = mp3state->end2;
+      }
+
+      splt_t_update_progress(state,(double)(begin-start),
+          (double)(temp_end-start),1,0,
+          SPLT_DEFAULT_PROGRESS_RATE);
+    }
+    else
+    {
+      //if auto adjust, we have 50%
+      if (splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST))
+      {
+        splt_t_update_progress(state,(double)(begin-start),
+            (double)(end-start),
+            2,0.5, SPLT_DEFAULT_PROGRESS_RATE);
+      }
+      else
+      {
+        if (splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE)
+            == SPLT_OPTION_TIME_MODE)
+        {
+          temp_end = end;
+          //for the last split
+          if (end == -1)
+          {
+            temp_end = mp3state->end2;
+          }
+
+          //if framemode
+          if (splt_t_get_int_option(state, SPLT_OPT_FRAME_MODE))
+          {
+            splt_t_update_progress(state,(double)(begin-start),
+                (double)(temp_end-start),
+                2,0.5, SPLT_DEFAULT_PROGRESS_RATE);
+          }
+          else
+          {
+            splt_t_update_progress(state,(double)(begin-start),
+                (double)(temp_end-start),
+                1,0, SPLT_DEFAULT_PROGRESS_RATE);
+          }
+        }
+        else
+        {
+          splt_t_update_progress(state,(double)(begin-start),
+              (double)(end-start),
+              2,0.5, SPLT_DEFAULT_PROGRESS_RATE);
+        }
+      }
+    }
+  }
+
+  //write id3 tags version 1 at the end of the file, if necessary
+  if (do_write_tags && (output_tags_version == 1 || output_tags_version == 12))
+  {
+    int err = SPLT_OK;
+    if ((err = splt_mp3_write_id3v1_tags(state, file_output, output_fname)) < 0)
+    {
+      error = err;
+      goto function_end;
+    }
+  }
+
+  splt_io_input_consumed(state, mp3state->file_input, begin);
+
+  state->stats.seeks++;
+  if (fseeko(mp3state->file_input, position, SEEK_SET)==-1)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, filename);
+    goto function_end;
+  }
+
+function_end:
+  if (file_output)
+  {
+    if (splt_u_fclose_output(state, file_output) != 0)
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, filename);
+      return SPLT_ERROR_CANNOT_CLOSE_FILE;
+    }
+    file_output = NULL;
+  }
+
+  return error;
+}
+
+//the main mp3 split function
+//filename is our filename
+//state is our state
+//fbegin_sec is the begin splitpoint
+//fend_sec is the end splitpoint
+//adjustoption is if we adjust with silence detection or not
+//seekable is if we split in seekable mode or not
+//threshold - see manual
+//must be called after splt_mp3_info()
+//returns possible error in '*error'
+static double splt_mp3_split(const char *output_fname, splt_state *state,
+    double fbegin_sec, double fend_sec, int *error, int save_end_point)
+{
+  splt_u_print_debug(state,"Mp3 split...",0,NULL);
+  splt_u_print_debug(state,"Output filename is",0,output_fname);
+  splt_u_print_debug(state,"Begin position",fbegin_sec,NULL);
+  splt_u_print_debug(state,"End position",fend_sec,NULL);
+
+  splt_mp3_state *mp3state = state->codec;
+
+  int adjustoption = splt_t_get_int_option(state, SPLT_OPT_PARAM_GAP);
+  short seekable = ! splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE);
+  float threshold = splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD);
+
+  short fend_sec_is_not_eof =
+    !splt_u_fend_sec_is_bigger_than_total_time(state, fend_sec);
+
+  short eof=0, check_bitrate=0;
+
+  char *filename = splt_t_get_filename_to_split(state);
+
+  FILE *file_output = NULL;
+  short writing = 0, finished=0;
+  unsigned long fbegin=0;
+  off_t wrote = 0;
+  long len = 0;
+  //for the progress
+  unsigned long stopped_frames = 0;
+  int progress_adjust_val = 2;
+  //the phase to restore after the cutpoint search
+  int phase = state->iopts.current_phase;
+
+  if (adjustoption) 
+  {
+    progress_adjust_val = 4;
+  }
+
+  splt_t_put_progress_text(state,SPLT_PROGRESS_CREATE);
+
+  double sec_end_time = fend_sec;
+
+  //if not seekable
+  if (!seekable)
+  {
+    //a manifest needs byte ranges of a seekable input
+    if (splt_mf_is_enabled(state))
+    {
+      *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+      return sec_end_time;
+    }
+
+    if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+    {
+      //the size is estimated from the bitrate of the first frame
+      off_t size = 0;
+      if (fend_sec_is_not_eof)
+      {
+        size = (off_t) ((fend_sec - fbegin_sec) * mp3state->mp3file.bitrate);
+      }
+      file_output = splt_mp3_open_file_write(state, output_fname, size, error);
+      if (*error < 0) { return sec_end_time; };
+    }
+
+    int output_tags_version = splt_mp3_get_output_tags_version(state);
+
+    off_t id3v2_end_offset = 0;
+#ifndef NO_ID3TAG
+    //write id3 tags version 2 at the start of the file
+    if (output_tags_version == 2 || output_tags_version == 12)
+    {
+      int err = SPLT_OK;
+      if ((err = splt_mp3_write_id3v2_tags(state, file_output,
+              output_fname, &id3v2_end_offset)) < 0)
+      {
+        *error = err;
+        goto bloc_end;
+      }
+    }
+#endif
+
+    //if we have the framemode
+    if (mp3state->framemode)
+    {
+      splt_u_print_debug(state,"Starting not seekable mp3 frame mode...",0,NULL);
+
+      unsigned long long begin_s, end_s;
+      //convert seconds to samples
+      begin_s = splt_mp3_seconds_to_samples(mp3state, fbegin_sec);
+      end_s = splt_mp3_seconds_to_samples(mp3state, fend_sec);
+
+      do
+      {
+        //we write xing if necessary
+        if (!writing && (mp3state->samples >= begin_s))
+        {
+          writing = 1;
+          fbegin = mp3state->frames;
+
+          if (mp3state->mp3file.xing > 0)
+          {
+            wrote = splt_u_fwrite(state, mp3state->mp3file.xingbuffer,
+                1, mp3state->mp3file.xing, file_output);
+            if (wrote < mp3state->mp3file.xing)
+            {
+              splt_t_set_error_data(state,output_fname);
+              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+              goto bloc_end;
+            }
+          }
+        }
+
+        //we do the split
+        if (writing)
+        {
+          if (mp3state->data_len > 0)
+          {
+            if ((len = splt_u_fwrite(state, mp3state->data_ptr, 1, mp3state->data_len, file_output))
+                < mp3state->data_len)
+            {
+              splt_t_set_error_data(state,output_fname);
+              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+              goto bloc_end;
+            }
+            wrote = (off_t) (wrote + len);
+            mp3state->data_len = 0;
+          }
+
+          if ((end_s > 0) && (mp3state->samples >= end_s))
+          {
+            finished = 1;
+          }
+          if (eof || finished)
+          {
+            finished = 1;
+            if (eof) { *error = SPLT_OK_SPLIT_EOF; }
+            break;
+          }
+        }
+
+        if (splt_t_split_is_canceled(state))
+        {
+          *error = SPLT_SPLIT_CANCELLED;
+          goto bloc_end;
+        }
+
+        //progress bar
+        if (splt_t_get_int_option(state,SPLT_OPT_SPLIT_MODE)
+            == SPLT_OPTION_TIME_MODE)
+        {
+          splt_t_update_progress(state,
+              (double)mp3state->samples - (double)begin_s,
+              (double)end_s - (double)begin_s,1,0,
+              SPLT_DEFAULT_PROGRESS_RATE);
+        }
+        else
+        {
+          splt_t_update_progress(state,(double)(mp3state->samples),
+              (double)(end_s),1,0,
+              SPLT_DEFAULT_PROGRESS_RATE);
+        }
+
+        int mad_err = SPLT_OK;
+        switch (splt_mp3_get_valid_frame(state, &mad_err))
+        {
+          case 1:
+            splt_mp3_count_samples(mp3state);
+            mp3state->frames++;
+            break;
+          case 0:
+            break;
+          case -1:
+            eof = 1;
+            *error = SPLT_OK_SPLIT_EOF;
+            break;
+          case -3:
+            //error from libmad
+            *error = mad_err;
+            goto bloc_end;
+            break;
+          default:
+            break;
+        }
+
+      } while (!finished);
+    }
+    //if we don't have the framemode
+    else
+    {
+      splt_u_print_debug(state,"Starting mp3 not seekable non frame mode...",0,NULL);
+
+      off_t begin = 0, end = 0;
+      if (fend_sec_is_not_eof)
+      {
+        end = (off_t) (fend_sec * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
+      }
+      else
+      {
+        end = -1;
+      }
+
+      //find begin point because no 'end' saved point
+      if (mp3state->end == 0)
+      {
+        begin = (off_t) (fbegin_sec * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
+
+        if ((mp3state->bytes == begin) && (mp3state->data_len > 0))
+        {
+          wrote += splt_mp3_write_data_ptr(state, filename, output_fname, file_output, error);
+          if (*error < 0) { goto bloc_end; }
+        }
+        else
+        {
+          while (mp3state->bytes < begin)
+          {
+            off_t to_read;
+            if (splt_mp3_input_eof(mp3state))
+            {
+              *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
+              goto bloc_end;
+            }
+            to_read = (begin - mp3state->bytes);
+            if (to_read > SPLT_MAD_BSIZE)
+              to_read = SPLT_MAD_BSIZE;
+            if ((mp3state->data_len = splt_mp3_read_input(mp3state, mp3state->inputBuffer, to_read))<=0)
+            {
+              *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
+              goto bloc_end;
+            }
+            mp3state->bytes+=mp3state->data_len;
+
+            if (splt_t_split_is_canceled(state))
+            {
+              *error = SPLT_SPLIT_CANCELLED;
+              goto bloc_end;
+            }
+          }
+
+          int mad_err = SPLT_OK;
+          splt_mp3_init_stream_frame(mp3state);
+          switch (splt_mp3_get_valid_frame(state, &mad_err))
+          {
+            case 1:
+              len = (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
+              if (len < 0)
+              {
+                splt_t_set_error_data(state,filename);
+                *error = SPLT_ERROR_WHILE_READING_FILE;
+                goto bloc_end;
+              }
+              if (splt_u_fwrite(state, mp3state->data_ptr, 1, len, file_output) < len)
+              {
+                splt_t_set_error_data(state,output_fname);
+                *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+                goto bloc_end;
+              }
+              wrote = (off_t) (wrote + len);
+              mp3state->data_len = 0;
+              break;
+            case 0:
+              break;
+            case -1:
+              eof = 1;
+              *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
+              break;
+            case -3:
+              //error from libmad
+              *error = mad_err;
+              goto bloc_end;
+              break;
+            default:
+              break;
+          }
+        }
+      }
+      //set the 'begin' as the saved 'end'
+      else
+      {
+        len = (long) (mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr);
+        if (len < 0)
+        {
+          splt_t_set_error_data(state,filename);
+          *error = SPLT_ERROR_WHILE_READING_FILE;
+          goto bloc_end;
+        }
+        if (splt_u_fwrite(state, mp3state->data_ptr, 1, len, file_output) < len)
+        {
+          splt_t_set_error_data(state,output_fname);
+          *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+          goto bloc_end;
+        }
+        wrote = (off_t) (wrote + len);
+        mp3state->data_len = 0;
+        begin = mp3state->end;
+      }
+
+      long split_begin_point = mp3state->bytes;
+      //while not end of file, read write:
+      while (!eof)
+      {
+        off_t to_read = SPLT_MAD_BSIZE;
+        if (end > 0)
+        {
+          to_read = (end - mp3state->bytes);
+          if (to_read <= 0)
+          {
+            break;
+          }
+          if (to_read > SPLT_MAD_BSIZE)
+            to_read = SPLT_MAD_BSIZE;
+        }
+
+        if (splt_mp3_input_eof(mp3state) || 
+            ((mp3state->data_len = 
+              splt_mp3_read_input(mp3state, mp3state->inputBuffer, to_read))<=0))
+        {
+          eof = 1;
+          *error = SPLT_OK_SPLIT_EOF;
+          break;
+        }
+
+        if (splt_u_fwrite(state, mp3state->inputBuffer, 1,
+              mp3state->data_len, file_output) < mp3state->data_len)
+        {
+          splt_t_set_error_data(state,output_fname);
+          *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+          goto bloc_end;
+        }
+
+        mp3state->bytes += mp3state->data_len;
+
+        if (splt_t_split_is_canceled(state))
+        {
+          *error = SPLT_SPLIT_CANCELLED;
+          goto bloc_end;
+        }
+
+        splt_t_update_progress(state, (double) (mp3state->bytes-split_begin_point),
+            (double)(end-split_begin_point), 1,0,SPLT_DEFAULT_PROGRESS_RATE);
+      }
+
+      splt_mp3_save_end_point(state, mp3state, save_end_point, end);
+
+      if (!eof)
+      {
+        //take the whole last frame : might result in more frames
+        //but if we don't do it, we might have less frames
+        int mad_err = SPLT_OK;
+        splt_mp3_init_stream_frame(mp3state);
+        switch (splt_mp3_get_valid_frame(state, &mad_err))
+        {
+          case 1:
+            len = (long) (mp3state->data_ptr - mp3state->inputBuffer);
+            if (len < 0)
+            {
+              splt_t_set_error_data(state,filename);
+              *error = SPLT_ERROR_WHILE_READING_FILE;
+              goto bloc_end;
+            }
+            if (splt_u_fwrite(state, mp3state->inputBuffer, 1, len, file_output) < len)
+            {
+              splt_t_set_error_data(state,output_fname);
+              *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+              goto bloc_end;
+            }
+            break;
+          case 0:
+            break;
+          case -1:
+            eof = 1;
+            *error = SPLT_OK_SPLIT_EOF;
+            break;
+          case -3:
+            *error = mad_err;
+            goto bloc_end;
+            break;
+          default:
+            break;
+        }
+      }
+    }
+
+    //we write id3 and other stuff
+    if (file_output)
+    {
+      //the data written behind the split must be written before seeking
+      if (splt_wb_flush(state, file_output) != 0)
+      {
+        splt_t_set_strerror_msg(state);
+        splt_t_set_error_data(state, output_fname);
+        *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+        goto bloc_end;
+      }
+
+      if (mp3state->mp3file.xing > 0)
+      {
+        if (fseeko(file_output, mp3state->mp3file.xing_offset+4+id3v2_end_offset, SEEK_SET)!=-1)
+        {
+          unsigned long headw = (unsigned long) (mp3state->frames - fbegin + 1); // Frames
+          fputc((headw >> 24) & 0xFF, file_output);
+          fputc((headw >> 16) & 0xFF, file_output);
+          fputc((headw >> 8) & 0xFF, file_output);
+          fputc((headw >> 0) & 0xFF, file_output);
+          headw = (unsigned long) (wrote); // Bytes
+          fputc((headw >> 24) & 0xFF, file_output);
+          fputc((headw >> 16) & 0xFF, file_output);
+          fputc((headw >> 8) & 0xFF, file_output);
+          fputc((headw >> 0) & 0xFF, file_output);
+        }
+        else
+        {
+          splt_t_set_strerror_msg(state);
+          splt_t_set_error_data(state, output_fname);
+          *error = SPLT_ERROR_SEEKING_FILE;
+          goto bloc_end;
+        }
+      }
+
+      //write id3 tags version 1 at the end of the file
+      if (output_tags_version == 1 || output_tags_version == 12)
+      {
+        int err = SPLT_OK;
+        if ((err = splt_mp3_write_id3v1_tags(state, file_output, output_fname)) < 0)
+        {
+          *error = err;
+          goto bloc_end;
+        }
+      }
+    }
+
+bloc_end:
+    if (file_output)
+    {
+      if (splt_u_fclose_output(state, file_output) != 0)
+      {
+        splt_t_set_strerror_msg(state);
+        splt_t_set_error_data(state, output_fname);
+        *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+      }
+    }
+    file_output = NULL;
+
+    if (*error == SPLT_OK) { *error = SPLT_OK_SPLIT; }
+
+    return sec_end_time;
+  }
+  //if seekable:
+  else
+  {
+    short write_first_frame = SPLT_FALSE;
+    off_t begin = 0, end = 0;
+
+    phase = splt_st_enter_phase(state, SPLT_PHASE_CUTPOINT_SEARCH);
+    //if framemode
+    if (mp3state->framemode)
+    {
+      splt_u_print_debug(state,"Starting seekable mp3 frame mode...",0,NULL);
+
+      unsigned long fbegin, fend, adjust;
+      fbegin = fend = adjust = 0;
+      //prefer to split a bit before the start than loosing some frame
+      //so we don't 'ceilf'
+      fbegin = fbegin_sec * mp3state->mp3file.fps;
+
+      if (fend_sec_is_not_eof)
+      {
+        //if adjustoption
+        if (adjustoption)
+        {
+          if (fend_sec_is_not_eof)
+          {
+            float adj = (float) (adjustoption);
+            float len = (fend_sec - fbegin_sec);
+            if (adj > len)
+            {
+              adj = len;
+            }
+            if (fend_sec > adj)
+            {
+              fend_sec -= adj;
+            }
+            adjust = (unsigned long) (adj * 100.f);
+          }
+          else 
+          {
+            adjust = 0;
+          }
+        }
+        //prefer to split a bit after the end than loosing some frame
+        //before the end
+        fend = (unsigned long) ceilf(fend_sec * mp3state->mp3file.fps);
+      }
+      else 
+      {
+        fend = 0xFFFFFFFF;
+      }
+
+      splt_u_print_debug(state,"Finding begin...",0,NULL);
+
+      if (mp3state->end == 0)
+      {
+        if (mp3state->first)
+        {
+          mp3state->h.ptr = mp3state->mp3file.firsthead.ptr;
+          mp3state->h.framesize = mp3state->mp3file.firsthead.framesize;
+          begin = mp3state->mp3file.firsthead.ptr;
+          mp3state->first = 0;
+        }
+
+        splt_t_put_progress_text(state,SPLT_PROGRESS_PREPARE);
+
+        // Finds begin by counting frames
+        while (mp3state->frames < fbegin)
+        {
+          begin = splt_mp3_findhead(mp3state, mp3state->h.ptr + mp3state->h.framesize);
+          if (begin == -1) { *error = SPLT_ERROR_BEGIN_OUT_OF_FILE; goto bloc_end2; }
+
+          //count the number of syncerrors
+          if ((begin!=mp3state->h.ptr + mp3state->h.framesize)&&(state->syncerrors>=0)) 
+          {
+            state->syncerrors++;
+            state->stats.sync_errors++;
+          }
+          if ((mp3state->syncdetect)&&(state->syncerrors> SPLT_MAXSYNC))
+          {
+            splt_mp3_checksync(mp3state);
+          }
+
+          mp3state->h = splt_mp3_makehead(mp3state, mp3state->headw, mp3state->h, begin);
+          mp3state->frames++;
+
+          if (splt_t_split_is_canceled(state))
+          {
+            *error = SPLT_SPLIT_CANCELLED;
+            goto bloc_end2;
+          }
+
+          //if we have adjust mode, then put only 25%
+          //else put 50%
+          if (adjustoption)
+          {
+            splt_t_update_progress(state,(double)(mp3state->frames),
+                (double)fend, 8,
+                0,SPLT_DEFAULT_PROGRESS_RATE);
+          }
+          else
+          {
+            splt_t_update_progress(state,(double)(mp3state->frames),
+                (double)fend,progress_adjust_val,
+                0,SPLT_DEFAULT_PROGRESS_RATE);
+          }
+        }
+      }
+      else
+      {
+        begin = mp3state->end;
+      }
+
+      splt_u_print_debug(state,"Begin is...",begin,NULL);
+
+      if (mp3state->mp3file.len > 0)
+      {
+        if (begin >= mp3state->mp3file.len) // If we can check, we just do that :)
+        {
+          *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
+          goto bloc_end2;
+        }
+      }
+
+      splt_t_put_progress_text(state,SPLT_PROGRESS_PREPARE);
+
+      long int frames_begin = mp3state->frames;
+      // Finds end by counting frames
+      while (mp3state->frames <= fend)
+      {
+        mp3state->frames++;
+        end = splt_mp3_findhead(mp3state, mp3state->h.ptr + mp3state->h.framesize);
+        if (end == -1)
+        {
+          end = mp3state->h.ptr + mp3state->h.framesize; // Last valid offset
+          eof=1;
+          *error = SPLT_OK_SPLIT_EOF;
+          break;
+        }
+
+        //count the number of syncerrors
+        if ((end != mp3state->h.ptr + mp3state->h.framesize)&&(state->syncerrors>=0))
+        {
+          state->syncerrors++;
+          state->stats.sync_errors++;
+        }
+        if ((mp3state->syncdetect)&&(state->syncerrors>SPLT_MAXSYNC))
+        {
+          splt_mp3_checksync(mp3state);
+        }
+
+        mp3state->h = splt_mp3_makehead(mp3state, mp3state->headw, mp3state->h, end);
+
+        if (splt_t_split_is_canceled(state))
+        {
+          *error = SPLT_SPLIT_CANCELLED;
+          goto bloc_end2;
+        }
+
+        //if we have a progress callback function
+        //time split only calculates the end of the 
+        //split
+        int split_mode = splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+        if (((split_mode == SPLT_OPTION_TIME_MODE) || 
+              (split_mode == SPLT_OPTION_SILENCE_MODE))
+            && (!splt_t_get_int_option(state,SPLT_OPT_AUTO_ADJUST)))
+        {
+          splt_t_update_progress(state, (double)(mp3state->frames-fbegin),
+              (double)(fend-fbegin), progress_adjust_val,
+              0, SPLT_DEFAULT_PROGRESS_RATE);
+        }
+        else
+        {
+          if (adjustoption)
+          {
+            if(adjust)
+            {
+              if (split_mode == SPLT_OPTION_TIME_MODE)
+              {
+                splt_t_update_progress(state,
+                    (double)(mp3state->frames-frames_begin),
+                    (double)(fend-frames_begin),
+                    4,0,SPLT_DEFAULT_PROGRESS_RATE);
+              }
+              else
+              {
+                splt_t_update_progress(state,
+                    (double)(mp3state->frames-frames_begin),
+                    (double)(fend-frames_begin),
+                    8,1/(float)8,SPLT_DEFAULT_PROGRESS_RATE);
+              }
+            }
+          }
+          else
+          {
+            splt_t_update_progress(state,
+                (double)(mp3state->frames-stopped_frames),
+                (double)(fend-stopped_frames),
+                progress_adjust_val,
+                0,SPLT_DEFAULT_PROGRESS_RATE);
+          }
+        }
+
+        //if adjust option, scans for silence
+        if ((adjust) && (mp3state->frames >= fend))
+        {
+          int scan_phase = splt_st_enter_phase(state, SPLT_PHASE_SILENCE_SCAN);
+          int silence_points_found =
+            splt_mp3_scan_silence(state, end, 2 * adjust, threshold, 0.f, 0, error);
+          splt_st_leave_phase(state, scan_phase);
+          //if error, go out
+          if (silence_points_found == -1)
+          {
+            goto bloc_end2;
+          }
+          else if (silence_points_found > 0)
+          {
+            int longest = splt_t_ssplit_get_longest(&state->silence_list);
+            adjust = (unsigned long) (splt_u_silence_position(&state->silence_list,
+                  longest, mp3state->off) 
+                * mp3state->mp3file.fps);
+          }
+          else
+          {
+            adjust = (unsigned long) (adjustoption * mp3state->mp3file.fps);
+          }
+          fend += adjust;
+          end = splt_mp3_findhead(mp3state, end);
+
+          sec_end_time = mp3state->frames / mp3state->mp3file.fps;
+
+          splt_t_ssplit_free(&state->silence_list);
+          adjust=0;
+          //progress
           splt_t_put_progress_text(state,SPLT_PROGRESS_PREPARE);
           stopped_frames = mp3state->frames;
         }
       }
 
-      splt_mp3_save_end_point(state, mp3state, save_end_point, end);
+      splt_mp3_save_end_point(state, mp3state, save_end_point, end);
+
+      //if xing, we get xing
+      if (mp3state->mp3file.xing > 0)
+      {
+        unsigned long headw;
+        headw = (unsigned long) (mp3state->frames - fbegin + 1); // Frames
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+4] = (headw >> 24) & 0xFF;
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+5] = (headw >> 16) & 0xFF;
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+6] = (headw >> 8) & 0xFF;
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+7] = headw  & 0xFF;
+        //we put the length of the file if end is -1
+        if (end == -1)
+        {
+          end = mp3state->mp3file.len;
+        }
+        headw = (unsigned long) (end - begin + mp3state->mp3file.xing); // Bytes
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+8] = (headw >> 24) & 0xFF;
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+9] = (headw >> 16) & 0xFF;
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+10] = (headw >> 8) & 0xFF;
+        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+11] = headw  & 0xFF;
+      }
+    }
+    else
+    //if not framemode
+    {
+      splt_u_print_debug(state,"Starting mp3 seekable non frame mode...",0,NULL);
+
+      long first_frame_offset = mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr;
+      short from_index = SPLT_FALSE;
+
+      //find begin point if the last 'end' not saved
+      if (mp3state->end == 0) 
+      {
+        begin = splt_mp3_seconds_to_offset(state, fbegin_sec, &from_index, error);
+        if (*error < 0) { goto bloc_end2; }
+
+        if ((mp3state->bytes == begin) && (mp3state->data_len > 0))
+        {
+          write_first_frame = SPLT_TRUE;
+          begin += first_frame_offset;
+        }
+        else
+        {
+          begin = splt_mp3_findvalidhead(mp3state, begin);
+        }
+
+        if (begin == -1)
+        {
+          *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
+          goto bloc_end2;
+        }
+        if (!from_index &&
+            (splt_mp3_head_entry(mp3state, mp3state->headw)->bitrate != 
+             mp3state->mp3file.firsthead.bitrate))
+        {
+          check_bitrate = 1;
+        }
+      }
+      //set the begin point from the last 'end' saved
+      else 
+      {
+        begin = mp3state->end;
+      }
+
+      if (fend_sec_is_not_eof)
+      {
+        end = splt_mp3_seconds_to_offset(state, fend_sec, &from_index, error);
+        if (*error < 0) { goto bloc_end2; }
+        if (write_first_frame && !from_index)
+        {
+          end += first_frame_offset;
+        }
+        //take the whole last frame : might result in more frames
+        //but if we don't do it, we might have less frames
+        end = splt_mp3_findvalidhead(mp3state, end);
+        if (!from_index &&
+            (splt_mp3_head_entry(mp3state, mp3state->headw)->bitrate != 
+             mp3state->mp3file.firsthead.bitrate))
+          check_bitrate = 1;
+      }
+      else
+      {
+        end = -1;
+      }
+
+      splt_mp3_save_end_point(state, mp3state, save_end_point, end);
+    }
+
+    splt_st_leave_phase(state, phase);
+
+    //seekable real split
+    int err = splt_mp3_simple_split(state, output_fname, begin, end,
+        SPLT_TRUE, write_first_frame);
+    if (err < 0) { *error = err; }
+
+    if (!save_end_point)
+    {
+      if (splt_t_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0)
+      {
+        mp3state->frames = 1;
+        mp3state->first = 1;
+      }
+    }
+  }
+
+  if (check_bitrate)
+  {
+    *error = SPLT_MIGHT_BE_VBR;
+  }
+
+  if (*error == SPLT_OK) { *error = SPLT_OK_SPLIT; }
+
+bloc_end2:
+  //if we jumped out of the cutpoint search
+  splt_st_leave_phase(state, phase);
+
+  return sec_end_time;
+}
+
+/****************************/
+/* mp3 streaming silence split */
+
+static int splt_mp3_pending_init(struct splt_mp3_pending *pending, long slots)
+{
+  memset(pending, 0x0, sizeof(struct splt_mp3_pending));
+
+  pending->slots = slots;
+  pending->size = slots * SPLT_MP3_MAX_FRAMESIZE;
+  pending->data = splt_u_malloc(sizeof(unsigned char) * pending->size);
+  pending->time = splt_u_malloc(sizeof(double) * slots);
+  pending->length = splt_u_malloc(sizeof(long) * slots);
+  if (!pending->data || !pending->time || !pending->length)
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+static void splt_mp3_pending_free(struct splt_mp3_pending *pending)
+{
+  if (pending->data)
+  {
+    free(pending->data);
+    pending->data = NULL;
+  }
+  if (pending->time)
+  {
+    free(pending->time);
+    pending->time = NULL;
+  }
+  if (pending->length)
+  {
+    free(pending->length);
+    pending->length = NULL;
+  }
+}
+
+//removes the first pending frame, writing it to 'file_output' if not NULL
+//returns the end time of the frame
+static double splt_mp3_pending_pop(splt_state *state,
+    struct splt_mp3_pending *pending, FILE *file_output,
+    const char *output_fname, int *error)
+{
+  double time = pending->time[pending->first];
+  long length = pending->length[pending->first];
+
+  if (file_output)
+  {
+    long first_part = length;
+    if (pending->start + first_part > pending->size)
+    {
+      first_part = pending->size - pending->start;
+    }
+
+    if ((splt_u_fwrite(state, pending->data + pending->start, 1,
+            first_part, file_output) < first_part) ||
+        (splt_u_fwrite(state, pending->data, 1,
+            length - first_part, file_output) < length - first_part))
+    {
+      splt_t_set_error_data(state, output_fname);
+      *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    }
+  }
+
+  pending->start = (pending->start + length) % pending->size;
+  pending->used -= length;
+  pending->first = (pending->first + 1) % pending->slots;
+  pending->count--;
+
+  return time;
+}
+
+//writes the pending frames ending before 'time' to 'file_output'
+//returns the end time of the last frame written, or 'flushed'
+static double splt_mp3_pending_flush(splt_state *state,
+    struct splt_mp3_pending *pending, double time, double flushed,
+    FILE *file_output, const char *output_fname, int *error)
+{
+  while ((pending->count > 0) && (pending->time[pending->first] <= time))
+  {
+    flushed = splt_mp3_pending_pop(state, pending, file_output,
+        output_fname, error);
+    if (*error < 0) { break; }
+  }
+
+  return flushed;
+}
+
+//keeps a frame; when the buffer is full, the oldest frames are written
+//to 'file_output' and can't be moved anymore to the next track
+//returns the end time of the last frame written, or 'flushed'
+static double splt_mp3_pending_push(splt_state *state,
+    struct splt_mp3_pending *pending, unsigned char *data, long length,
+    double time, double flushed, FILE *file_output, const char *output_fname,
+    int *error)
+{
+  if (length > pending->size)
+  {
+    //too big to be kept: the frame can't be cut
+    flushed = splt_mp3_pending_flush(state, pending, time, flushed,
+        file_output, output_fname, error);
+    if (*error < 0) { return flushed; }
+    if (file_output &&
+        (splt_u_fwrite(state, data, 1, length, file_output) < length))
+    {
+      splt_t_set_error_data(state, output_fname);
+      *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    }
+    return time;
+  }
+
+  while ((pending->count == pending->slots) ||
+      (pending->used + length > pending->size))
+  {
+    flushed = splt_mp3_pending_pop(state, pending, file_output,
+        output_fname, error);
+    if (*error < 0) { return flushed; }
+  }
+
+  long end = (pending->start + pending->used) % pending->size;
+  long first_part = length;
+  if (end + first_part > pending->size)
+  {
+    first_part = pending->size - end;
+  }
+  memcpy(pending->data + end, data, first_part);
+  memcpy(pending->data, data + first_part, length - first_part);
+  pending->used += length;
+
+  long slot = (pending->first + pending->count) % pending->slots;
+  pending->time[slot] = time;
+  pending->length[slot] = length;
+  pending->count++;
+
+  return flushed;
+}
+
+//opens the next track at 'begin' seconds; the track is written in a
+//'.part' file until its end is known
+//returns NULL if we pretend to split or if error
+static FILE *splt_mp3_stream_open_track(splt_state *state, double begin,
+    char **part_fname, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  FILE *file_output = NULL;
+
+  char *output_fname = splt_s_stream_track_begin(state,
+      splt_u_time_to_long(begin), error);
+  if (*error < 0) { goto function_end; }
+
+  if (splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  {
+    goto function_end;
+  }
+
+  *part_fname = splt_u_malloc(sizeof(char) * (strlen(output_fname) + 6));
+  if (*part_fname == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto function_end;
+  }
+  snprintf(*part_fname, strlen(output_fname) + 6, "%s.part", output_fname);
+
+  file_output = splt_mp3_open_file_write(state, *part_fname, 0, error);
+  if (*error < 0) { goto function_end; }
+
+#ifndef NO_ID3TAG
+  int output_tags_version = splt_mp3_get_output_tags_version(state);
+  if (output_tags_version == 2 || output_tags_version == 12)
+  {
+    int err = SPLT_OK;
+    if ((err = splt_mp3_write_id3v2_tags(state, file_output,
+            *part_fname, NULL)) < 0)
+    {
+      *error = err;
+      goto function_end;
+    }
+  }
+#endif
+
+  if (mp3state->mp3file.xing > 0)
+  {
+    if (splt_u_fwrite(state, mp3state->mp3file.xingbuffer,
+          1, mp3state->mp3file.xing, file_output) < mp3state->mp3file.xing)
+    {
+      splt_t_set_error_data(state, *part_fname);
+      *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+      goto function_end;
+    }
+  }
+
+function_end:
+  if (output_fname)
+  {
+    free(output_fname);
+    output_fname = NULL;
+  }
+
+  return file_output;
+}
+
+//ends the current track at 'end' seconds and renames its '.part' file
+static void splt_mp3_stream_close_track(splt_state *state, double end,
+    FILE *file_output, char **part_fname, int *error)
+{
+  char *output_fname = splt_s_stream_track_end(state,
+      splt_u_time_to_long(end), error);
+
+  if (file_output)
+  {
+    int output_tags_version = splt_mp3_get_output_tags_version(state);
+    if ((*error >= 0) &&
+        (output_tags_version == 1 || output_tags_version == 12))
+    {
+      int err = SPLT_OK;
+      if ((err = splt_mp3_write_id3v1_tags(state, file_output, *part_fname)) < 0)
+      {
+        *error = err;
+      }
+    }
+
+    if (splt_u_fclose_output(state, file_output) != 0)
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, *part_fname);
+      *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+    }
+
+    if ((*error >= 0) && (rename(*part_fname, output_fname) != 0))
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, output_fname);
+      *error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
+    }
+  }
+
+  if ((*error >= 0) && output_fname)
+  {
+    int err = splt_t_put_split_file(state, output_fname);
+    if (err < 0) { *error = err; }
+  }
+
+  if (*part_fname)
+  {
+    if (*error < 0)
+    {
+      remove(*part_fname);
+    }
+    free(*part_fname);
+    *part_fname = NULL;
+  }
+  if (output_fname)
+  {
+    free(output_fname);
+    output_fname = NULL;
+  }
+}
+
+//splits a non seekable input in silence mode, reading it only once:
+//the frames are written as soon as no silence can move the cut before
+//them, and the frames of a possible silence are kept in a bounded
+//buffer until the silence is found or not
+//returns the number of tracks written
+static int splt_mp3_stream_silence_split(splt_state *state, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+
+  float threshold = splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD);
+  float min_length = splt_t_get_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH);
+  float offset = splt_t_get_float_option(state, SPLT_OPT_PARAM_OFFSET);
+  int remove_silence = splt_t_get_int_option(state, SPLT_OPT_PARAM_REMOVE_SILENCE);
+
+  //the cut can't be before the frames already written, or after
+  //the frames read
+  if (offset < 0) { offset = 0; }
+  if (offset > 1) { offset = 1; }
+
+  int tracks = 0;
+  short eof = 0;
+  double time = 0, flushed = 0;
+  FILE *file_output = NULL;
+  char *part_fname = NULL;
+  splt_silence_detector detector;
+  struct splt_mp3_pending pending;
+
+  //a manifest needs byte ranges of a seekable input
+  if (splt_mf_is_enabled(state))
+  {
+    *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+    return 0;
+  }
+
+  long slots = (long) ((min_length * (1 - offset) + SPLT_MP3_STREAM_SECONDS)
+      * mp3state->mp3file.fps) + 1;
+  if (splt_mp3_pending_init(&pending, slots) == -1)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto function_end;
+  }
+
+  splt_t_put_progress_text(state, SPLT_PROGRESS_SCAN_SILENCE);
+
+  splt_en_detector_init(&detector, threshold, min_length, SPLT_TRUE);
+  splt_en_start_levels(state);
+
+  splt_mp3_init_silence_synth(state, mp3state, threshold);
+  double seconds_per_sample = 1.0 / mp3state->mp3file.freq;
+  mp3state->samples = 0;
+  mp3state->temp_level = 0.0;
+
+  file_output = splt_mp3_stream_open_track(state, 0, &part_fname, error);
+  if (*error < 0) { goto function_end; }
+  tracks++;
+
+  //the first frame has been read with the mp3 infos
+  if (mp3state->data_len > 0)
+  {
+    flushed = splt_mp3_pending_push(state, &pending, mp3state->data_ptr,
+        mp3state->data_len, 0, flushed, file_output, part_fname, error);
+    mp3state->data_len = 0;
+    if (*error < 0) { goto function_end; }
+  }
+
+  while (!eof)
+  {
+    mad_fixed_t peak = 0;
+    int mad_err = SPLT_OK;
+    switch (splt_mp3_get_valid_frame(state, &mad_err))
+    {
+      case 1:
+        splt_mp3_count_samples(mp3state);
+        state->stats.frames_decoded++;
+        mp3state->frames++;
+        time = mp3state->samples * seconds_per_sample;
+
+        peak = splt_mp3_silence_frame(state, mp3state);
+
+        flushed = splt_mp3_pending_push(state, &pending, mp3state->data_ptr,
+            mp3state->data_len, time, flushed, file_output, part_fname, error);
+        mp3state->data_len = 0;
+        if (*error < 0) { goto function_end; }
+        break;
+      case 0:
+        continue;
+      case -1:
+        eof = 1;
+        break;
+      case -3:
+        *error = mad_err;
+        goto function_end;
+      default:
+        continue;
+    }
+
+    //at the end of the input, the current silence is ended
+    if (splt_en_detector_put(state, &detector, time,
+          (float) mad_f_todouble(peak), eof, error) == -1)
+    {
+      goto function_end;
+    }
+    if (!eof)
+    {
+      splt_en_put_level(state, time,
+          (float) mad_f_todouble(mp3state->temp_level), detector.found);
+    }
+
+    //a silence has been found: the cut is final
+    if (state->silence_list.number > 0)
+    {
+      double cut_begin = 0, cut_end = 0;
+      if (remove_silence)
+      {
+        cut_begin = state->silence_list.begin_position[0];
+        cut_end = state->silence_list.end_position[0];
+      }
+      else
+      {
+        cut_begin = splt_u_silence_position(&state->silence_list, 0, offset);
+        cut_end = cut_begin;
+      }
+      splt_t_ssplit_free(&state->silence_list);
+
+      if (cut_begin < flushed) { cut_begin = flushed; }
+      if (cut_end < cut_begin) { cut_end = cut_begin; }
+
+      flushed = splt_mp3_pending_flush(state, &pending, cut_begin, flushed,
+          file_output, part_fname, error);
+      if (*error < 0) { goto function_end; }
+      splt_mp3_stream_close_track(state, cut_begin, file_output,
+          &part_fname, error);
+      file_output = NULL;
+      if (*error < 0) { goto function_end; }
+
+      //the removed silence is not written
+      flushed = splt_mp3_pending_flush(state, &pending, cut_end, flushed,
+          NULL, NULL, error);
+
+      file_output = splt_mp3_stream_open_track(state, cut_end, &part_fname, error);
+      if (*error < 0) { goto function_end; }
+      tracks++;
+    }
+    //no cut can be before the current silence
+    else if (detector.len > 0)
+    {
+      flushed = splt_mp3_pending_flush(state, &pending, detector.silence_begin,
+          flushed, file_output, part_fname, error);
+    }
+    else
+    {
+      flushed = splt_mp3_pending_flush(state, &pending, time, flushed,
+          file_output, part_fname, error);
+    }
+    if (*error < 0) { goto function_end; }
+
+    if (splt_t_split_is_canceled(state))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
+      goto function_end;
+    }
+  }
+
+  flushed = splt_mp3_pending_flush(state, &pending, time, flushed,
+      file_output, part_fname, error);
+  if (*error < 0) { goto function_end; }
+
+  splt_en_end_levels(state, detector.found);
+
+  splt_mp3_stream_close_track(state, time, file_output, &part_fname, error);
+  file_output = NULL;
+
+function_end:
+  if (file_output)
+  {
+    splt_u_fclose_output(state, file_output);
+    file_output = NULL;
+  }
+  if (part_fname)
+  {
+    remove(part_fname);
+    free(part_fname);
+    part_fname = NULL;
+  }
+  splt_t_ssplit_free(&state->silence_list);
+  splt_mp3_pending_free(&pending);
+  splt_mp3_finish_silence_synth(mp3state);
+
+  return tracks;
+}
+
+/****************************/
+/* mp3 markers */
+
+//searches in one read of the file the first occurrence of each marker
+//starting between 'begin' and 'end'; a marker may end after 'end'
+//-returns the offset where the search stopped (before 'end' if all
+//the markers were found or at the end of the file), -1 on error
+static off_t splt_mp3_find_markers(splt_stats *stats, FILE *in,
+    off_t begin, off_t end, struct splt_mp3_marker *markers, int number)
+{
+  unsigned char buffer[SPLT_MP3_MARKER_BUFFER_SIZE + SPLT_MP3_MARKER_MAX_LENGTH];
+  size_t have = 0;
+  off_t position = begin;
+  int i, remaining = number;
+
+  for (i = 0;i < number;i++)
+  {
+    markers[i].offset = -1;
+  }
+
+  if (fseeko(in, begin, SEEK_SET) == -1)
+  {
+    return -1;
+  }
+
+  while ((position < end) && (remaining > 0))
+  {
+    size_t starts = SPLT_MP3_MARKER_BUFFER_SIZE;
+    if ((off_t) starts > end - position)
+    {
+      starts = (size_t) (end - position);
+    }
+
+    //the bytes of the markers starting in this block
+    size_t wanted = starts + SPLT_MP3_MARKER_MAX_LENGTH - 1;
+    if (have < wanted)
+    {
+      size_t len = fread(buffer + have, 1, wanted - have, in);
+      stats->bytes_read += len;
+      have += len;
+    }
+
+    short eof = (have < wanted);
+    if (eof && (starts > have))
+    {
+      starts = have;
+    }
+
+    for (i = 0;i < number;i++)
+    {
+      struct splt_mp3_marker *marker = &markers[i];
+      if ((marker->offset != -1) || (have < (size_t) marker->length))
+      {
+        continue;
+      }
+
+      size_t limit = have - marker->length + 1;
+      if (limit > starts)
+      {
+        limit = starts;
+      }
+
+      const unsigned char *ptr = buffer;
+      const unsigned char *last = buffer + limit;
+      while ((ptr < last) &&
+          (ptr = memchr(ptr, marker->pattern[0], last - ptr)) != NULL)
+      {
+        if (memcmp(ptr, marker->pattern, marker->length) == 0)
+        {
+          marker->offset = position + (ptr - buffer);
+          remaining--;
+          break;
+        }
+        ptr++;
+      }
+    }
+
+    position += starts;
+    if (eof)
+    {
+      break;
+    }
+
+    have -= starts;
+    memmove(buffer, buffer + starts, have);
+  }
+
+  return position;
+}
+
+/****************************/
+/* mp3 syncerror */
+
+//this function is searching for the id3v1 and id3v2 and returns the offset
+static off_t splt_mp3_adjustsync(splt_mp3_state *mp3state, splt_stats *stats,
+    off_t begin, off_t end)
+{
+  struct splt_mp3_marker markers[2] = {
+    { "TAG", 3, -1 },
+    { "ID3", 3, -1 }
+  };
+
+  if (splt_mp3_find_markers(stats, mp3state->file_input,
+        begin, end, markers, 2) == -1)
+  {
+    return (off_t) (-1);
+  }
+
+  //the end of an ID3v1 first
+  if (markers[0].offset != -1)
+  {
+    return markers[0].offset + 128;
+  }
+
+  //then the beginning of an ID3v2
+  if (markers[1].offset != -1)
+  {
+    return markers[1].offset;
+  }
+
+  return end;
+}
+
+//follows the chain of headers by one frame: 'mp3state->h' becomes the
+//next header, and the sync error point found before it is put in
+//'*point' (-1 if none)
+//-returns the offset of the next header, -1 at the end of the file or
+//on error
+static off_t splt_mp3_sync_step(splt_mp3_state *mp3state, splt_stats *stats,
+    off_t *point, int *error)
+{
+  off_t offset;
+
+  *point = -1;
+
+  offset = splt_mp3_findhead(mp3state, mp3state->h.ptr + mp3state->h.framesize);
+  if (offset == -1)
+  {
+    return -1;
+  }
+
+  if (offset != mp3state->h.ptr + mp3state->h.framesize)
+  {
+    *point = splt_mp3_adjustsync(mp3state, stats, mp3state->h.ptr, offset);
+    offset = splt_mp3_findvalidhead(mp3state, *point);
+    if (splt_u_getword(mp3state->file_input, offset, SEEK_SET, &mp3state->headw) == -1)
+    {
+      *error = SPLT_ERR_SYNC;
+      return -1;
+    }
+  }
+
+  mp3state->h = splt_mp3_makehead(mp3state, mp3state->headw, mp3state->h, offset);
+
+  return offset;
+}
+
+//follows the chain of headers of the input file by one frame and puts
+//the sync error found in the syncerror splitpoints
+//-returns SPLT_FALSE at the end of the file or on error
+static short splt_mp3_sync_next(splt_state *state, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  off_t point = -1;
+  int err = SPLT_OK;
+
+  off_t offset = splt_mp3_sync_step(mp3state, &state->stats, &point, &err);
+  if (point != -1)
+  {
+    int sync_err = splt_t_serrors_append_point(state, point);
+    if (sync_err != SPLT_OK)
+    {
+      *error = sync_err;
+      return SPLT_FALSE;
+    }
+  }
+  if (err < 0)
+  {
+    *error = err;
+    return SPLT_FALSE;
+  }
+  if (offset == -1)
+  {
+    return SPLT_FALSE;
+  }
+
+  if (splt_t_split_is_canceled(state))
+  {
+    *error = SPLT_SPLIT_CANCELLED;
+    return SPLT_FALSE;
+  }
+
+  return SPLT_TRUE;
+}
+
+#ifndef __WIN32__
+
+//a part of the file searched for sync errors by a thread
+struct splt_mp3_sync_part {
+  splt_state *state;
+  //copy of the mp3 state reading its own file
+  splt_mp3_state mp3state;
+  splt_stats stats;
+  //the chain starts at the first valid header after 'begin' and stops
+  //at the first header after 'end' (-1 for the last part)
+  off_t begin;
+  off_t end;
+  short first;
+  //the first headers of the chain, to join the chain of the previous part
+  off_t heads[SPLT_MP3_SYNC_JOIN_HEADERS];
+  long heads_num;
+  //the sync errors found, with the number of headers before each of them
+  off_t *points;
+  unsigned long *points_at;
+  long points_num;
+  long points_alloc;
+  unsigned long frames;
+  //the header where the chain stopped
+  struct splt_header last;
+  short eof;
+  int error;
+  pthread_t thread;
+  //resources used by the thread, zero if the part was searched
+  //without a thread
+  splt_thread_usage usage;
+};
+
+static int splt_mp3_sync_part_append(struct splt_mp3_sync_part *part,
+    off_t point)
+{
+  if (part->points_num == part->points_alloc)
+  {
+    long alloc = part->points_alloc ? part->points_alloc * 2 : SPLT_SERRORS_ALLOC;
+    off_t *points = splt_u_realloc(part->points, sizeof(off_t) * alloc);
+    if (points == NULL)
+    {
+      return -1;
+    }
+    part->points = points;
+
+    unsigned long *points_at =
+      splt_u_realloc(part->points_at, sizeof(unsigned long) * alloc);
+    if (points_at == NULL)
+    {
+      return -1;
+    }
+    part->points_at = points_at;
+    part->points_alloc = alloc;
+  }
+
+  part->points[part->points_num] = point;
+  part->points_at[part->points_num] = part->frames;
+  part->points_num++;
+
+  return 0;
+}
+
+//follows the chain of headers of one part of the file
+static void splt_mp3_sync_part_search(struct splt_mp3_sync_part *part)
+{
+  splt_mp3_state *mp3state = &part->mp3state;
+
+  if (!part->first)
+  {
+    off_t offset = splt_mp3_findvalidhead(mp3state, part->begin);
+    if (offset == -1)
+    {
+      part->eof = SPLT_TRUE;
+      return;
+    }
+    if (splt_u_getword(mp3state->file_input, offset, SEEK_SET, &mp3state->headw) == -1)
+    {
+      part->error = SPLT_ERR_SYNC;
+      return;
+    }
+    mp3state->h = splt_mp3_makehead(mp3state, mp3state->headw, mp3state->h, offset);
+  }
+
+  while ((part->end == -1) || (mp3state->h.ptr < part->end))
+  {
+    off_t point = -1;
+
+    if (part->frames < SPLT_MP3_SYNC_JOIN_HEADERS)
+    {
+      part->heads[part->frames] = mp3state->h.ptr;
+      part->heads_num = part->frames + 1;
+    }
+
+    off_t offset = splt_mp3_sync_step(mp3state, &part->stats, &point, &part->error);
+    if ((point != -1) && (splt_mp3_sync_part_append(part, point) == -1))
+    {
+      part->error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      return;
+    }
+    if (part->error < 0)
+    {
+      return;
+    }
+    if (offset == -1)
+    {
+      part->eof = SPLT_TRUE;
+      break;
+    }
+    part->frames++;
+
+    if (splt_t_split_is_canceled(part->state))
+    {
+      part->error = SPLT_SPLIT_CANCELLED;
+      return;
+    }
+  }
+
+  part->last = mp3state->h;
+}
+
+static void *splt_mp3_sync_part_thread(void *data)
+{
+  struct splt_mp3_sync_part *part = data;
+
+  splt_mp3_sync_part_search(part);
+  splt_st_get_thread_usage(&part->usage);
+
+  return NULL;
+}
+
+//number of parts the file is searched in, 1 for a sequential search
+static int splt_mp3_sync_parts_number(off_t size)
+{
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  long parts = (long) (size / SPLT_MP3_SYNC_PART_MIN_SIZE);
+
+  if (parts > cpus)
+  {
+    parts = cpus;
+  }
+  if (parts > SPLT_MP3_SYNC_MAX_PARTS)
+  {
+    parts = SPLT_MP3_SYNC_MAX_PARTS;
+  }
+  if (parts < 1)
+  {
+    parts = 1;
+  }
+
+  return (int) parts;
+}
+
+//puts the sync errors of the parts in the syncerror splitpoints: the
+//chain of the input file is followed from the end of a part until it
+//joins the chain of the next part, so that the result is the same as
+//the one of a sequential search
+static void splt_mp3_sync_join_parts(splt_state *state,
+    struct splt_mp3_sync_part *parts, int number, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  int i;
+  long j;
+
+  for (i = 0;i < number;i++)
+  {
+    struct splt_mp3_sync_part *part = &parts[i];
+    long k = 0;
+    short joined = part->first;
+
+    //the first part starts with the first header of the file
+    while (!joined && ((part->end == -1) || (mp3state->h.ptr < part->end)))
+    {
+      while ((k < part->heads_num) && (part->heads[k] < mp3state->h.ptr))
+      {
+        k++;
+      }
+      if ((k < part->heads_num) && (part->heads[k] == mp3state->h.ptr))
+      {
+        joined = SPLT_TRUE;
+        break;
+      }
+
+      if (!splt_mp3_sync_next(state, error))
+      {
+        return;
+      }
+    }
+
+    if (!joined)
+    {
+      continue;
+    }
+
+    for (j = 0;j < part->points_num;j++)
+    {
+      if (part->points_at[j] >= (unsigned long) k)
+      {
+        int sync_err = splt_t_serrors_append_point(state, part->points[j]);
+        if (sync_err != SPLT_OK)
+        {
+          *error = sync_err;
+          return;
+        }
+      }
+    }
+
+    if (part->error < 0)
+    {
+      *error = part->error;
+      return;
+    }
+    if (part->eof)
+    {
+      return;
+    }
+
+    mp3state->h = part->last;
+  }
+}
+
+//searches the sync errors with one thread for each part of the file
+static void splt_mp3_sync_parallel(splt_state *state, int number,
+    off_t st_size, int *error)
+{
+  splt_mp3_state *mp3state = state->codec;
+  char *filename = splt_t_get_filename_to_split(state);
+  int i, started = 0;
+
+  struct splt_mp3_sync_part *parts =
+    splt_u_malloc(sizeof(struct splt_mp3_sync_part) * number);
+  if (parts == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return;
+  }
+
+  off_t first = mp3state->h.ptr;
+  off_t size = (st_size - first) / number;
+
+  for (i = 0;i < number;i++)
+  {
+    struct splt_mp3_sync_part *part = &parts[i];
+    memset(part, 0x0, sizeof(struct splt_mp3_sync_part));
+    part->state = state;
+    part->mp3state = *mp3state;
+    part->first = (i == 0);
+    part->begin = first + i * size;
+    part->end = (i == number - 1) ? -1 : first + (i + 1) * size;
+
+    if ((part->mp3state.file_input = splt_u_fopen(filename, "rb")) == NULL)
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, filename);
+      *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+      goto function_end;
+    }
+    started++;
+
+    //without a thread, we search the part now
+    if (pthread_create(&part->thread, NULL, splt_mp3_sync_part_thread, part) != 0)
+    {
+      part->thread = pthread_self();
+      splt_mp3_sync_part_search(part);
+    }
+  }
+
+function_end:
+  for (i = 0;i < started;i++)
+  {
+    struct splt_mp3_sync_part *part = &parts[i];
+    if (!pthread_equal(part->thread, pthread_self()))
+    {
+      pthread_join(part->thread, NULL);
+    }
 
-      //if xing, we get xing
-      if (mp3state->mp3file.xing > 0)
-      {
-        unsigned long headw;
-        headw = (unsigned long) (mp3state->frames - fbegin + 1); // Frames
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+4] = (headw >> 24) & 0xFF;
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+5] = (headw >> 16) & 0xFF;
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+6] = (headw >> 8) & 0xFF;
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+7] = headw  & 0xFF;
-        //we put the length of the file if end is -1
-        if (end == -1)
-        {
-          end = mp3state->mp3file.len;
-        }
-        headw = (unsigned long) (end - begin + mp3state->mp3file.xing); // Bytes
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+8] = (headw >> 24) & 0xFF;
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+9] = (headw >> 16) & 0xFF;
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+10] = (headw >> 8) & 0xFF;
-        mp3state->mp3file.xingbuffer[mp3state->mp3file.xing_offset+11] = headw  & 0xFF;
-      }
+    splt_t_update_progress(state, (double) (i + 1), (double) number, 1, 0,
+        SPLT_DEFAULT_PROGRESS_RATE);
+
+    if ((part->error == SPLT_SPLIT_CANCELLED) && (*error >= 0))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
     }
-    else
-    //if not framemode
+  }
+
+  if (*error >= 0)
+  {
+    splt_mp3_sync_join_parts(state, parts, number, error);
+  }
+
+  for (i = 0;i < started;i++)
+  {
+    struct splt_mp3_sync_part *part = &parts[i];
+    fclose(part->mp3state.file_input);
+    state->stats.bytes_read += part->stats.bytes_read;
+    splt_st_add_thread_usage(state, SPLT_PHASE_CUTPOINT_SEARCH,
+        &part->usage, NULL);
+    if (part->points)
     {
-      splt_u_print_debug(state,"Starting mp3 seekable non frame mode...",0,NULL);
+      free(part->points);
+    }
+    if (part->points_at)
+    {
+      free(part->points_at);
+    }
+  }
 
-      long first_frame_offset = mp3state->inputBuffer + mp3state->buf_len - mp3state->data_ptr;
+  free(parts);
+}
+#endif
 
-      //find begin point if the last 'end' not saved
-      if (mp3state->end == 0) 
-      {
-        begin = (off_t) (fbegin_sec * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
+//the function counts the number of sync error splits, 
+//and sets the offsets
+static void splt_mp3_syncerror_search(splt_state *state, int *error)
+{
+  char *filename = splt_t_get_filename_to_split(state);
+  int sync_err = SPLT_OK;
 
-        if ((mp3state->bytes == begin) && (mp3state->data_len > 0))
-        {
-          write_first_frame = SPLT_TRUE;
-          begin += first_frame_offset;
-        }
-        else
-        {
-          begin = splt_mp3_findvalidhead(mp3state, begin);
-        }
+  splt_mp3_state *mp3state = state->codec;
 
-        if (begin == -1)
-        {
-          *error = SPLT_ERROR_BEGIN_OUT_OF_FILE;
-          goto bloc_end2;
-        }
-        if (splt_mp3_tabsel_123[1 - mp3state->mp3file.mpgid][mp3state->mp3file.layer-1][splt_mp3_c_bitrate(mp3state->headw)] != 
-            mp3state->mp3file.firsthead.bitrate)
+  splt_t_put_progress_text(state,SPLT_PROGRESS_SEARCH_SYNC);
+
+  mp3state->h.ptr = mp3state->mp3file.firsthead.ptr;
+  mp3state->h.framesize = mp3state->mp3file.firsthead.framesize;
+
+  //we get the file length for the progress
+  off_t st_size;
+  if(splt_u_stat(filename, NULL, &st_size) == 0)
+  {
+    //put the start point
+    sync_err = splt_t_serrors_append_point(state, 0);
+    if (sync_err != SPLT_OK)
+    {
+      *error = sync_err;
+      return;
+    }
+
+#ifndef __WIN32__
+    int parts = splt_mp3_sync_parts_number(st_size);
+    if (parts > 1)
+    {
+      splt_mp3_sync_parallel(state, parts, st_size, error);
+      if (*error < 0) { return; }
+    }
+    else
+#endif
+    {
+      //search for sync errors and put in splitpoints
+      while (state->serrors->serrors_points_num < SPLT_MAXSYNC)
+      {
+        if (!splt_mp3_sync_next(state, error))
         {
-          check_bitrate = 1;
+          if (*error < 0) { return; }
+          break;
         }
+
+        //progress
+        splt_t_update_progress(state,(double)(mp3state->h.ptr),
+            (double)(st_size),1,0,
+            SPLT_DEFAULT_PROGRESS_RATE);
       }
-      //set the begin point from the last 'end' saved
-      else 
-      {
-        begin = mp3state->end;
-      }
+    }
+  }
+  else
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state,filename);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    return;
+  }
 
-      if (fend_sec_is_not_eof)
+  if (state->serrors->serrors_points_num == 0)
+  {
+    *error = SPLT_ERR_NO_SYNC_FOUND;
+    return;
+  }
+
+  if (state->serrors->serrors_points_num == SPLT_MAXSYNC)
+  {
+    *error = SPLT_ERR_TOO_MANY_SYNC_ERR;
+    return;
+  }
+
+  //put the end point
+  sync_err = splt_t_serrors_append_point(state, LONG_MAX);
+  if (sync_err != SPLT_OK)
+  {
+    *error = sync_err;
+    return;
+  }
+
+  *error = SPLT_SYNC_OK;
+
+  return;
+}
+
+/****************************/
+/* mp3 dewrap */
+
+static const unsigned char splt_mp3_albumwraphead[22] =
+{
+  0xa, 0x23, 0x54, 0x49, 0x54, 0x32, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x41, 0x6c, 0x62, 0x75, 0x6d, 0x57, 0x72, 0x61, 0x70,
+};
+
+/****************************/
+/* mp3 dewrap extraction */
+
+//a file extracted from a wrapped file
+struct splt_mp3_wrap_member {
+  char *filename;
+  //the file extracted, renamed to 'filename' once the crc is checked
+  char *part_filename;
+  off_t begin;
+  off_t end;
+  int error;
+  int errno_value;
+};
+
+//the files of a wrapped file extracted by threads, with the crc of
+//the wrapped file checked at the same time
+struct splt_mp3_wrap_extract {
+  splt_state *state;
+  struct splt_mp3_wrap_member *members;
+  int members_num;
+  int members_alloc;
+  //next member to extract and number of members extracted
+  int next;
+  int finished;
+  unsigned long bytes_written;
+  short check_crc;
+  off_t crc_begin;
+  off_t crc_end;
+  unsigned long crc_expected;
+  //written by the crc thread only, read after it is joined
+  int crc_error;
+  int crc_errno;
+  off_t crc_bytes_read;
+#ifndef __WIN32__
+  //resources used by the threads
+  splt_thread_usage usage;
+  //protects 'next', 'finished', 'bytes_written' and 'usage'
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+#endif
+};
+
+static void splt_mp3_wrap_extract_free(struct splt_mp3_wrap_extract *extract)
+{
+  int i;
+
+  if (extract->members)
+  {
+    for (i = 0;i < extract->members_num;i++)
+    {
+      free(extract->members[i].filename);
+      if (extract->members[i].part_filename)
       {
-        end = (off_t) (fend_sec * mp3state->mp3file.bitrate + mp3state->mp3file.firsth);
-        if (write_first_frame)
-        {
-          end += first_frame_offset;
-        }
-        //take the whole last frame : might result in more frames
-        //but if we don't do it, we might have less frames
-        end = splt_mp3_findvalidhead(mp3state, end);
-        if (splt_mp3_tabsel_123[1 - mp3state->mp3file.mpgid][mp3state->mp3file.layer-1][splt_mp3_c_bitrate(mp3state->headw)] != 
-            mp3state->mp3file.firsthead.bitrate)
-          check_bitrate = 1;
+        free(extract->members[i].part_filename);
       }
-      else
+    }
+    free(extract->members);
+    extract->members = NULL;
+  }
+  extract->members_num = 0;
+}
+
+//adds a file to extract from the wrapped file
+static int splt_mp3_wrap_extract_add(struct splt_mp3_wrap_extract *extract,
+    const char *filename, off_t begin, off_t end)
+{
+  if (extract->members_num == extract->members_alloc)
+  {
+    int alloc = extract->members_alloc ? extract->members_alloc * 2 : 16;
+    struct splt_mp3_wrap_member *members =
+      splt_u_realloc(extract->members, sizeof(struct splt_mp3_wrap_member) * alloc);
+    if (members == NULL)
+    {
+      return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    }
+    extract->members = members;
+    extract->members_alloc = alloc;
+  }
+
+  struct splt_mp3_wrap_member *member = &extract->members[extract->members_num];
+  if ((member->filename = splt_u_strdup(filename)) == NULL)
+  {
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  }
+  member->part_filename = NULL;
+  member->begin = begin;
+  member->end = end;
+  member->error = SPLT_OK;
+  member->errno_value = 0;
+  extract->members_num++;
+
+  return SPLT_OK;
+}
+
+#ifndef __WIN32__
+
+//copies the bytes from 'begin' to 'end' of 'in_fd' at the end of 'out_fd';
+//the copy is done in the kernel when possible
+//-returns the number of bytes copied, -1 on error
+static off_t splt_mp3_copy_range(splt_state *state, int in_fd, int out_fd,
+    off_t begin, off_t end)
+{
+  off_t position = begin;
+  char buffer[SPLT_MP3_READBSIZE];
+
+#ifdef __NR_copy_file_range
+  while (position < end)
+  {
+    long long in_offset = position;
+    size_t to_copy = SPLT_MP3_WRAP_COPY_SIZE;
+    if ((off_t) to_copy > end - position)
+    {
+      to_copy = (size_t) (end - position);
+    }
+
+    long copied = syscall(__NR_copy_file_range, in_fd, &in_offset,
+        out_fd, NULL, to_copy, 0);
+    if (copied == 0)
+    {
+      return position - begin;
+    }
+    if (copied < 0)
+    {
+      //not supported between these files: copy them by blocks
+      if ((errno == ENOSYS) || (errno == EXDEV) || (errno == EINVAL) ||
+          (errno == EOPNOTSUPP))
       {
-        end = -1;
+        break;
       }
+      return -1;
+    }
+    position += copied;
 
-      splt_mp3_save_end_point(state, mp3state, save_end_point, end);
+    if (splt_t_split_is_canceled(state))
+    {
+      return position - begin;
     }
+  }
+#endif
 
-    //seekable real split
-    int err = splt_mp3_simple_split(state, output_fname, begin, end,
-        SPLT_TRUE, write_first_frame);
-    if (err < 0) { *error = err; }
+  while (position < end)
+  {
+    size_t to_read = SPLT_MP3_READBSIZE;
+    if ((off_t) to_read > end - position)
+    {
+      to_read = (size_t) (end - position);
+    }
 
-    if (!save_end_point)
+    ssize_t readed = pread(in_fd, buffer, to_read, position);
+    if (readed < 0)
     {
-      if (splt_t_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0)
+      return -1;
+    }
+    if (readed == 0)
+    {
+      break;
+    }
+
+    ssize_t written = 0;
+    while (written < readed)
+    {
+      ssize_t w = write(out_fd, buffer + written, readed - written);
+      if (w < 0)
       {
-        mp3state->frames = 1;
-        mp3state->first = 1;
+        return -1;
       }
+      written += w;
+    }
+    position += readed;
+
+    if (splt_t_split_is_canceled(state))
+    {
+      break;
+    }
+  }
+
+  return position - begin;
+}
+
+//creates the file where a member is extracted; it is renamed to the
+//member filename only when the crc of the wrapped file is right, so
+//that a damaged wrapped file never replaces an existing file
+//-returns -1 on error
+static int splt_mp3_wrap_open_part(struct splt_mp3_wrap_member *member)
+{
+  size_t size = strlen(member->filename) + 16;
+  if ((member->part_filename = splt_u_malloc(size)) == NULL)
+  {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  int i = 0;
+  for (i = 0;i < 100;i++)
+  {
+    snprintf(member->part_filename, size, "%s.part%d", member->filename, i);
+    int fd = open(member->part_filename, O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if (fd != -1)
+    {
+      return fd;
     }
+    if (errno != EEXIST)
+    {
+      break;
+    }
+  }
+
+  int open_errno = errno;
+  free(member->part_filename);
+  member->part_filename = NULL;
+  errno = open_errno;
+
+  return -1;
+}
+
+//extracts one file of the wrapped file
+static void splt_mp3_wrap_extract_member(struct splt_mp3_wrap_extract *extract,
+    int in_fd, struct splt_mp3_wrap_member *member, off_t *written)
+{
+  int out_fd = splt_mp3_wrap_open_part(member);
+  if (out_fd == -1)
+  {
+    member->errno_value = errno;
+    member->error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
+    return;
+  }
+
+  *written = splt_mp3_copy_range(extract->state, in_fd, out_fd,
+      member->begin, member->end);
+  if (*written < 0)
+  {
+    member->errno_value = errno;
+    member->error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    *written = 0;
+  }
+  else if (splt_t_split_is_canceled(extract->state))
+  {
+    member->error = SPLT_SPLIT_CANCELLED;
+  }
+  else
+  {
+    member->error = SPLT_OK_SPLIT;
+  }
+
+  if ((member->error >= 0) &&
+      splt_t_get_int_option(extract->state, SPLT_OPT_SYNC_OUTPUT) &&
+      (fsync(out_fd) == -1))
+  {
+    member->errno_value = errno;
+    member->error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
   }
 
-  if (check_bitrate)
+  if ((close(out_fd) == -1) && (member->error >= 0))
   {
-    *error = SPLT_MIGHT_BE_VBR;
+    member->errno_value = errno;
+    member->error = SPLT_ERROR_CANNOT_CLOSE_FILE;
   }
+}
 
-  if (*error == SPLT_OK) { *error = SPLT_OK_SPLIT; }
+//extracts the next files of the wrapped file, until all are extracted
+static void splt_mp3_wrap_extract_files(struct splt_mp3_wrap_extract *extract)
+{
+  char *filename = splt_t_get_filename_to_split(extract->state);
 
-bloc_end2:
+  int in_fd = open(filename, O_RDONLY);
+  int open_errno = errno;
 
-  return sec_end_time;
-}
+  for (;;)
+  {
+    pthread_mutex_lock(&extract->mutex);
+    int i = extract->next++;
+    pthread_mutex_unlock(&extract->mutex);
 
-/****************************/
-/* mp3 syncerror */
+    if (i >= extract->members_num)
+    {
+      break;
+    }
 
-//this function is searching for the id3v1 and id3v2 and returns the offset
-static off_t splt_mp3_adjustsync(splt_mp3_state *mp3state, off_t begin, off_t end)
-{
-  off_t position;
-  position = begin;
-  if (fseeko(mp3state->file_input, position, SEEK_SET)==-1)
-  {
-    return (off_t) (-1);
+    struct splt_mp3_wrap_member *member = &extract->members[i];
+    off_t written = 0;
+    if (in_fd == -1)
+    {
+      member->errno_value = open_errno;
+      member->error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    }
+    else if (splt_t_split_is_canceled(extract->state))
+    {
+      member->error = SPLT_SPLIT_CANCELLED;
+    }
+    else
+    {
+      splt_mp3_wrap_extract_member(extract, in_fd, member, &written);
+    }
+
+    pthread_mutex_lock(&extract->mutex);
+    extract->finished++;
+    extract->bytes_written += written;
+    pthread_cond_signal(&extract->cond);
+    pthread_mutex_unlock(&extract->mutex);
   }
 
-  // First we search for ID3v1
-  while (position++ < end)
+  if (in_fd != -1)
   {
-    if (fgetc(mp3state->file_input)=='T') {
-      if (fgetc(mp3state->file_input)=='A') {
-        if (fgetc(mp3state->file_input)=='G')
-          return (position + 127);
-        else position++;
-      }
-      if (fseeko(mp3state->file_input, -1, SEEK_CUR) == -1)
-      {
-        return (off_t) (-1);
-      }
-    }
+    close(in_fd);
   }
+}
 
-  position = begin;
+//checks the crc of the wrapped file while the files are extracted
+static void splt_mp3_wrap_check_crc(struct splt_mp3_wrap_extract *extract)
+{
+  char *filename = splt_t_get_filename_to_split(extract->state);
 
-  if (fseeko(mp3state->file_input, position, SEEK_SET)==-1)
+  FILE *in = splt_u_fopen(filename, "rb");
+  if (in == NULL)
   {
-    return (off_t) (-1);
+    extract->crc_errno = errno;
+    extract->crc_error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    return;
   }
 
-  // Now we search for ID3v2
-  while (position++ < end) 
+  //the state is used by the extraction at the same time: the counters
+  //and the error are put in the state after the thread is joined
+  int err = SPLT_OK;
+  unsigned long crc = splt_mp3_crc_range(extract->state, in,
+      extract->crc_begin, extract->crc_end, &extract->crc_bytes_read, &err);
+  if (err < 0)
   {
-    if (fgetc(mp3state->file_input)=='I')
-    {
-      if (fgetc(mp3state->file_input)=='D')
-      {
-        if (fgetc(mp3state->file_input)=='3')
-        {
-          return (position - 1);
-        }
-        else 
-        {
-          position++;
-        }
-      }
-      if(fseeko(mp3state->file_input, -1, SEEK_CUR)==-1)
-      {
-        return (off_t) (-1);
-      }
-    }
+    extract->crc_errno = errno;
+    extract->crc_error = err;
+  }
+  else if (crc != extract->crc_expected)
+  {
+    extract->crc_error = SPLT_ERROR_CRC_FAILED;
   }
 
-  return end;
+  fclose(in);
 }
 
-//the function counts the number of sync error splits, 
-//and sets the offsets
-static void splt_mp3_syncerror_search(splt_state *state, int *error)
+//adds the resources used by the calling thread to the extraction
+static void splt_mp3_wrap_put_usage(struct splt_mp3_wrap_extract *extract)
 {
-  off_t offset = 0;
-  char *filename = splt_t_get_filename_to_split(state);
-  int sync_err = SPLT_OK;
+  splt_thread_usage usage;
+  splt_st_get_thread_usage(&usage);
 
-  splt_mp3_state *mp3state = state->codec;
+  pthread_mutex_lock(&extract->mutex);
+  splt_st_sum_thread_usage(&extract->usage, &usage);
+  pthread_mutex_unlock(&extract->mutex);
+}
 
-  splt_t_put_progress_text(state,SPLT_PROGRESS_SEARCH_SYNC);
+static void *splt_mp3_wrap_extract_thread(void *data)
+{
+  struct splt_mp3_wrap_extract *extract = data;
+  splt_mp3_wrap_extract_files(extract);
+  splt_mp3_wrap_put_usage(extract);
+  return NULL;
+}
 
-  mp3state->h.ptr = mp3state->mp3file.firsthead.ptr;
-  mp3state->h.framesize = mp3state->mp3file.firsthead.framesize;
+static void *splt_mp3_wrap_crc_thread(void *data)
+{
+  struct splt_mp3_wrap_extract *extract = data;
+  splt_mp3_wrap_check_crc(extract);
+  splt_mp3_wrap_put_usage(extract);
+  return NULL;
+}
 
-  //we get the file length for the progress
-  off_t st_size;
-  if(splt_u_stat(filename, NULL, &st_size) == 0)
+//extracts the files of the wrapped file with a few threads
+static void splt_mp3_wrap_extract_run(struct splt_mp3_wrap_extract *extract,
+    int *error)
+{
+  splt_state *state = extract->state;
+  pthread_t threads[SPLT_MP3_WRAP_MAX_THREADS];
+  pthread_t crc_thread;
+  int i, threads_num = 0;
+  short crc_started = SPLT_FALSE;
+
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  int wanted = (cpus > 0) ? (int) cpus : 1;
+  if (wanted > SPLT_MP3_WRAP_MAX_THREADS)
   {
-    //put the start point
-    sync_err = splt_t_serrors_append_point(state, 0);
-    if (sync_err != SPLT_OK)
+    wanted = SPLT_MP3_WRAP_MAX_THREADS;
+  }
+  if (wanted > extract->members_num)
+  {
+    wanted = extract->members_num;
+  }
+
+  pthread_mutex_init(&extract->mutex, NULL);
+  pthread_cond_init(&extract->cond, NULL);
+
+  if (extract->check_crc)
+  {
+    if (pthread_create(&crc_thread, NULL, splt_mp3_wrap_crc_thread, extract) == 0)
     {
-      *error = sync_err;
-      return;
+      crc_started = SPLT_TRUE;
+    }
+    else
+    {
+      splt_mp3_wrap_check_crc(extract);
     }
+  }
 
-    //search for sync errors and put in splitpoints
-    while (state->serrors->serrors_points_num < SPLT_MAXSYNC)
+  for (i = 0;i < wanted;i++)
+  {
+    if (pthread_create(&threads[threads_num], NULL,
+          splt_mp3_wrap_extract_thread, extract) == 0)
     {
-      offset = splt_mp3_findhead(mp3state, mp3state->h.ptr + mp3state->h.framesize);
-      if (offset==-1)
-      {
-        break;
-      }
+      threads_num++;
+    }
+  }
 
-      if (offset != mp3state->h.ptr + mp3state->h.framesize)
-      {
-        off_t serror_point =
-          splt_mp3_adjustsync(mp3state, mp3state->h.ptr, offset);
+  //without threads, we extract the files now
+  if (threads_num == 0)
+  {
+    splt_mp3_wrap_extract_files(extract);
+  }
 
-        //put syncerror splitpoint offset
-        sync_err = splt_t_serrors_append_point(state, serror_point);
-        if (sync_err != SPLT_OK)
-        {
-          *error = sync_err;
-          return;
-        }
-        offset = splt_mp3_findvalidhead(mp3state, serror_point);
-        if (splt_u_getword(mp3state->file_input, offset, SEEK_SET, &mp3state->headw) == -1)
-        {
-          *error = SPLT_ERR_SYNC;
-          return;
-        }
-      }
+  splt_t_put_progress_text(state, SPLT_PROGRESS_CREATE);
 
-      mp3state->h = splt_mp3_makehead (mp3state->headw, mp3state->mp3file,
-          mp3state->h, offset);
+  pthread_mutex_lock(&extract->mutex);
+  while (extract->finished < extract->members_num)
+  {
+    pthread_cond_wait(&extract->cond, &extract->mutex);
+    int finished = extract->finished;
+    pthread_mutex_unlock(&extract->mutex);
 
-      if (splt_t_split_is_canceled(state))
-      {
-        *error = SPLT_SPLIT_CANCELLED;
-        return;
-      }
+    splt_t_update_progress(state, (double) finished,
+        (double) extract->members_num, 1, 0, SPLT_DEFAULT_PROGRESS_RATE);
 
-      //progress
-      splt_t_update_progress(state,(double)(offset),
-          (double)(st_size),1,0,
-          SPLT_DEFAULT_PROGRESS_RATE);
-    }
+    pthread_mutex_lock(&extract->mutex);
   }
-  else
+  pthread_mutex_unlock(&extract->mutex);
+
+  for (i = 0;i < threads_num;i++)
   {
-    splt_t_set_strerror_msg(state);
-    splt_t_set_error_data(state,filename);
-    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
-    return;
+    pthread_join(threads[i], NULL);
   }
-
-  if (state->serrors->serrors_points_num == 0)
+  if (crc_started)
   {
-    *error = SPLT_ERR_NO_SYNC_FOUND;
-    return;
+    pthread_join(crc_thread, NULL);
   }
 
-  if (state->serrors->serrors_points_num == SPLT_MAXSYNC)
+  pthread_cond_destroy(&extract->cond);
+  pthread_mutex_destroy(&extract->mutex);
+
+  state->stats.bytes_written += extract->bytes_written;
+  state->stats.bytes_read += extract->crc_bytes_read;
+  splt_st_add_thread_usage(state, SPLT_PHASE_WRITE, &extract->usage, NULL);
+
+  //the extracted files replace the member files only if the wrapped file
+  //is not damaged; the other files of this run are removed
+  short crc_failed = extract->check_crc && (extract->crc_error < 0);
+  for (i = 0;i < extract->members_num;i++)
   {
-    *error = SPLT_ERR_TOO_MANY_SYNC_ERR;
-    return;
+    struct splt_mp3_wrap_member *member = &extract->members[i];
+    if (member->part_filename == NULL)
+    {
+      continue;
+    }
+
+    if (crc_failed || (member->error < 0))
+    {
+      unlink(member->part_filename);
+    }
+    else if (rename(member->part_filename, member->filename) == -1)
+    {
+      member->errno_value = errno;
+      member->error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
+      unlink(member->part_filename);
+    }
   }
 
-  //put the end point
-  sync_err = splt_t_serrors_append_point(state, LONG_MAX);
-  if (sync_err != SPLT_OK)
+  if (extract->check_crc)
   {
-    *error = sync_err;
-    return;
+    if (crc_failed)
+    {
+      if ((extract->crc_error == SPLT_ERROR_CANNOT_OPEN_FILE) ||
+          (extract->crc_error == SPLT_ERROR_SEEKING_FILE))
+      {
+        errno = extract->crc_errno;
+        splt_t_set_strerror_msg(state);
+        splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
+      }
+      *error = extract->crc_error;
+      return;
+    }
+
+    splt_t_put_info_message_to_client(state, _(" OK\n"));
   }
 
-  *error = SPLT_SYNC_OK;
+  for (i = 0;i < extract->members_num;i++)
+  {
+    struct splt_mp3_wrap_member *member = &extract->members[i];
+    if (member->error < 0)
+    {
+      if (member->errno_value != 0)
+      {
+        errno = member->errno_value;
+        splt_t_set_strerror_msg(state);
+      }
+      splt_t_set_error_data(state, member->filename);
+      *error = member->error;
+      continue;
+    }
 
-  return;
+    int ret = splt_t_put_split_file(state, member->filename);
+    if (ret < 0) { *error = ret; }
+  }
 }
+#endif
 
-/****************************/
-/* mp3 dewrap */
-
-static const unsigned char splt_mp3_albumwraphead[22] =
-{
-  0xa, 0x23, 0x54, 0x49, 0x54, 0x32, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x41, 0x6c, 0x62, 0x75, 0x6d, 0x57, 0x72, 0x61, 0x70,
-};
-
-//this function dewraps a file
+//this function reads the index of a wrapped file and dewraps it;
+//with 'extract', the files are only added to it to be extracted later
 //we return the possible error in the process_result parameter
-static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_state *state)
+static void splt_mp3_dewrap_index(int listonly, const char *dir, int *error,
+    splt_state *state, struct splt_mp3_wrap_extract *extract)
 {
   if (listonly)
   {
@@ -3064,37 +6157,40 @@ static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_stat
 
       id3offset = splt_mp3_getid3v2_end_offset(mp3state->file_input, 0);
 
-      //we go at the beginning of the file
-      if (fseeko(mp3state->file_input, id3offset, SEEK_SET)==-1)
+      splt_u_print_debug(state,"We search for wrap string...",0,NULL);
+
+      //we search the WRAP string in the file to see if it was wrapped
+      //with mp3wrap
+      struct splt_mp3_marker wrap_marker = { "WRAP", 4, -1 };
+      off_t wrap_end = id3offset + SPLT_MP3_WRAP_SEARCH_LENGTH;
+      off_t searched = splt_mp3_find_markers(&state->stats, mp3state->file_input,
+          id3offset, wrap_end, &wrap_marker, 1);
+      if (searched == -1)
       {
         *error = SPLT_DEWRAP_ERR_FILE_NOT_WRAPED_DAMAGED;
         return;
       }
 
-      splt_u_print_debug(state,"We search for wrap string...",0,NULL);
-
-      //we search the WRAP string in the file to see if it was wrapped
-      //with mp3wrap
-      for (i=0; i<16384; i++)
+      if (wrap_marker.offset != -1)
       {
-        if (feof(mp3state->file_input))
+        mp3wrap = 1;
+        id3offset = wrap_marker.offset;
+        //we continue after the WRAP string
+        if (fseeko(mp3state->file_input, id3offset + 4, SEEK_SET)==-1)
         {
           *error = SPLT_DEWRAP_ERR_FILE_NOT_WRAPED_DAMAGED;
           return;
         }
-        if ((id3offset = ftello(mp3state->file_input))==-1)
+      }
+      else
+      {
+        //the file ends before the end of the search
+        if (searched < wrap_end)
         {
           *error = SPLT_DEWRAP_ERR_FILE_NOT_WRAPED_DAMAGED;
           return;
         }
-        if (fgetc(mp3state->file_input)=='W')
-          if (fgetc(mp3state->file_input)=='R')
-            if (fgetc(mp3state->file_input)=='A')
-              if (fgetc(mp3state->file_input)=='P')
-              {
-                mp3wrap = 1;
-                break;
-              }
+        id3offset = searched;
       }
 
       //we check if the file was wrapped with albumwrap
@@ -3176,25 +6272,37 @@ static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_stat
               end = ftello(mp3state->file_input);
               splt_t_put_info_message_to_client(state,
                   _(" Check for file integrity: calculating CRC please wait... "));
-              crc = splt_mp3_c_crc(state, mp3state->file_input, begin, end, error);
-              if (*error < 0)
-              {
-                return;
-              }
-              if (crc != fcrc)
+
+              //the crc is checked while extracting the files
+              if (extract)
               {
-                //No interactivity in the library (for the moment)
-                //fprintf (stderr, "BAD\nWARNING: Bad CRC. File might be damaged. Continue anyway? (y/n) ");
-                //fgets(junk, 32, stdin);
-                //if (junk[0]!='y')
-                //error("Aborted.",125);
-                //- no interactivity in the library for the moment
-                *error = SPLT_ERROR_CRC_FAILED;
-                return;
+                extract->check_crc = SPLT_TRUE;
+                extract->crc_begin = begin;
+                extract->crc_end = end;
+                extract->crc_expected = fcrc;
               }
-              else 
+              else
               {
-                splt_t_put_info_message_to_client(state, _(" OK\n"));
+                crc = splt_mp3_c_crc(state, mp3state->file_input, begin, end, error);
+                if (*error < 0)
+                {
+                  return;
+                }
+                if (crc != fcrc)
+                {
+                  //No interactivity in the library (for the moment)
+                  //fprintf (stderr, "BAD\nWARNING: Bad CRC. File might be damaged. Continue anyway? (y/n) ");
+                  //fgets(junk, 32, stdin);
+                  //if (junk[0]!='y')
+                  //error("Aborted.",125);
+                  //- no interactivity in the library for the moment
+                  *error = SPLT_ERROR_CRC_FAILED;
+                  return;
+                }
+                else 
+                {
+                  splt_t_put_info_message_to_client(state, _(" OK\n"));
+                }
               }
               if (fseeko(mp3state->file_input, begin, SEEK_SET)==-1)
               {
@@ -3439,7 +6547,7 @@ static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_stat
             snprintf(str_temp,4,"%c%c",'.',SPLT_DIRCHAR);
             if (strstr(filename,str_temp) != NULL)
             {
-              char *filename2 = strdup(filename);
+              char *filename2 = splt_u_strdup(filename);
               if (!filename2)
               {
                 *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -3538,6 +6646,14 @@ static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_stat
                 return;
               }
 
+              //the file is extracted later with the others
+              if (extract)
+              {
+                ret = splt_mp3_wrap_extract_add(extract, filename, begin, end);
+                if (ret < 0) { *error = ret; return; }
+                continue;
+              }
+
               //do the real wrap split
               ret = splt_mp3_simple_split(state, filename, begin, end,
                   SPLT_FALSE, SPLT_FALSE);
@@ -3554,6 +6670,11 @@ static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_stat
               }
             }
           }
+          else
+          {
+            *error = SPLT_SPLIT_CANCELLED;
+            return;
+          }
         }
       }
       else
@@ -3565,6 +6686,41 @@ static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_stat
   }
 }
 
+//this function dewraps a file
+//we return the possible error in the process_result parameter
+static void splt_mp3_dewrap(int listonly, const char *dir, int *error, splt_state *state)
+{
+#ifndef __WIN32__
+  //the files are extracted by threads when they are only copied
+  if (!listonly && !splt_mf_is_enabled(state) &&
+      !splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  {
+    struct splt_mp3_wrap_extract extract;
+    memset(&extract, 0x0, sizeof(extract));
+    extract.state = state;
+
+    splt_mp3_dewrap_index(listonly, dir, error, state, &extract);
+
+    //the files found before an error in the index are extracted
+    int index_error = *error;
+    if (extract.members_num > 0)
+    {
+      *error = SPLT_DEWRAP_OK;
+      splt_mp3_wrap_extract_run(&extract, error);
+      if ((*error >= 0) && (index_error < 0))
+      {
+        *error = index_error;
+      }
+    }
+
+    splt_mp3_wrap_extract_free(&extract);
+    return;
+  }
+#endif
+
+  splt_mp3_dewrap_index(listonly, dir, error, state, NULL);
+}
+
 void splt_mp3_init(splt_state *state, int *error)
 {
   FILE *file_input = NULL;
@@ -3604,7 +6760,7 @@ void splt_pl_set_plugin_info(splt_plugin_info *info, int *error)
   info->version = plugin_version;
 
   //set plugin name
-  info->name = malloc(sizeof(char) * 40);
+  info->name = splt_u_malloc(sizeof(char) * 40);
   if (info->name != NULL)
   {
     snprintf(info->name, 39, "mp3 (libmad)");
@@ -3616,7 +6772,7 @@ void splt_pl_set_plugin_info(splt_plugin_info *info, int *error)
   }
 
   //set plugin extension
-  info->extension = malloc(sizeof(char) * (strlen(SPLT_MP3EXT)+2));
+  info->extension = splt_u_malloc(sizeof(char) * (strlen(SPLT_MP3EXT)+2));
   if (info->extension != NULL)
   {
     snprintf(info->extension, strlen(SPLT_MP3EXT)+1, SPLT_MP3EXT);
@@ -3721,7 +6877,18 @@ void splt_pl_dewrap(splt_state *state, int listonly, const char *dir, int *error
 double splt_pl_split(splt_state *state, const char *final_fname,
     double begin_point, double end_point, int *error, int save_end_point)
 {
-  return splt_mp3_split(final_fname, state, begin_point, end_point, error, save_end_point);
+  double end_time =
+    splt_mp3_split(final_fname, state, begin_point, end_point, error, save_end_point);
+
+  splt_mp3_state *mp3state = state->codec;
+  if (mp3state && mp3state->file_input &&
+      !splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
+  {
+    splt_io_input_consumed(state, mp3state->file_input,
+        ftello(mp3state->file_input));
+  }
+
+  return end_time;
 }
 
 int splt_pl_simple_split(splt_state *state, char *output_fname, off_t begin, off_t end)
@@ -3759,6 +6926,69 @@ int splt_pl_scan_silence(splt_state *state, int *error)
   return found;
 }
 
+int splt_pl_stream_silence_split(splt_state *state, int *error)
+{
+  return splt_mp3_stream_silence_split(state, error);
+}
+
+//scans the silences from 'begin_point' to 'end_point' seconds; the
+//frames are counted from the last window scanned, so the windows
+//should be scanned in increasing order
+int splt_pl_scan_silence_window(splt_state *state, double begin_point,
+    double end_point, int *error)
+{
+  float threshold = splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD);
+  int found = 0;
+
+  splt_mp3_state *mp3state = state->codec;
+
+  unsigned long fbegin = (unsigned long) (begin_point * mp3state->mp3file.fps);
+  if ((mp3state->window_frames == 0) || (mp3state->window_frames > fbegin))
+  {
+    mp3state->window_h = mp3state->mp3file.firsthead;
+    mp3state->window_frames = 1;
+  }
+
+  // Finds the start of the window by counting frames
+  while (mp3state->window_frames < fbegin)
+  {
+    off_t next = splt_mp3_findhead(mp3state,
+        mp3state->window_h.ptr + mp3state->window_h.framesize);
+    if (next == -1)
+    {
+      //the window starts after the end of the file
+      return 0;
+    }
+
+    mp3state->window_h = splt_mp3_makehead(mp3state, mp3state->headw,
+        mp3state->window_h, next);
+    mp3state->window_frames++;
+
+    if (splt_t_split_is_canceled(state))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
+      return -1;
+    }
+  }
+
+  unsigned long length =
+    (unsigned long) ((end_point - begin_point) * 100.0);
+
+  state->envelope.time_offset =
+    (mp3state->window_frames - 1) / mp3state->mp3file.fps;
+  found = splt_mp3_scan_silence(state, mp3state->window_h.ptr, length,
+      threshold, 0.f, 0, error);
+  state->envelope.time_offset = 0;
+
+  return found;
+}
+
+int splt_pl_rewrite_tags(splt_state *state, const char *output_fname,
+    int *error)
+{
+  return splt_mp3_rewrite_tags(state, output_fname, error);
+}
+
 void splt_pl_set_original_tags(splt_state *state, int *error)
 {
 #ifndef NO_ID3TAG
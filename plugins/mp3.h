@@ -43,6 +43,17 @@
 
 #define SPLT_MAD_BSIZE 4032
 
+//the padding, sample rate, bitrate, protection, layer and version bits
+//of a header word index the header table
+#define SPLT_MP3_HEAD_TABLE_SIZE 4096
+#define SPLT_MP3_HEAD_SYNC 0xffe00000
+#define SPLT_MP3_HEAD_INDEX(head) (((head) >> 9) & 0xfff)
+
+//largest text encoding byte and byte order mark of an ID3v2 text frame
+#define SPLT_MP3_ID3V2_PREFIX_MAX 8
+//ID3v2 tag and frame header length
+#define SPLT_MP3_ID3V2_HEADER 10
+
 // Struct that will contain header's useful infos
 struct splt_header {
   off_t ptr;    // Offset of header
@@ -78,6 +89,50 @@ struct splt_mp3 {
   struct splt_header firsthead;
 };
 
+//offset of a frame, one every few seconds of the file
+struct splt_mp3_seek_entry {
+  unsigned long frame;
+  off_t offset;
+};
+
+//bitrate and frame size of a header word, for the file being split
+struct splt_mp3_head_entry {
+  //bitrate index, 0 if the header is not valid
+  unsigned char index;
+  short bitrate;
+  short framesize;
+};
+
+//reader thread of the non seekable input, defined in mp3.c
+struct splt_mp3_read_ahead;
+
+//ID3v2 tag rendered once by libid3tag for the tags shared by the split
+//files; only the title and track frames change from one file to another
+struct splt_mp3_id3v2_template {
+  //the shared tags the template was built with
+  char *artist;
+  char *album;
+  char *year;
+  char *comment;
+  unsigned char genre;
+  short has_track;
+  //SPLT_TRUE if the template is valid for the shared tags
+  short usable;
+  //SPLT_TRUE once a tag patched from the template was the same as
+  //the one rendered by libid3tag
+  short checked;
+  unsigned char *bytes;
+  unsigned long length;
+  //offset and length of the title and track frames in 'bytes'
+  unsigned long title_offset;
+  unsigned long title_length;
+  unsigned long track_offset;
+  unsigned long track_length;
+  //text encoding byte and byte order mark of the text frames
+  unsigned char text_prefix[SPLT_MP3_ID3V2_PREFIX_MAX];
+  int text_prefix_length;
+};
+
 typedef struct {
   FILE *file_input;
   struct splt_header h;
@@ -94,6 +149,8 @@ typedef struct {
 
   //see the mp3 structure
   struct splt_mp3 mp3file;
+  //header words indexed by their bits 9 to 20
+  struct splt_mp3_head_entry head_table[SPLT_MP3_HEAD_TABLE_SIZE];
 
   //used internally, libmad structures
   struct mad_stream stream;
@@ -107,14 +164,70 @@ typedef struct {
   unsigned char inputBuffer[SPLT_MAD_BSIZE];
   //mad timer
   mad_timer_t timer;
+  //position of the last decoded frame, in samples
+  unsigned long long samples;
   //used internally, pointer to the beginning of a frame
   unsigned char *data_ptr;
   //used internally, length of a frame
   long data_len;
   //length of a buffer when reading a frame
   int buf_len;
+  //sparse seek index used when not in frame mode, built once per file
+  struct splt_mp3_seek_entry *seek_index;
+  long seek_index_number;
+  unsigned long seek_index_step;
+  //header and frame number where the last silence window started
+  struct splt_header window_h;
+  unsigned long window_frames;
+  //the fast silence scan keeps the last two frames at full quality
+  //to check again the frames close to the threshold
+  short fast_scan;
+  mad_fixed_t recheck_low;
+  mad_fixed_t recheck_high;
+  struct mad_frame recheck_frame;
+  struct mad_synth recheck_synth;
+  struct mad_header recheck_header[2];
+  mad_fixed_t recheck_sbsample[2][2][36][32];
+  int recheck_current;
+  short recheck_previous;
+  //ID3v2 tags of the split files
+  struct splt_mp3_id3v2_template id3v2_template;
+  //original ID3v2 and ID3v1 tags of the input file, read once with the
+  //mp3 infos
+  short original_tags_read;
+  unsigned char *id3v2_bytes;
+  unsigned long id3v2_length;
+  unsigned char id3v1_bytes[128];
+  short has_id3v1;
+  //blocks of the non seekable input read by a thread, NULL if the
+  //input is read directly
+  struct splt_mp3_read_ahead *read_ahead;
 } splt_mp3_state;
 
+//a string searched by splt_mp3_find_markers
+struct splt_mp3_marker {
+  const char *pattern;
+  int length;
+  //offset of the first occurrence, -1 if not found
+  off_t offset;
+};
+
+//the frames kept while a silence may still move the cut point, when
+//splitting a non seekable input in silence mode
+struct splt_mp3_pending {
+  //circular buffer of the bytes of the frames
+  unsigned char *data;
+  long size;
+  long start;
+  long used;
+  //end time (in seconds) and length of each frame
+  double *time;
+  long *length;
+  long slots;
+  long first;
+  long count;
+};
+
 /****************************/
 /* mp3 constants */
 
@@ -127,6 +240,35 @@ typedef struct {
    48000/1152 = 41.66667 = 24000/576
    */
 
+//bytes read at a time when searching for markers, and longest marker
+#define SPLT_MP3_MARKER_BUFFER_SIZE 16384
+#define SPLT_MP3_MARKER_MAX_LENGTH 8
+
+//smallest part of the file searched for sync errors by a thread,
+//most parts searched at the same time, and headers of the beginning
+//of a part kept to join it with the previous part
+#define SPLT_MP3_SYNC_PART_MIN_SIZE (16 * 1024 * 1024)
+#define SPLT_MP3_SYNC_MAX_PARTS 8
+#define SPLT_MP3_SYNC_JOIN_HEADERS 1024
+
+//most threads extracting the files of a wrapped file, and bytes
+//copied at a time
+#define SPLT_MP3_WRAP_MAX_THREADS 8
+#define SPLT_MP3_WRAP_COPY_SIZE (8 * 1024 * 1024)
+
+//blocks of the non seekable input read ahead by a thread
+#define SPLT_MP3_READ_AHEAD_BLOCKS 8
+#define SPLT_MP3_READ_AHEAD_BLOCK_SIZE (256 * 1024)
+
+//bytes read at a time for the crc of a wrapped file
+#define SPLT_MP3_CRC_BUFFER_SIZE 65536
+
+//seconds between two entries of the seek index
+#define SPLT_MP3_SEEK_INDEX_SECONDS 5
+
+//samples decoded from one frame
+#define SPLT_MP3_FRAME_SAMPLES(header) (32 * MAD_NSBSAMPLES(header))
+
 #define SPLT_MP3_TAG "TAG"
 #define SPLT_MP3_GENRENUM 82
 #define SPLT_MP3_PCM 1152
@@ -146,8 +288,19 @@ typedef struct {
 #define SPLT_MP3_ID3_TRACK 6
 #define SPLT_MP3_ID3_COMMENT 7
 
+//dB around the threshold where the frames of a fast scan are checked
+//again at full quality
+#define SPLT_MP3_RECHECK_MARGIN 3
+
+//largest frame kept in the pending frames, in bytes
+#define SPLT_MP3_MAX_FRAMESIZE 2881
+//seconds of frames kept for a silence longer than the minimum length
+#define SPLT_MP3_STREAM_SECONDS 30
+
 #define SPLT_MP3_CRCLEN 4
 #define SPLT_MP3_ABWINDEXOFFSET 0x539
+//bytes after the ID3v2 where the WRAP string is searched
+#define SPLT_MP3_WRAP_SEARCH_LENGTH 16384
 #define SPLT_MP3_ABWLEN 0x1f5
 #define SPLT_MP3_INDEXVERSION 1
 #define SPLT_MP3_READBSIZE 1024
@@ -0,0 +1,158 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+//checks the mp3 header table against the header functions it replaces
+//-built and run with 'make bench', it is not installed
+//-for every version, layer and sample rate, every header word with the
+//sync bits is checked : validity against splt_mp3_c_bitrate, bitrate
+//and frame size against the formula of the header
+//-returns 0 if the table matches, 1 otherwise
+
+#include "mp3.c"
+
+//number of mismatches printed before giving up
+#define SPLT_CHECK_MAX_ERRORS 20
+
+static const int splt_check_freqs[] = {
+  44100, 48000, 32000, 22050, 24000, 16000, 11025, 12000, 8000
+};
+
+//the bitrate and frame size as computed before the header table
+static void splt_check_old_makehead(struct splt_mp3 *mp3f,
+    unsigned long headword, int *bitrate, int *framesize)
+{
+  int padding = ((headword>>9)&0x1);
+
+  *bitrate = splt_mp3_tabsel_123[1 - mp3f->mpgid][mp3f->layer-1]
+    [splt_mp3_c_bitrate(headword)];
+  *framesize = (*bitrate*144000)/(mp3f->freq<<(1 - mp3f->mpgid)) + padding;
+}
+
+//checks all the header words of the current table, returns the number
+//of mismatches found so far, starting from 'errors'
+static int splt_check_table(splt_mp3_state *mp3state, int errors)
+{
+  struct splt_mp3 *mp3f = &mp3state->mp3file;
+  struct splt_header head;
+  unsigned long i, low;
+
+  memset(&head, 0, sizeof(head));
+
+  for (i = 0;i < SPLT_MP3_HEAD_TABLE_SIZE;i++)
+  {
+    for (low = 0;low < (1 << 9);low++)
+    {
+      unsigned long headword = SPLT_MP3_HEAD_SYNC | (i << 9) | low;
+      int old_valid = (splt_mp3_c_bitrate(headword) != 0);
+      int valid = (splt_mp3_head_is_valid(mp3state, headword) != 0);
+      int bitrate, framesize;
+
+      splt_check_old_makehead(mp3f, headword, &bitrate, &framesize);
+      head = splt_mp3_makehead(mp3state, headword, head, 0);
+
+      if (valid != old_valid || head.bitrate != bitrate ||
+          head.framesize != framesize)
+      {
+        if (errors < SPLT_CHECK_MAX_ERRORS)
+        {
+          fprintf(stderr, "mpgid %d layer %d freq %d header %08lx :"
+              " valid %d/%d bitrate %d/%d framesize %d/%d\n",
+              mp3f->mpgid, mp3f->layer, mp3f->freq, headword,
+              valid, old_valid, head.bitrate, bitrate,
+              head.framesize, framesize);
+        }
+        errors++;
+      }
+
+      //the same word without all the sync bits is never a header
+      if (splt_mp3_head_is_valid(mp3state, headword & ~(1UL << 31)) ||
+          splt_mp3_head_is_valid(mp3state, headword & ~(1UL << 21)))
+      {
+        if (errors < SPLT_CHECK_MAX_ERRORS)
+        {
+          fprintf(stderr, "mpgid %d layer %d freq %d header %08lx :"
+              " valid without the sync bits\n",
+              mp3f->mpgid, mp3f->layer, mp3f->freq, headword);
+        }
+        errors++;
+      }
+    }
+  }
+
+  return errors;
+}
+
+int main(void)
+{
+  splt_mp3_state *mp3state = NULL;
+  size_t f;
+  int mpgid, layer;
+  int errors = 0;
+  int tables = 0;
+
+  if ((mp3state = malloc(sizeof(splt_mp3_state))) == NULL)
+  {
+    fprintf(stderr, "mp3_head_table_check: not enough memory\n");
+    return 1;
+  }
+  memset(mp3state, 0, sizeof(splt_mp3_state));
+
+  for (mpgid = 0;mpgid <= 1;mpgid++)
+  {
+    for (layer = 1;layer <= 3;layer++)
+    {
+      for (f = 0;f < sizeof(splt_check_freqs) / sizeof(splt_check_freqs[0]);f++)
+      {
+        mp3state->mp3file.mpgid = mpgid;
+        mp3state->mp3file.layer = layer;
+        mp3state->mp3file.freq = splt_check_freqs[f];
+
+        splt_mp3_init_head_table(mp3state);
+        errors = splt_check_table(mp3state, errors);
+        tables++;
+      }
+    }
+  }
+
+  free(mp3state);
+
+  if (errors > 0)
+  {
+    fprintf(stderr, "mp3_head_table_check: %d mismatches\n", errors);
+    return 1;
+  }
+
+  printf("mp3_head_table_check: %d tables of %d entries checked\n",
+      tables, SPLT_MP3_HEAD_TABLE_SIZE);
+
+  return 0;
+}
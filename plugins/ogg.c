@@ -148,6 +148,10 @@ FILE *splt_ogg_open_file_read(splt_state *state,
       splt_t_set_error_data(state,filename);
       *error = SPLT_ERROR_CANNOT_OPEN_FILE;
     }
+    else
+    {
+      splt_io_set_input_policy(state, file_input);
+    }
   }
 
   return file_input;
@@ -199,7 +203,7 @@ static char *splt_ogg_trackstring(int number)
     int len = 0, i;
     len = ((int) (log10((double) (number)))) + 1;
 
-    if ((track = malloc(len + 1))==NULL)
+    if ((track = splt_u_malloc(len + 1))==NULL)
     {
       return NULL;
     }
@@ -231,12 +235,13 @@ static char *splt_ogg_checkutf(char *s)
 }
 
 //saves a packet
-static splt_v_packet *splt_ogg_save_packet(ogg_packet *packet, int *error)
+static splt_v_packet *splt_ogg_save_packet(splt_state *state, ogg_packet *packet,
+    int *error)
 {
   splt_v_packet *p = NULL;
 
   //if we have no header, we will have bytes < 0
-  p = malloc(sizeof(splt_v_packet));
+  p = splt_u_malloc(sizeof(splt_v_packet));
   if (!p)
   {
     *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -244,7 +249,7 @@ static splt_v_packet *splt_ogg_save_packet(ogg_packet *packet, int *error)
   }
 
   p->length = packet->bytes;
-  p->packet = malloc(p->length);
+  p->packet = splt_u_malloc(p->length);
   if (! p->packet)
   {
     *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -305,6 +310,8 @@ static int splt_ogg_update_sync(splt_state *state, ogg_sync_state *sync_in,
     return -1;
   }
 
+  state->stats.bytes_read += bytes;
+
   return bytes;
 }
 
@@ -432,37 +439,37 @@ static splt_ogg_state *splt_ogg_v_new(int *error)
 {
   splt_ogg_state *oggstate = NULL;
 
-  if ((oggstate = malloc(sizeof(splt_ogg_state)))==NULL)
+  if ((oggstate = splt_u_malloc(sizeof(splt_ogg_state)))==NULL)
   {
     goto error;
   }
   memset(oggstate, 0, sizeof(splt_ogg_state));
-  if ((oggstate->sync_in = malloc(sizeof(ogg_sync_state)))==NULL)
+  if ((oggstate->sync_in = splt_u_malloc(sizeof(ogg_sync_state)))==NULL)
   {
     goto error;
   }
-  if ((oggstate->stream_in = malloc(sizeof(ogg_stream_state)))==NULL)
+  if ((oggstate->stream_in = splt_u_malloc(sizeof(ogg_stream_state)))==NULL)
   {
     goto error;
   }
-  if ((oggstate->vd = malloc(sizeof(vorbis_dsp_state)))==NULL)
+  if ((oggstate->vd = splt_u_malloc(sizeof(vorbis_dsp_state)))==NULL)
   {
     goto error;
   }
-  if ((oggstate->vi = malloc(sizeof(vorbis_info)))==NULL)
+  if ((oggstate->vi = splt_u_malloc(sizeof(vorbis_info)))==NULL)
   {
     goto error;
   }
-  if ((oggstate->vb = malloc(sizeof(vorbis_block)))==NULL)
+  if ((oggstate->vb = splt_u_malloc(sizeof(vorbis_block)))==NULL)
   {
     goto error;
   }
-  if ((oggstate->headers = malloc(sizeof(splt_v_packet)*3))==NULL)
+  if ((oggstate->headers = splt_u_malloc(sizeof(splt_v_packet)*3))==NULL)
   {
     goto error;
   }
   memset(oggstate->headers, 0, sizeof(splt_v_packet)*3);
-  if ((oggstate->packets = malloc(sizeof(splt_v_packet)*2))==NULL)
+  if ((oggstate->packets = splt_u_malloc(sizeof(splt_v_packet)*2))==NULL)
   {
     goto error;
   }
@@ -643,7 +650,8 @@ void splt_ogg_put_tags(splt_state *state, int *error)
 
 //Pull out and save the 3 header packets from the input file.
 //-returns -1 if error and error is set in '*error'
-static int splt_ogg_process_headers(splt_ogg_state *oggstate, int *error)
+static int splt_ogg_process_headers(splt_state *state, splt_ogg_state *oggstate,
+    int *error)
 {
   ogg_page page;
   ogg_packet packet;
@@ -671,6 +679,7 @@ static int splt_ogg_process_headers(splt_ogg_state *oggstate, int *error)
     {
       goto error_invalid_file;
     }
+    state->stats.bytes_read += bytes;
     if (ogg_sync_wrote(oggstate->sync_in, bytes) != 0)
     {
       goto error_invalid_file;
@@ -695,7 +704,7 @@ static int splt_ogg_process_headers(splt_ogg_state *oggstate, int *error)
     goto error_invalid_file;
   }
   int packet_err = SPLT_OK;
-  oggstate->headers[0] = splt_ogg_save_packet(&packet, &packet_err);
+  oggstate->headers[0] = splt_ogg_save_packet(state, &packet, &packet_err);
   if (packet_err < 0)
   { 
     goto error;
@@ -735,7 +744,7 @@ static int splt_ogg_process_headers(splt_ogg_state *oggstate, int *error)
             goto error_invalid_file;
           }
 
-          oggstate->headers[i+1] = splt_ogg_save_packet(&packet, &packet_err);
+          oggstate->headers[i+1] = splt_ogg_save_packet(state, &packet, &packet_err);
           if (packet_err < 0)
           {
             goto error;
@@ -757,6 +766,7 @@ static int splt_ogg_process_headers(splt_ogg_state *oggstate, int *error)
       goto error;
     }
     bytes=fread(buffer,1,SPLT_OGG_BUFSIZE,oggstate->in);
+    state->stats.bytes_read += bytes;
 
     if(bytes == 0 && i < 2)
     {
@@ -814,7 +824,7 @@ splt_ogg_state *splt_ogg_info(FILE *in, splt_state *state, int *error)
   }
 
   /* Read headers in, and save them */
-  if (splt_ogg_process_headers(oggstate, error) == -1)
+  if (splt_ogg_process_headers(state, oggstate, error) == -1)
   {
     if (*error == SPLT_ERROR_INVALID)
     {
@@ -874,6 +884,12 @@ static int splt_ogg_find_begin_cutpoint(splt_state *state, splt_ogg_state *oggst
 
   while (!eos)
   {
+    if (splt_t_split_is_canceled(state))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
+      return -1;
+    }
+
     while (!eos)
     {
       int result = ogg_sync_pageout(oggstate->sync_in, &page);
@@ -918,6 +934,7 @@ static int splt_ogg_find_begin_cutpoint(splt_state *state, splt_ogg_state *oggst
             *error = SPLT_ERROR_INVALID;
             return -1;
           }
+          state->stats.frames_parsed++;
 
           //for a broken ogg file with no
           //header, we have granpos > cutpoint the first time
@@ -944,7 +961,7 @@ static int splt_ogg_find_begin_cutpoint(splt_state *state, splt_ogg_state *oggst
                    * just in case.
                    */
                   splt_ogg_free_packet(&oggstate->packets[0]);
-                  oggstate->packets[0] = splt_ogg_save_packet(&packet, &packet_err);
+                  oggstate->packets[0] = splt_ogg_save_packet(state, &packet, &packet_err);
                   if (packet_err < 0) { return -1; }
                 }
               }
@@ -998,13 +1015,13 @@ static int splt_ogg_find_begin_cutpoint(splt_state *state, splt_ogg_state *oggst
       if (prevgranpos > cutpoint)
       {
         splt_ogg_free_packet(&oggstate->packets[1]);
-        oggstate->packets[1] = splt_ogg_save_packet(&packet, &packet_err);
+        oggstate->packets[1] = splt_ogg_save_packet(state, &packet, &packet_err);
         if (packet_err < 0) { return -1; }
         break;
       }
 
       splt_ogg_free_packet(&oggstate->packets[0]);
-      oggstate->packets[0] = splt_ogg_save_packet(&packet, &packet_err);
+      oggstate->packets[0] = splt_ogg_save_packet(state, &packet, &packet_err);
       if (packet_err < 0) { return -1; }
     }
   }
@@ -1130,6 +1147,12 @@ static int splt_ogg_find_end_cutpoint(splt_state *state, ogg_stream_state *strea
 
   while (!eos)
   {
+    if (splt_t_split_is_canceled(state))
+    {
+      *error = SPLT_SPLIT_CANCELLED;
+      return -1;
+    }
+
     while (!eos)
     {
       result = ogg_sync_pageout(oggstate->sync_in, &page);
@@ -1155,6 +1178,7 @@ static int splt_ogg_find_end_cutpoint(splt_state *state, ogg_stream_state *strea
             *error = SPLT_ERROR_INVALID;
             return -1;
           }
+          state->stats.frames_parsed++;
 
           if ((cutpoint == 0) || (page_granpos < cutpoint))
           {
@@ -1176,7 +1200,7 @@ static int splt_ogg_find_end_cutpoint(splt_state *state, ogg_stream_state *strea
 
                   //we need to save the last packet, so save the curren packet each time
                   splt_ogg_free_packet(&oggstate->packets[0]);
-                  oggstate->packets[0] = splt_ogg_save_packet(&packet, &packet_err);
+                  oggstate->packets[0] = splt_ogg_save_packet(state, &packet, &packet_err);
 
                   if (packet_err < 0) { return -1; }
                   if (current_granpos > page_granpos)
@@ -1227,8 +1251,9 @@ static int splt_ogg_find_end_cutpoint(splt_state *state, ogg_stream_state *strea
               if (splt_ogg_scan_silence(state,
                     (2 * adjust), threshold, 0.f, 0, &page, current_granpos, error) > 0)
               {
-                cutpoint = (splt_u_silence_position(state->silence_list, 
-                      oggstate->off) * oggstate->vi->rate);
+                int longest = splt_t_ssplit_get_longest(&state->silence_list);
+                cutpoint = (splt_u_silence_position(&state->silence_list, 
+                      longest, oggstate->off) * oggstate->vi->rate);
               }
               else
               {
@@ -1316,7 +1341,7 @@ static int splt_ogg_find_end_cutpoint(splt_state *state, ogg_stream_state *strea
         //don't save the last packet if exact split
         if (prev_granpos != cutpoint)
         {
-          oggstate->packets[1] = splt_ogg_save_packet(&packet, &packet_err);
+          oggstate->packets[1] = splt_ogg_save_packet(state, &packet, &packet_err);
         }
         if (packet_err < 0) { return -1; }
         packet.granulepos = cutpoint; /* Set it! This 'truncates' the final packet, as needed. */
@@ -1331,7 +1356,7 @@ static int splt_ogg_find_end_cutpoint(splt_state *state, ogg_stream_state *strea
       }
 
       splt_ogg_free_packet(&oggstate->packets[0]);
-      oggstate->packets[0] = splt_ogg_save_packet(&packet, &packet_err);
+      oggstate->packets[0] = splt_ogg_save_packet(state, &packet, &packet_err);
       if (packet_err < 0) { return -1; }
 
       ogg_stream_packetin(stream, &packet);
@@ -1419,8 +1444,11 @@ double splt_ogg_split(const char *output_fname, splt_state *state,
   {
     // We must do this before. If an error occurs, we don't want to create empty files!
     //we find the begin cutpoint
-    if (splt_ogg_find_begin_cutpoint(state,
-          oggstate, oggstate->in, begin, error, filename) < 0)
+    int phase = splt_st_enter_phase(state, SPLT_PHASE_CUTPOINT_SEARCH);
+    int cutpoint_result = splt_ogg_find_begin_cutpoint(state,
+          oggstate, oggstate->in, begin, error, filename);
+    splt_st_leave_phase(state, phase);
+    if (cutpoint_result < 0)
     {
       return sec_end_time;
     }
@@ -1445,6 +1473,8 @@ double splt_ogg_split(const char *output_fname, splt_state *state,
         *error = SPLT_ERROR_CANNOT_OPEN_DEST_FILE;
         return sec_end_time;
       }
+      //the size of the ogg split files is not known
+      splt_io_set_output_policy(state, oggstate->out, 0);
     }
   }
 
@@ -1456,7 +1486,7 @@ double splt_ogg_split(const char *output_fname, splt_state *state,
 
   int packet_err = SPLT_OK;
   splt_ogg_free_packet(&oggstate->headers[1]);
-  oggstate->headers[1] = splt_ogg_save_packet(&header_comm, &packet_err);
+  oggstate->headers[1] = splt_ogg_save_packet(state, &header_comm, &packet_err);
   ogg_packet_clear(&header_comm);
   vorbis_comment_clear(&oggstate->vc);
   if (packet_err < 0)
@@ -1485,14 +1515,11 @@ end:
   ogg_stream_clear(&stream_out);
   if (oggstate->out)
   {
-    if (oggstate->out != stdout)
+    if (splt_u_fclose_output(state, oggstate->out) != 0)
     {
-      if (fclose(oggstate->out) != 0)
-      {
-        splt_t_set_strerror_msg(state);
-        splt_t_set_error_data(state, output_fname);
-        *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
-      }
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, output_fname);
+      *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
     }
     oggstate->out = NULL;
   }
@@ -1514,39 +1541,56 @@ end:
 /****************************/
 /* ogg scan for silence */
 
-//used by scan_silence
-static int splt_ogg_silence(splt_ogg_state *oggstate, vorbis_dsp_state *vd, float threshold)
+//used by scan_silence, returns the highest sample of the block
+static float splt_ogg_silence(splt_ogg_state *oggstate, vorbis_dsp_state *vd,
+    short downmix)
 {
   float **pcm = NULL, sample;
-  int samples, silence = 1;
+  float peak = 0;
+  int samples;
 
   while((samples=vorbis_synthesis_pcmout(vd,&pcm))>0)
   {
-    if (silence) 
+    int i, j;
+    //the channels are merged before the threshold test
+    if (downmix && (oggstate->vi->channels > 1))
     {
-      int i, j;
-      for (i=0; i < oggstate->vi->channels; i++)
+      float scale = 1.f / oggstate->vi->channels;
+      for(j=0; j<samples; j++)
       {
-        float  *mono=pcm[i];
-        if (!silence) 
+        sample = 0;
+        for (i=0; i < oggstate->vi->channels; i++)
         {
-          break;
+          sample += pcm[i][j];
         }
-        for(j=0; j<samples; j++)
+        sample = fabs(sample * scale);
+        oggstate->temp_level = oggstate->temp_level *0.999 + sample*0.001;
+        if (sample > peak)
         {
-          sample = fabs(mono[j]);
-          oggstate->temp_level = oggstate->temp_level *0.999 + sample*0.001;
-          if (sample > threshold)
-          {
-            silence = 0;
-          }
+          peak = sample;
+        }
+      }
+      vorbis_synthesis_read(vd, samples);
+      continue;
+    }
+
+    for (i=0; i < oggstate->vi->channels; i++)
+    {
+      float  *mono=pcm[i];
+      for(j=0; j<samples; j++)
+      {
+        sample = fabs(mono[j]);
+        oggstate->temp_level = oggstate->temp_level *0.999 + sample*0.001;
+        if (sample > peak)
+        {
+          peak = sample;
         }
       }
     }
     vorbis_synthesis_read(vd, samples);
   }
 
-  return silence;
+  return peak;
 }
 
 //scans for silence
@@ -1564,12 +1608,12 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
   ogg_stream_state os;
   vorbis_dsp_state vd;
   vorbis_block vb;
-  ogg_int64_t end_position, begin_position, pos, end, begin, page_granpos;
-  int eos=0, found = 0, shot, result = 0, len = 0 ;
-  short first, flush = 0;
+  ogg_int64_t pos, end, begin, page_granpos;
+  int eos=0, found = 0, result = 0;
+  short flush = 0;
   off_t position = ftello(oggstate->in); // Some backups
   int saveW = oggstate->prevW;
-  float th = splt_u_convertfromdB(threshold);
+  splt_silence_detector detector;
 
   ogg_sync_init(&oy);
   ogg_stream_init(&os, oggstate->serial);
@@ -1583,7 +1627,13 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
     result = 1;
   }
 
-  end_position = begin_position = pos = granpos;
+  pos = granpos;
+  //the fast scan only decodes half of the spectrum
+  short fast_scan = splt_t_get_int_option(state, SPLT_OPT_FAST_SCAN);
+  if (fast_scan)
+  {
+    vorbis_synthesis_halfrate(oggstate->vi, 1);
+  }
   vorbis_synthesis_init(&vd, oggstate->vi);
   vorbis_block_init(&vd, &vb);
 
@@ -1597,11 +1647,12 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
   }
 
   begin = 0;
-  first = output;
-  shot = SPLT_DEFAULTSHOT;
+  splt_en_detector_init(&detector, threshold, min, output);
 
   oggstate->temp_level = 0.0;
 
+  splt_en_start_levels(state);
+
   short first_time = SPLT_TRUE;
   short is_stream = SPLT_FALSE;
   long stream_time0 = 0;
@@ -1639,6 +1690,7 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
           pos = page_granpos;
         }
         ogg_stream_pagein(&os, &og);
+        state->stats.frames_parsed++;
         while(1)
         {
           result=ogg_stream_packetout(&os, &op);
@@ -1658,68 +1710,27 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
             begin += bs;
             if (vorbis_synthesis(&vb, &op) == 0)
             {
+              state->stats.frames_decoded++;
               vorbis_synthesis_blockin(&vd, &vb);
-              if ((!flush) && (splt_ogg_silence(oggstate, &vd, th))) 
+              double time = (double) pos / oggstate->vi->rate;
+              float peak = flush ? 0 : splt_ogg_silence(oggstate, &vd, fast_scan);
+              int en_err = splt_en_put_block(state, time, peak, oggstate->temp_level);
+              if (en_err < 0)
               {
-                if (len == 0) 
-                {
-                  begin_position = pos;
-                }
-                if (first == 0) 
-                {
-                  len++;
-                }
-                if (shot < SPLT_DEFAULTSHOT)
-                {
-                  shot+=2;
-                }
-                end_position = pos;
+                *error = en_err;
+                found = -1;
+                goto function_end;
               }
-              else 
+              if (splt_en_detector_put(state, &detector, time, peak, flush, error) == -1)
               {
-                if (len > SPLT_DEFAULTSILLEN)
-                {
-                  if ((flush) || (shot <= 0))
-                  {
-                    float b_position, e_position;
-                    double temp;
-                    temp = (double) begin_position;
-                    temp /= oggstate->vi->rate;
-                    b_position = (float) temp;
-                    temp = (double) end_position;
-                    temp /= oggstate->vi->rate;
-                    e_position = (float) temp;
-                    if ((e_position - b_position - min) >= 0.f)
-                    {
-                      int err = SPLT_OK;
-                      if (splt_t_ssplit_new(&state->silence_list, b_position, e_position, len, &err) == -1)
-                      {
-                        found = -1;
-                        goto function_end;
-                      }
-                      found++;
-                    }
-                    len = 0;
-                    shot = SPLT_DEFAULTSHOT;
-                  }
-                } 
-                else 
-                {
-                  len = 0;
-                }
-                if (flush)
-                {
-                  eos = 1;
-                  break;
-                }
-                if ((first) && (shot <= 0))
-                {
-                  first = 0;
-                }
-                if (shot > 0) 
-                {
-                  shot--;
-                }
+                found = -1;
+                goto function_end;
+              }
+              found = detector.found;
+              if (flush)
+              {
+                eos = 1;
+                break;
               }
             }
             else
@@ -1737,10 +1748,6 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
               flush = 1;
             }
           }
-          if (found >= SPLT_MAXSILENCE) 
-          {
-            eos = 1;
-          }
         }
       }
       result = ogg_sync_pageout(&oy, &og);
@@ -1762,34 +1769,25 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
       result = ogg_sync_pageout(&oy, &og);
       //result == -1 is NOT a fatal error
 
-      //if (count++ % X == 0)
+      long time = (long) (((double) pos / oggstate->vi->rate) * 100.0);
+      if (is_stream && stream_time0 == 0)
       {
-        float level = splt_u_convert2dB(oggstate->temp_level);
-        if (state->split.get_silence_level)
+        if (time - old_time > 500)
         {
-          long time = (long) (((double) pos / oggstate->vi->rate) * 100.0);
-          if (is_stream && stream_time0 == 0)
-          {
-            if (time - old_time > 500)
-            {
-              stream_time0 = time;
-            }
-            old_time = time;
-          }
-
-          state->split.get_silence_level(time - stream_time0, level,
-              state->split.silence_level_client_data);
+          stream_time0 = time;
         }
-        state->split.p_bar->silence_db_level = level;
-        state->split.p_bar->silence_found_tracks = found;
+        old_time = time;
+      }
+      splt_en_put_level(state, (time - stream_time0) / 100.0,
+          oggstate->temp_level, found);
+
+      if (splt_t_split_is_canceled(state))
+      {
+        eos = 1;
       }
 
       if (splt_t_get_int_option(state,SPLT_OPT_SPLIT_MODE) == SPLT_OPTION_SILENCE_MODE)
       {
-        if (splt_t_split_is_canceled(state))
-        {
-          eos = 1;
-        }
         splt_t_update_progress(state,(double)pos * 100,
             (double)(oggstate->len),
             1,0,SPLT_DEFAULT_PROGRESS_RATE2);
@@ -1804,13 +1802,20 @@ int splt_ogg_scan_silence(splt_state *state, short seconds,
 
 function_end:
 
+  splt_en_end_levels(state, found);
+
   ogg_stream_clear(&os);
 
   vorbis_block_clear(&vb);
   vorbis_dsp_clear(&vd);
   ogg_sync_clear(&oy);
+  if (fast_scan)
+  {
+    vorbis_synthesis_halfrate(oggstate->vi, 0);
+  }
 
   oggstate->prevW = saveW;
+  state->stats.seeks++;
   if (fseeko(oggstate->in, position, SEEK_SET) == -1)
   {
     splt_t_set_strerror_msg(state);
@@ -1835,7 +1840,7 @@ void splt_pl_set_plugin_info(splt_plugin_info *info, int *error)
   info->version = plugin_version;
 
   //set plugin name
-  info->name = malloc(sizeof(char) * 40);
+  info->name = splt_u_malloc(sizeof(char) * 40);
   if (info->name != NULL)
   {
     snprintf(info->name, 39, "ogg vorbis (libvorbis)");
@@ -1847,7 +1852,7 @@ void splt_pl_set_plugin_info(splt_plugin_info *info, int *error)
   }
 
   //set plugin extension
-  info->extension = malloc(sizeof(char) * (strlen(SPLT_OGGEXT)+2));
+  info->extension = splt_u_malloc(sizeof(char) * (strlen(SPLT_OGGEXT)+2));
   if (info->extension != NULL)
   {
     snprintf(info->extension, strlen(SPLT_OGGEXT)+1, SPLT_OGGEXT);
@@ -1945,16 +1950,33 @@ void splt_pl_end(splt_state *state, int *error)
 double splt_pl_split(splt_state *state, const char *final_fname,
     double begin_point, double end_point, int *error, int save_end_point) 
 {
+  //ogg split files need new headers, they can't be byte ranges
+  if (splt_mf_is_enabled(state))
+  {
+    *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+    return end_point;
+  }
+
+  int phase = splt_st_enter_phase(state, SPLT_PHASE_TAGS);
   splt_ogg_put_tags(state, error);
+  splt_st_leave_phase(state, phase);
 
   if (*error >= 0)
   {
     //effective ogg split
-    return splt_ogg_split(final_fname, state,
+    double end_time = splt_ogg_split(final_fname, state,
         begin_point, end_point,
         !state->options.option_input_not_seekable,
         state->options.parameter_gap,
         state->options.parameter_threshold, error, save_end_point);
+
+    splt_ogg_state *oggstate = state->codec;
+    if (oggstate && oggstate->in && !state->options.option_input_not_seekable)
+    {
+      splt_io_input_consumed(state, oggstate->in, ftello(oggstate->in));
+    }
+
+    return end_time;
   }
 
   return end_point;
@@ -0,0 +1,285 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#include <string.h>
+#include <errno.h>
+
+#ifndef __WIN32__
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#endif
+
+#include "splt.h"
+
+#ifndef __WIN32__
+
+//asynchronous split handle, returned by mp3splt_split_async
+struct splt_async_split {
+  splt_state *state;
+  pthread_t thread;
+  //protects the fields below, shared with the split thread
+  pthread_mutex_t mutex;
+  //pipe becoming readable on progress or completion;
+  //fds[0] is given to the client, fds[1] is written by the split thread
+  int fds[2];
+  //SPLT_TRUE if a byte is waiting in the pipe
+  int notified;
+  int finished;
+  float percent_progress;
+  //copy of the counters of the split, taken at each progress
+  splt_stats stats;
+  //the return value of the split
+  int result;
+  //copy of 'stats' returned to the client, only used by the client
+  splt_stats client_stats;
+};
+
+//writes one byte in the pipe if the client has not been woken up yet
+//-must be called with the mutex locked
+static void splt_as_wake_up(splt_async_split *as)
+{
+  if (!as->notified)
+  {
+    char c = 0;
+    if (write(as->fds[1], &c, 1) == 1)
+    {
+      as->notified = SPLT_TRUE;
+    }
+  }
+}
+
+static void *splt_as_split_thread(void *data)
+{
+  splt_async_split *as = data;
+  int error = SPLT_OK;
+
+  splt_s_split_file(as->state, &error);
+
+  pthread_mutex_lock(&as->mutex);
+  as->stats = as->state->stats;
+  as->result = error;
+  as->finished = SPLT_TRUE;
+  splt_as_wake_up(as);
+  pthread_mutex_unlock(&as->mutex);
+
+  return NULL;
+}
+
+static int splt_as_set_non_blocking(int fd)
+{
+  int flags = fcntl(fd, F_GETFL);
+  if (flags == -1)
+  {
+    return -1;
+  }
+
+  return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+//starts the split of the state in a new thread
+//-the library must be locked by the caller
+//-returns NULL if error
+splt_async_split *splt_as_start(splt_state *state, int *error)
+{
+  splt_async_split *as = splt_u_malloc(sizeof(splt_async_split));
+  if (as == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
+  }
+  memset(as, 0x0, sizeof(splt_async_split));
+
+  as->state = state;
+  as->result = SPLT_OK;
+
+  if (pipe(as->fds) == -1)
+  {
+    goto start_error;
+  }
+
+  if ((splt_as_set_non_blocking(as->fds[0]) == -1) ||
+      (splt_as_set_non_blocking(as->fds[1]) == -1))
+  {
+    goto pipe_error;
+  }
+
+  if ((errno = pthread_mutex_init(&as->mutex, NULL)) != 0)
+  {
+    goto pipe_error;
+  }
+
+  state->async = as;
+
+  if ((errno = pthread_create(&as->thread, NULL, splt_as_split_thread, as)) != 0)
+  {
+    state->async = NULL;
+    pthread_mutex_destroy(&as->mutex);
+    goto pipe_error;
+  }
+
+  return as;
+
+pipe_error:
+  splt_t_set_strerror_msg(state);
+  close(as->fds[0]);
+  close(as->fds[1]);
+  free(as);
+  *error = SPLT_ERROR_CANNOT_START_ASYNC_SPLIT;
+  return NULL;
+
+start_error:
+  splt_t_set_strerror_msg(state);
+  free(as);
+  *error = SPLT_ERROR_CANNOT_START_ASYNC_SPLIT;
+  return NULL;
+}
+
+splt_state *splt_as_get_state(splt_async_split *as)
+{
+  return as->state;
+}
+
+int splt_as_get_fd(splt_async_split *as)
+{
+  return as->fds[0];
+}
+
+//drains the pipe and returns SPLT_ASYNC_RUNNING or SPLT_ASYNC_FINISHED
+int splt_as_get_status(splt_async_split *as, float *percent_progress)
+{
+  int status = SPLT_ASYNC_RUNNING;
+  char buffer[16];
+
+  pthread_mutex_lock(&as->mutex);
+
+  while (read(as->fds[0], buffer, sizeof(buffer)) > 0)
+  {
+    ;
+  }
+  as->notified = SPLT_FALSE;
+
+  if (percent_progress != NULL)
+  {
+    *percent_progress = as->percent_progress;
+  }
+
+  if (as->finished)
+  {
+    status = SPLT_ASYNC_FINISHED;
+  }
+
+  pthread_mutex_unlock(&as->mutex);
+
+  return status;
+}
+
+//called from the split thread by splt_t_update_progress
+void splt_as_put_progress(splt_async_split *as, float percent_progress)
+{
+  splt_st_update(as->state);
+
+  pthread_mutex_lock(&as->mutex);
+  as->percent_progress = percent_progress;
+  as->stats = as->state->stats;
+  splt_as_wake_up(as);
+  pthread_mutex_unlock(&as->mutex);
+}
+
+//returns a copy of the counters of the split, for the client
+const splt_stats *splt_as_get_stats(splt_async_split *as)
+{
+  pthread_mutex_lock(&as->mutex);
+  as->client_stats = as->stats;
+  pthread_mutex_unlock(&as->mutex);
+
+  return &as->client_stats;
+}
+
+//waits for the end of the split, frees the handle and
+//returns the split result
+int splt_as_join(splt_async_split *as)
+{
+  pthread_join(as->thread, NULL);
+
+  int result = as->result;
+
+  as->state->async = NULL;
+  pthread_mutex_destroy(&as->mutex);
+  close(as->fds[0]);
+  close(as->fds[1]);
+  free(as);
+
+  return result;
+}
+
+#else
+
+//no threads on windows for the moment
+splt_async_split *splt_as_start(splt_state *state, int *error)
+{
+  *error = SPLT_ERROR_CANNOT_START_ASYNC_SPLIT;
+  return NULL;
+}
+
+splt_state *splt_as_get_state(splt_async_split *as)
+{
+  return NULL;
+}
+
+int splt_as_get_fd(splt_async_split *as)
+{
+  return -1;
+}
+
+int splt_as_get_status(splt_async_split *as, float *percent_progress)
+{
+  return SPLT_ASYNC_FINISHED;
+}
+
+void splt_as_put_progress(splt_async_split *as, float percent_progress)
+{
+}
+
+const splt_stats *splt_as_get_stats(splt_async_split *as)
+{
+  return NULL;
+}
+
+int splt_as_join(splt_async_split *as)
+{
+  return SPLT_ERROR_CANNOT_START_ASYNC_SPLIT;
+}
+
+#endif
+
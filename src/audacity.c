@@ -83,7 +83,7 @@ int splt_audacity_put_splitpoints(const char *file, splt_state *state, int *erro
 
   *error = SPLT_AUDACITY_OK;
 
-  char *client_infos = malloc(sizeof(char) * (strlen(file)+200));
+  char *client_infos = splt_u_malloc(sizeof(char) * (strlen(file)+200));
   if (client_infos == NULL)
   {
     *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -164,7 +164,7 @@ int splt_audacity_put_splitpoints(const char *file, splt_state *state, int *erro
       free(label_name);
       label_name = NULL;
     }
-    label_name = strdup(ptr);
+    label_name = splt_u_strdup(ptr);
     if (!label_name)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -184,7 +184,7 @@ int splt_audacity_put_splitpoints(const char *file, splt_state *state, int *erro
       free(last_label_name);
       last_label_name = NULL;
     }
-    last_label_name = strdup(label_name);
+    last_label_name = splt_u_strdup(label_name);
     if (!last_label_name)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
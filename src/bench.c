@@ -0,0 +1,533 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+//benchmark of the split modes on generated fixtures
+//-built and run with 'make bench', it is not installed
+//-usage: mp3splt_bench plugins_directory work_directory
+//-if the MP3SPLT_BENCH_OGG environment variable points to an ogg vorbis
+//file, the ogg plugin is also measured on it
+//-prints one tab separated line for each case on the standard output
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "mp3splt.h"
+
+//the fixtures are mpeg 1 layer 3, 48kHz mono
+//-at 48kHz a frame of 1152 samples lasts exactly 24 milliseconds and
+//its length in bytes is 3 * bitrate in kbps, without padding
+#define BENCH_FRAMES_PER_TRACK 1875
+#define BENCH_SILENT_FRAMES 125
+#define BENCH_TRACKS 8
+#define BENCH_TRACK_HUNDREDTHS 4800
+#define BENCH_WRAPPED_FILES 4
+//number of 4 lines quadruples in the count1 region of a loud granule
+#define BENCH_LOUD_QUADS 40
+#define BENCH_LOUD_GLOBAL_GAIN 190
+#define BENCH_GARBAGE_BYTES 500
+
+#define BENCH_MAX_FRAME 960
+
+static const int bench_bitrates[15] =
+{ 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+
+//deterministic generator, the fixtures are identical on each run
+static unsigned long bench_seed = 1;
+
+static unsigned long bench_random()
+{
+  bench_seed = bench_seed * 1103515245 + 12345;
+  return (bench_seed >> 16) & 0x7FFF;
+}
+
+//writes the 'n' lower bits of 'value' at the bit position '*pos'
+static void bench_put_bits(unsigned char *buffer, int *pos,
+    unsigned long value, int n)
+{
+  int i = 0;
+  for (i = n - 1;i >= 0;i--)
+  {
+    if ((value >> i) & 1)
+    {
+      buffer[*pos / 8] |= 0x80 >> (*pos % 8);
+    }
+    (*pos)++;
+  }
+}
+
+//builds a frame in 'frame' and returns its length
+//-a loud frame has a count1 region of ones with random signs,
+//a silent frame has no main data
+static int bench_build_frame(unsigned char *frame, int bitrate_index, int loud)
+{
+  int length = 3 * bench_bitrates[bitrate_index];
+  int pos = 0;
+  int granule = 0;
+  int i = 0;
+
+  memset(frame, 0, length);
+
+  //sync, mpeg 1, layer 3, no crc, 48kHz, no padding, mono
+  bench_put_bits(frame, &pos, 0xFFFB, 16);
+  bench_put_bits(frame, &pos, bitrate_index, 4);
+  bench_put_bits(frame, &pos, 1, 2);
+  bench_put_bits(frame, &pos, 0, 2);
+  bench_put_bits(frame, &pos, 3, 2);
+  bench_put_bits(frame, &pos, 0, 6);
+
+  //side info: main_data_begin, private bits, scfsi
+  bench_put_bits(frame, &pos, 0, 9 + 5 + 4);
+  for (granule = 0;granule < 2;granule++)
+  {
+    //part2_3_length, big_values, global_gain
+    bench_put_bits(frame, &pos, loud ? BENCH_LOUD_QUADS * 8 : 0, 12);
+    bench_put_bits(frame, &pos, 0, 9);
+    bench_put_bits(frame, &pos, loud ? BENCH_LOUD_GLOBAL_GAIN : 0, 8);
+    //scalefac_compress, window switching, table select, region counts,
+    //preflag, scalefac_scale
+    bench_put_bits(frame, &pos, 0, 4 + 1 + 15 + 4 + 3 + 1 + 1);
+    //count1 table B: the code of a quadruple of ones is 0000
+    bench_put_bits(frame, &pos, 1, 1);
+  }
+
+  if (loud)
+  {
+    for (granule = 0;granule < 2;granule++)
+    {
+      for (i = 0;i < BENCH_LOUD_QUADS;i++)
+      {
+        bench_put_bits(frame, &pos, 0, 4);
+        bench_put_bits(frame, &pos, bench_random() & 0xF, 4);
+      }
+    }
+  }
+
+  return length;
+}
+
+//the bitrate of the next frame
+static int bench_bitrate_index(int vbr)
+{
+  if (vbr)
+  {
+    return 5 + (int) (bench_random() % 10);
+  }
+
+  return 9;
+}
+
+//writes 'number_of_tracks' tracks of loud frames separated by silences
+//-if 'garbage' is set, random bytes are put between the tracks
+//-returns the number of frames written
+static long bench_write_tracks(FILE *out, int number_of_tracks,
+    int vbr, int garbage)
+{
+  unsigned char frame[BENCH_MAX_FRAME];
+  long frames = 0;
+  int track = 0;
+  int i = 0;
+
+  for (track = 0;track < number_of_tracks;track++)
+  {
+    for (i = 0;i < BENCH_FRAMES_PER_TRACK + BENCH_SILENT_FRAMES;i++)
+    {
+      int loud = (i >= BENCH_SILENT_FRAMES / 2) &&
+        (i < BENCH_FRAMES_PER_TRACK + BENCH_SILENT_FRAMES / 2);
+      int length = bench_build_frame(frame, bench_bitrate_index(vbr), loud);
+      fwrite(frame, 1, length, out);
+      frames++;
+    }
+
+    if (garbage && (track < number_of_tracks - 1))
+    {
+      for (i = 0;i < BENCH_GARBAGE_BYTES;i++)
+      {
+        fputc(bench_random() & 0x7F, out);
+      }
+    }
+  }
+
+  return frames;
+}
+
+static void bench_put_word(unsigned char *buffer, unsigned long word)
+{
+  buffer[0] = (word >> 24) & 0xFF;
+  buffer[1] = (word >> 16) & 0xFF;
+  buffer[2] = (word >> 8) & 0xFF;
+  buffer[3] = word & 0xFF;
+}
+
+//vbr file starting with a Xing header frame
+static int bench_write_vbr(const char *filename)
+{
+  FILE *out = fopen(filename, "wb+");
+  if (out == NULL) { return -1; }
+
+  unsigned char frame[BENCH_MAX_FRAME];
+  int length = bench_build_frame(frame, 9, 0);
+  fwrite(frame, 1, length, out);
+
+  long frames = bench_write_tracks(out, BENCH_TRACKS, 1, 0);
+  long bytes = ftell(out);
+
+  //Xing header after the side info: tag, flags, frames and bytes
+  memcpy(frame + 21, "Xing", 4);
+  bench_put_word(frame + 25, 0x3);
+  bench_put_word(frame + 29, frames);
+  bench_put_word(frame + 33, bytes);
+  fseek(out, 0, SEEK_SET);
+  fwrite(frame, 1, length, out);
+
+  return fclose(out);
+}
+
+static int bench_write_cbr(const char *filename, int garbage)
+{
+  FILE *out = fopen(filename, "wb");
+  if (out == NULL) { return -1; }
+
+  bench_write_tracks(out, BENCH_TRACKS, 0, garbage);
+
+  return fclose(out);
+}
+
+static unsigned long bench_crc(unsigned long crc, const unsigned char *buffer,
+    long length)
+{
+  long i = 0;
+  int bit = 0;
+  for (i = 0;i < length;i++)
+  {
+    crc ^= buffer[i];
+    for (bit = 0;bit < 8;bit++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320UL : 0);
+    }
+  }
+  return crc;
+}
+
+//mp3wrap archive: a first frame holding the index in its ancillary
+//data, then the wrapped files
+//-the offsets of the index are relative to the 'WRAP' string and
+//the crc covers everything after it up to the end of the file
+static int bench_write_wrap(const char *filename)
+{
+  FILE *out = fopen(filename, "wb+");
+  if (out == NULL) { return -1; }
+
+  unsigned char frame[BENCH_MAX_FRAME];
+  int length = bench_build_frame(frame, 9, 0);
+  int wrap_offset = 21;
+  unsigned char *index = frame + wrap_offset;
+
+  memcpy(index, "WRAP", 4);
+  index[4] = '0';
+  index[5] = '5';
+  index[6] = 1;
+  index[7] = BENCH_WRAPPED_FILES;
+  int pos = 12;
+
+  off_t offset = length - wrap_offset;
+  bench_put_word(index + pos, offset);
+  pos += 4;
+
+  int i = 0;
+  for (i = 0;i < BENCH_WRAPPED_FILES;i++)
+  {
+    pos += snprintf((char *) index + pos, 32, "wrapped_%d.mp3", i + 1) + 1;
+    offset += (off_t) (BENCH_FRAMES_PER_TRACK + BENCH_SILENT_FRAMES)
+      * 3 * bench_bitrates[9];
+    bench_put_word(index + pos, offset);
+    pos += 4;
+  }
+
+  fwrite(frame, 1, length, out);
+  for (i = 0;i < BENCH_WRAPPED_FILES;i++)
+  {
+    bench_write_tracks(out, 1, 0, 0);
+  }
+
+  //crc of the data following the crc word
+  unsigned char buffer[8192];
+  size_t readed = 0;
+  unsigned long crc = 0xFFFFFFFF;
+  fseek(out, wrap_offset + 12, SEEK_SET);
+  while ((readed = fread(buffer, 1, sizeof(buffer), out)) > 0)
+  {
+    crc = bench_crc(crc, buffer, readed);
+  }
+  bench_put_word(buffer, crc ^ 0xFFFFFFFF);
+  fseek(out, wrap_offset + 8, SEEK_SET);
+  fwrite(buffer, 1, 4, out);
+
+  return fclose(out);
+}
+
+/****************************/
+/* benchmark cases */
+
+typedef struct {
+  const char *name;
+  const char *fixture;
+  int split_mode;
+  int auto_adjust;
+  int not_seekable;
+  int splitpoints;
+} bench_case;
+
+static const bench_case bench_cases[] =
+{
+  { "normal_cbr", "cbr.mp3", SPLT_OPTION_NORMAL_MODE, 0, 0, 1 },
+  { "normal_vbr", "vbr.mp3", SPLT_OPTION_NORMAL_MODE, 0, 0, 1 },
+  { "time_cbr", "cbr.mp3", SPLT_OPTION_TIME_MODE, 0, 0, 0 },
+  { "length_vbr", "vbr.mp3", SPLT_OPTION_LENGTH_MODE, 0, 0, 0 },
+  { "silence_cbr", "cbr.mp3", SPLT_OPTION_SILENCE_MODE, 0, 0, 0 },
+  { "silence_vbr", "vbr.mp3", SPLT_OPTION_SILENCE_MODE, 0, 0, 0 },
+  { "error_syncerrors", "syncerrors.mp3", SPLT_OPTION_ERROR_MODE, 0, 0, 0 },
+  { "wrap", "wrap.mp3", SPLT_OPTION_WRAP_MODE, 0, 0, 0 },
+  { "auto_adjust_vbr", "vbr.mp3", SPLT_OPTION_NORMAL_MODE, 1, 0, 1 },
+  { "stdin_cbr", "cbr.mp3", SPLT_OPTION_NORMAL_MODE, 0, 1, 1 },
+  { "normal_ogg", NULL, SPLT_OPTION_NORMAL_MODE, 0, 0, 1 },
+  { "silence_ogg", NULL, SPLT_OPTION_SILENCE_MODE, 0, 0, 0 },
+};
+
+#define BENCH_NUMBER_OF_CASES (sizeof(bench_cases) / sizeof(bench_case))
+
+//monotonic time in seconds, not changed by clock adjustments
+static double bench_time()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+//removes the files of 'dir' and returns how many there were
+static int bench_clean_dir(const char *dir)
+{
+  int files = 0;
+  DIR *d = opendir(dir);
+  if (d == NULL)
+  {
+    return 0;
+  }
+
+  struct dirent *entry = NULL;
+  char path[2048] = { '\0' };
+  while ((entry = readdir(d)) != NULL)
+  {
+    if (entry->d_name[0] == '.')
+    {
+      continue;
+    }
+    snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+    if (unlink(path) == 0)
+    {
+      files++;
+    }
+  }
+  closedir(d);
+
+  return files;
+}
+
+//runs one case in the current process and prints its results
+static int bench_run_case(const bench_case *bc, const char *fixture,
+    const char *plugins_dir, const char *out_dir)
+{
+  int error = SPLT_OK;
+  double seconds = 0;
+  double megabytes = 0;
+  int files = 0;
+
+  struct stat st;
+  if (stat(fixture, &st) == 0)
+  {
+    megabytes = st.st_size / (1024.0 * 1024.0);
+  }
+
+  splt_state *state = mp3splt_new_state(&error);
+  if (error < 0) { goto end; }
+
+  mp3splt_append_plugins_scan_dir(state, (char *) plugins_dir);
+  error = mp3splt_find_plugins(state);
+  if (error < 0) { goto end; }
+
+  bench_clean_dir(out_dir);
+  mp3splt_set_path_of_split(state, out_dir);
+  mp3splt_set_int_option(state, SPLT_OPT_SPLIT_MODE, bc->split_mode);
+  mp3splt_set_int_option(state, SPLT_OPT_AUTO_ADJUST, bc->auto_adjust);
+  mp3splt_set_float_option(state, SPLT_OPT_SPLIT_TIME, 3000);
+  mp3splt_set_int_option(state, SPLT_OPT_LENGTH_SPLIT_FILE_NUMBER, BENCH_TRACKS);
+
+  if (bc->not_seekable)
+  {
+    if (freopen(fixture, "rb", stdin) == NULL)
+    {
+      error = SPLT_ERROR_CANNOT_OPEN_FILE;
+      goto end;
+    }
+    mp3splt_set_filename_to_split(state, "-");
+  }
+  else
+  {
+    mp3splt_set_filename_to_split(state, fixture);
+  }
+
+  if (bc->splitpoints)
+  {
+    int i = 0;
+    for (i = 0;i <= BENCH_TRACKS;i++)
+    {
+      mp3splt_append_splitpoint(state, i * BENCH_TRACK_HUNDREDTHS, NULL,
+          SPLT_SPLITPOINT);
+    }
+  }
+
+  double begin = bench_time();
+  error = mp3splt_split(state);
+  seconds = bench_time() - begin;
+
+  files = bench_clean_dir(out_dir);
+
+end:
+  if (state)
+  {
+    mp3splt_free_state(state, NULL);
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  fprintf(stdout, "%s\t%s\t%d\t%d\t%.3f\t%.2f\t%.2f\t%ld\n",
+      bc->name, fixture, error, files, seconds,
+      (error >= 0 && seconds > 0) ? megabytes / seconds : 0,
+      (error >= 0 && files > 0) ? seconds * 1000 / files : 0,
+      usage.ru_maxrss);
+  fflush(stdout);
+
+  return error;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "usage: %s plugins_directory work_directory\n", argv[0]);
+    return 1;
+  }
+
+  const char *plugins_dir = argv[1];
+  const char *work_dir = argv[2];
+  const char *ogg_fixture = getenv("MP3SPLT_BENCH_OGG");
+
+  char cbr[2048], vbr[2048], syncerrors[2048], wrap[2048], out_dir[2048];
+  snprintf(cbr, sizeof(cbr), "%s/cbr.mp3", work_dir);
+  snprintf(vbr, sizeof(vbr), "%s/vbr.mp3", work_dir);
+  snprintf(syncerrors, sizeof(syncerrors), "%s/syncerrors.mp3", work_dir);
+  snprintf(wrap, sizeof(wrap), "%s/wrap.mp3", work_dir);
+  snprintf(out_dir, sizeof(out_dir), "%s/out", work_dir);
+
+  mkdir(work_dir, 0755);
+  mkdir(out_dir, 0755);
+
+  bench_seed = 1;
+  if ((bench_write_cbr(cbr, 0) != 0) ||
+      (bench_write_vbr(vbr) != 0) ||
+      (bench_write_cbr(syncerrors, 1) != 0) ||
+      (bench_write_wrap(wrap) != 0))
+  {
+    fprintf(stderr, "%s: cannot create the fixtures in %s: %s\n",
+        argv[0], work_dir, strerror(errno));
+    return 1;
+  }
+
+  fprintf(stdout, "#case\tfile\tresult\tfiles\tseconds\tmb_per_s\tms_per_file\tpeak_rss_kb\n");
+  fflush(stdout);
+
+  int failed = 0;
+  size_t i = 0;
+  for (i = 0;i < BENCH_NUMBER_OF_CASES;i++)
+  {
+    const bench_case *bc = &bench_cases[i];
+
+    char fixture[2048] = { '\0' };
+    if (bc->fixture != NULL)
+    {
+      snprintf(fixture, sizeof(fixture), "%s/%s", work_dir, bc->fixture);
+    }
+    else if (ogg_fixture != NULL)
+    {
+      snprintf(fixture, sizeof(fixture), "%s", ogg_fixture);
+    }
+    else
+    {
+      continue;
+    }
+
+    //each case runs in its own process to measure its peak memory
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+      exit(bench_run_case(bc, fixture, plugins_dir, out_dir) < 0 ? 1 : 0);
+    }
+    else if (pid > 0)
+    {
+      int status = 0;
+      if ((waitpid(pid, &status, 0) == -1) ||
+          !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+      {
+        fprintf(stderr, "%s: case %s failed\n", argv[0], bc->name);
+        failed++;
+      }
+    }
+    else
+    {
+      fprintf(stderr, "%s: cannot run the case %s: %s\n",
+          argv[0], bc->name, strerror(errno));
+      failed++;
+    }
+  }
+
+  return failed > 0 ? 1 : 0;
+}
@@ -47,7 +47,7 @@ int splt_cddb_put_splitpoints(const char *file, splt_state *state, int *error)
 
   *error = SPLT_CDDB_OK;
 
-  char *client_infos = malloc(sizeof(char) * (strlen(file)+200));
+  char *client_infos = splt_u_malloc(sizeof(char) * (strlen(file)+200));
   //put information to client
   if (client_infos == NULL)
   {
@@ -458,7 +458,7 @@ int splt_cddb_put_splitpoints(const char *file, splt_state *state, int *error)
               }
 
               //put artist info to client
-              client_infos = malloc(sizeof(char) * (strlen(artist)+30));
+              client_infos = splt_u_malloc(sizeof(char) * (strlen(artist)+30));
               if (client_infos == NULL)
               {
                 *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -484,7 +484,7 @@ int splt_cddb_put_splitpoints(const char *file, splt_state *state, int *error)
               album = splt_tu_get_tags_char_field(state,0, SPLT_TAGS_ALBUM);
 
               //put album info to client
-              client_infos = malloc(sizeof(char) * (strlen(album)+30));
+              client_infos = splt_u_malloc(sizeof(char) * (strlen(album)+30));
               if (client_infos == NULL)
               {
                 *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
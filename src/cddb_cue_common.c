@@ -103,7 +103,7 @@ void splt_tag_put_filenames_from_tags(splt_state *state,
     if (format != NULL)
     {
       //we put the outputted filename
-      char *old_format = strdup(format);
+      char *old_format = splt_u_strdup(format);
       if (old_format != NULL)
       {
         splt_t_set_oformat(state, old_format,&err_format, SPLT_TRUE);
@@ -182,7 +182,7 @@ char *splt_check_put_dir_of_cur_song(const char *filename,
       length_malloc = 8;
     }
 
-    if ((filename_path = malloc(length_malloc)) == NULL)
+    if ((filename_path = splt_u_malloc(length_malloc)) == NULL)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
       return NULL;
@@ -205,7 +205,7 @@ char *splt_check_put_dir_of_cur_song(const char *filename,
   }
   else
   {
-    char *new_filename_path = strdup(the_filename_path);
+    char *new_filename_path = splt_u_strdup(the_filename_path);
     if (new_filename_path == NULL)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -295,10 +295,11 @@ void splt_check_set_correct_options(splt_state *state)
     splt_t_set_int_option(state,SPLT_OPT_PARAM_GAP, 0);
   }
 
-  //if seekable and (silence or adjust or wrap or err sync)
+  //if seekable and (adjust or wrap or err sync); the silence mode
+  //can stream non seekable input
   if ((splt_t_get_int_option(state,SPLT_OPT_INPUT_NOT_SEEKABLE)) &&
-      (splt_t_get_int_option(state,SPLT_OPT_AUTO_ADJUST) ||
-       (split_mode == SPLT_OPTION_SILENCE_MODE) ||
+      ((splt_t_get_int_option(state,SPLT_OPT_AUTO_ADJUST) &&
+        (split_mode != SPLT_OPTION_SILENCE_MODE)) ||
        (split_mode == SPLT_OPTION_ERROR_MODE) ||
        (split_mode == SPLT_OPTION_WRAP_MODE)))
   {
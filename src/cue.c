@@ -75,7 +75,7 @@ static int splt_cue_set_value(splt_state *state, char *in,
 		}
 
 		char *out = NULL;
-		if ((out = malloc(strlen(ptr_b)+1)) == NULL)
+		if ((out = splt_u_malloc(strlen(ptr_b)+1)) == NULL)
 		{
 			error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
 		}
@@ -85,7 +85,7 @@ static int splt_cue_set_value(splt_state *state, char *in,
 			int tags_err = SPLT_OK;
 
 			//put Artist + Album info to client
-			char *client_infos = malloc(sizeof(char) * (strlen(out)+30));
+			char *client_infos = splt_u_malloc(sizeof(char) * (strlen(out)+30));
 			if (client_infos == NULL)
 			{
 				error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -139,7 +139,7 @@ int splt_cue_put_splitpoints(const char *file, splt_state *state, int *error)
   //default no error
   *error = SPLT_CUE_OK;
   
-  char *client_infos = malloc(sizeof(char) * (strlen(file)+200));
+  char *client_infos = splt_u_malloc(sizeof(char) * (strlen(file)+200));
   //put information to client
   if (client_infos == NULL)
   {
@@ -468,7 +468,7 @@ void splt_cue_export_to_file(splt_state *state, const char *out_file,
 
   splt_u_print_debug(state, "cue output file without output path = ",0, out_file);
 
-  char *dup_out_file = strdup(out_file);
+  char *dup_out_file = splt_u_strdup(out_file);
   if (!dup_out_file) { *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; goto end; };
   char *cue_out_file = splt_u_get_file_with_output_path(state, dup_out_file, error);
   free(dup_out_file);
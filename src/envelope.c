@@ -0,0 +1,710 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include "splt.h"
+
+//the envelope cache file, native endianness:
+// "SPLTENV2", byte order mark (4 bytes),
+// input file size (8 bytes), input file mtime (8 bytes),
+// input file hash (8 bytes), scan quality flags (4 bytes),
+// threshold of the full quality recheck (4 bytes), number of blocks (8 bytes),
+// then the times, the peaks and the levels of all the blocks
+
+#define SPLT_ENVELOPE_MAGIC "SPLTENV2"
+#define SPLT_ENVELOPE_BOM 0x01020304
+//scan quality flags of the cache
+#define SPLT_ENVELOPE_FAST_SCAN 1
+#define SPLT_ENVELOPE_RECHECKED 2
+
+//number of bytes hashed at the start and at the end of the input file
+#define SPLT_ENVELOPE_HASHED_BYTES (1024 * 1024)
+#define SPLT_ENVELOPE_ALLOC 4096
+
+//range of the auto threshold histogram, in dB
+#define SPLT_AUTO_THRESHOLD_MIN -96
+#define SPLT_AUTO_THRESHOLD_BINS 97
+//minimum dB between the noise floor and the music
+#define SPLT_AUTO_THRESHOLD_GAP 6
+
+/********************************/
+/* silence detection */
+
+//starts a new silence detection
+//'threshold' is in dB, 'min' is the minimum silence length in seconds;
+//if 'output' is set, we don't take the silence at the start of the scan
+void splt_en_detector_init(splt_silence_detector *detector,
+    float threshold, float min, short output)
+{
+  detector->threshold = splt_u_convertfromdB(threshold);
+  detector->min = min;
+  detector->first = output;
+  detector->shot = SPLT_DEFAULTSHOT;
+  detector->len = 0;
+  detector->silence_begin = 0;
+  detector->silence_end = 0;
+  detector->found = 0;
+}
+
+//puts the next decoded block, at 'time' seconds and with the 'peak'
+//highest sample, in the detection; with 'flush', the current
+//silence is ended
+//returns -1 if error, 0 otherwise
+int splt_en_detector_put(splt_state *state, splt_silence_detector *detector,
+    double time, float peak, short flush, int *error)
+{
+  if ((!flush) && (peak <= detector->threshold))
+  {
+    if (detector->len == 0)
+    {
+      detector->silence_begin = time;
+    }
+    if (detector->first == 0)
+    {
+      detector->len++;
+    }
+    if (detector->shot < SPLT_DEFAULTSHOT)
+    {
+      detector->shot += 2;
+    }
+    detector->silence_end = time;
+
+    return 0;
+  }
+
+  if (detector->len > SPLT_DEFAULTSILLEN)
+  {
+    if ((flush) || (detector->shot <= 0))
+    {
+      double begin_position = detector->silence_begin;
+      double end_position = detector->silence_end;
+
+      if ((end_position - begin_position - detector->min) >= 0.f)
+      {
+        int len = (int) ((end_position - begin_position) * 100 + 0.5);
+        if (splt_t_ssplit_new(&state->silence_list, begin_position, end_position,
+              len, error) == -1)
+        {
+          return -1;
+        }
+        detector->found++;
+      }
+
+      detector->len = 0;
+      detector->shot = SPLT_DEFAULTSHOT;
+    }
+  }
+  else
+  {
+    detector->len = 0;
+  }
+
+  if ((detector->first) && (detector->shot <= 0))
+  {
+    detector->first = 0;
+  }
+
+  if (detector->shot > 0)
+  {
+    detector->shot--;
+  }
+
+  return 0;
+}
+
+/********************************/
+/* envelope */
+
+//frees the envelope
+void splt_en_free(splt_state *state)
+{
+  splt_envelope *envelope = &state->envelope;
+
+  if (envelope->time)
+  {
+    free(envelope->time);
+    envelope->time = NULL;
+  }
+  if (envelope->peak)
+  {
+    free(envelope->peak);
+    envelope->peak = NULL;
+  }
+  if (envelope->level)
+  {
+    free(envelope->level);
+    envelope->level = NULL;
+  }
+  envelope->number = 0;
+  envelope->allocated = 0;
+  envelope->recording = SPLT_FALSE;
+}
+
+//allocates space for 'number' blocks
+static int splt_en_alloc(splt_envelope *envelope, long number)
+{
+  double *time = splt_u_realloc(envelope->time, sizeof(double) * number);
+  if (time == NULL) { return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; }
+  envelope->time = time;
+
+  float *peak = splt_u_realloc(envelope->peak, sizeof(float) * number);
+  if (peak == NULL) { return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; }
+  envelope->peak = peak;
+
+  float *level = splt_u_realloc(envelope->level, sizeof(float) * number);
+  if (level == NULL) { return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; }
+  envelope->level = level;
+
+  envelope->allocated = number;
+
+  return SPLT_OK;
+}
+
+//sends the level of the current entry to the client
+static void splt_en_flush_level(splt_state *state, int found)
+{
+  splt_silence_levels *levels = &state->split.silence_levels;
+  if (levels->current < 0)
+  {
+    return;
+  }
+
+  float level = splt_u_convert2dB(levels->current_max);
+
+  if (levels->current < levels->number)
+  {
+    levels->levels[levels->current] = level;
+    if (levels->current >= levels->filled)
+    {
+      levels->filled = levels->current + 1;
+    }
+  }
+
+  if (state->split.get_silence_level)
+  {
+    long time = (long) (levels->current * levels->resolution * 100.0);
+    state->split.get_silence_level(time, level,
+        state->split.silence_level_client_data);
+  }
+
+  state->split.p_bar->silence_db_level = level;
+  state->split.p_bar->silence_found_tracks = found;
+
+  levels->current = -1;
+}
+
+//starts a new scan of the silence levels
+void splt_en_start_levels(splt_state *state)
+{
+  state->split.silence_levels.filled = 0;
+  state->split.silence_levels.current = -1;
+  state->split.silence_levels.current_end = -1;
+}
+
+//puts the linear level of a decoded block at 'time' seconds; only the
+//highest level of each entry is converted to dB and sent to the client
+void splt_en_put_level(splt_state *state, double time, float level, int found)
+{
+  splt_silence_levels *levels = &state->split.silence_levels;
+
+  time += state->envelope.time_offset;
+  if (time < levels->current_end)
+  {
+    if (level > levels->current_max)
+    {
+      levels->current_max = level;
+    }
+    return;
+  }
+
+  splt_en_flush_level(state, found);
+
+  levels->current = (long) (time / levels->resolution);
+  levels->current_end = (levels->current + 1) * levels->resolution;
+  levels->current_max = level;
+}
+
+//sends the last entry at the end of a scan
+void splt_en_end_levels(splt_state *state, int found)
+{
+  splt_en_flush_level(state, found);
+  state->split.silence_levels.current_end = -1;
+}
+
+//starts recording the decoded blocks in the envelope
+void splt_en_start_recording(splt_state *state)
+{
+  splt_en_free(state);
+  state->envelope.recording = SPLT_TRUE;
+  state->envelope.time_offset = 0;
+  state->envelope.fast_scan =
+    splt_t_get_int_option(state, SPLT_OPT_FAST_SCAN);
+  state->envelope.rechecked = SPLT_FALSE;
+  state->envelope.scan_threshold =
+    splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD);
+}
+
+//records a decoded block if we are recording
+//returns possible error
+int splt_en_put_block(splt_state *state, double time, float peak, float level)
+{
+  splt_envelope *envelope = &state->envelope;
+
+  if (!envelope->recording)
+  {
+    return SPLT_OK;
+  }
+
+  if (envelope->number >= envelope->allocated)
+  {
+    long allocated = SPLT_ENVELOPE_ALLOC;
+    if (envelope->allocated > 0)
+    {
+      allocated = envelope->allocated * 2;
+    }
+
+    int error = splt_en_alloc(envelope, allocated);
+    if (error < 0)
+    {
+      return error;
+    }
+  }
+
+  envelope->time[envelope->number] = time + envelope->time_offset;
+  envelope->peak[envelope->number] = peak;
+  envelope->level[envelope->number] = level;
+  envelope->number++;
+
+  return SPLT_OK;
+}
+
+//replays the detection from block 'first'; the times are relative to
+//'begin' and the detection is flushed after 'length' seconds (if > 0)
+static int splt_en_replay(splt_state *state, long first, double begin,
+    double length, float threshold, float min, short output, int *error)
+{
+  splt_envelope *envelope = &state->envelope;
+  splt_silence_detector detector;
+  splt_en_detector_init(&detector, threshold, min, output);
+
+  long i = 0;
+  for (i = first;i < envelope->number;i++)
+  {
+    double time = envelope->time[i] - begin;
+    short flush = (length > 0) && (time >= length);
+
+    if (splt_en_detector_put(state, &detector, time,
+          envelope->peak[i], flush, error) == -1)
+    {
+      return -1;
+    }
+
+    if (flush)
+    {
+      break;
+    }
+  }
+
+  return detector.found;
+}
+
+//detects the silences from the envelope, as a full scan would do,
+//and puts them in the silence list
+//returns the number of silences found, or -1 if error
+int splt_en_detect_silence(splt_state *state, float threshold,
+    float min, int *error)
+{
+  return splt_en_replay(state, 0, 0, 0, threshold, min, SPLT_TRUE, error);
+}
+
+//chooses a silence threshold (dB) from the histogram of the peaks of the
+//envelope: the threshold is the valley between the noise floor and the
+//music; with 'number_tracks', it is the lowest threshold giving at least
+//'number_tracks' tracks
+float splt_en_auto_threshold(splt_state *state, float min,
+    int number_tracks, int *error)
+{
+  splt_envelope *envelope = &state->envelope;
+
+  if (number_tracks > 0)
+  {
+    float threshold = 0;
+    for (threshold = SPLT_AUTO_THRESHOLD_MIN;threshold <= 0;threshold += 1)
+    {
+      int found = splt_en_detect_silence(state, threshold, min, error);
+      splt_t_ssplit_free(&state->silence_list);
+      if (found < 0) { return SPLT_DEFAULT_PARAM_THRESHOLD; }
+      if (found + 1 >= number_tracks)
+      {
+        return threshold;
+      }
+    }
+
+    return 0;
+  }
+
+  //one bin per dB, from SPLT_AUTO_THRESHOLD_MIN to 0 dB
+  long histogram[SPLT_AUTO_THRESHOLD_BINS];
+  double smoothed[SPLT_AUTO_THRESHOLD_BINS];
+  memset(histogram, 0x0, sizeof(histogram));
+
+  long i = 0;
+  for (i = 0;i < envelope->number;i++)
+  {
+    int bin = (int) (splt_u_convert2dB(envelope->peak[i]) - SPLT_AUTO_THRESHOLD_MIN);
+    if (bin < 0) { bin = 0; }
+    if (bin >= SPLT_AUTO_THRESHOLD_BINS) { bin = SPLT_AUTO_THRESHOLD_BINS - 1; }
+    histogram[bin]++;
+  }
+
+  int bin = 0;
+  for (bin = 0;bin < SPLT_AUTO_THRESHOLD_BINS;bin++)
+  {
+    int count = 0;
+    smoothed[bin] = 0;
+    int j = 0;
+    for (j = bin - 2;j <= bin + 2;j++)
+    {
+      if ((j >= 0) && (j < SPLT_AUTO_THRESHOLD_BINS))
+      {
+        smoothed[bin] += histogram[j];
+        count++;
+      }
+    }
+    smoothed[bin] /= count;
+  }
+
+  //the music is the highest mode, the noise floor the highest mode
+  //well below it
+  int music = 0;
+  for (bin = 1;bin < SPLT_AUTO_THRESHOLD_BINS;bin++)
+  {
+    if (smoothed[bin] > smoothed[music])
+    {
+      music = bin;
+    }
+  }
+
+  int noise = -1;
+  for (bin = 0;bin < music - SPLT_AUTO_THRESHOLD_GAP;bin++)
+  {
+    if ((histogram[bin] > 0) && ((noise == -1) || (smoothed[bin] > smoothed[noise])))
+    {
+      noise = bin;
+    }
+  }
+
+  if (noise == -1)
+  {
+    return SPLT_DEFAULT_PARAM_THRESHOLD;
+  }
+
+  int valley = noise;
+  for (bin = noise;bin <= music;bin++)
+  {
+    if (smoothed[bin] < smoothed[valley])
+    {
+      valley = bin;
+    }
+  }
+
+  //middle of a flat valley
+  int valley_end = valley;
+  while ((valley_end + 1 < music) &&
+      (smoothed[valley_end + 1] <= smoothed[valley]))
+  {
+    valley_end++;
+  }
+
+  return (valley + valley_end) / 2 + SPLT_AUTO_THRESHOLD_MIN;
+}
+
+//detects the silences from 'begin' to 'begin' + 'length' seconds, as
+//a scan of this part of the file would do; the positions of the
+//silences put in the silence list are relative to 'begin'
+//returns the number of silences found, or -1 if error
+int splt_en_detect_silence_in(splt_state *state, double begin, double length,
+    float threshold, float min, int *error)
+{
+  splt_envelope *envelope = &state->envelope;
+
+  //first block ending after 'begin'
+  long left = 0, right = envelope->number;
+  while (left < right)
+  {
+    long middle = left + (right - left) / 2;
+    if (envelope->time[middle] <= begin)
+    {
+      left = middle + 1;
+    }
+    else
+    {
+      right = middle;
+    }
+  }
+
+  return splt_en_replay(state, left, begin, length,
+      threshold, min, SPLT_FALSE, error);
+}
+
+/********************************/
+/* envelope cache file */
+
+//computes the key of the cache: size, modification time and a FNV-1a
+//hash of the start and of the end of the file
+static int splt_en_get_file_key(const char *filename,
+    unsigned long long *size, long long *mtime, unsigned long long *hash)
+{
+  struct stat buf;
+  if (stat(filename, &buf) != 0)
+  {
+    return -1;
+  }
+  *size = (unsigned long long) buf.st_size;
+  *mtime = (long long) buf.st_mtime;
+
+  FILE *file = splt_u_fopen(filename, "rb");
+  if (file == NULL)
+  {
+    return -1;
+  }
+
+  unsigned long long h = 14695981039346656037ULL;
+  unsigned char buffer[8192];
+  int part = 0;
+  for (part = 0;part < 2;part++)
+  {
+    off_t start = 0;
+    if (part == 1)
+    {
+      if (*size <= 2 * SPLT_ENVELOPE_HASHED_BYTES)
+      {
+        break;
+      }
+      start = (off_t) (*size - SPLT_ENVELOPE_HASHED_BYTES);
+    }
+
+    if (fseeko(file, start, SEEK_SET) == -1)
+    {
+      fclose(file);
+      return -1;
+    }
+
+    long remaining = SPLT_ENVELOPE_HASHED_BYTES;
+    if (*size <= 2 * SPLT_ENVELOPE_HASHED_BYTES)
+    {
+      remaining = (long) *size;
+    }
+    while (remaining > 0)
+    {
+      size_t to_read = sizeof(buffer);
+      if (remaining < (long) to_read)
+      {
+        to_read = remaining;
+      }
+      size_t readed = fread(buffer, 1, to_read, file);
+      if (readed == 0)
+      {
+        break;
+      }
+      size_t i = 0;
+      for (i = 0;i < readed;i++)
+      {
+        h ^= buffer[i];
+        h *= 1099511628211ULL;
+      }
+      remaining -= readed;
+    }
+  }
+  *hash = h;
+
+  fclose(file);
+
+  return 0;
+}
+
+//reads the envelope of the file to split from the cache 'fname'
+//returns SPLT_TRUE if the cache matches the file to split and the scan
+//quality; an envelope of a fast scan is only used by a fast scan, and
+//if it was rechecked, with the same threshold or the automatic one
+int splt_en_read_cache(splt_state *state, const char *fname, int *error)
+{
+  int read_cache = SPLT_FALSE;
+
+  unsigned long long size = 0, hash = 0;
+  long long mtime = 0;
+  if (splt_en_get_file_key(splt_t_get_filename_to_split(state),
+        &size, &mtime, &hash) == -1)
+  {
+    return SPLT_FALSE;
+  }
+
+  FILE *file = splt_u_fopen(fname, "rb");
+  if (file == NULL)
+  {
+    return SPLT_FALSE;
+  }
+
+  char magic[8];
+  unsigned int bom = 0;
+  unsigned long long file_size = 0, file_hash = 0, number = 0;
+  long long file_mtime = 0;
+  unsigned int quality = 0;
+  float scan_threshold = 0;
+  if ((fread(magic, 1, 8, file) < 8) ||
+      (memcmp(magic, SPLT_ENVELOPE_MAGIC, 8) != 0) ||
+      (fread(&bom, sizeof(bom), 1, file) < 1) ||
+      (bom != SPLT_ENVELOPE_BOM) ||
+      (fread(&file_size, sizeof(file_size), 1, file) < 1) ||
+      (fread(&file_mtime, sizeof(file_mtime), 1, file) < 1) ||
+      (fread(&file_hash, sizeof(file_hash), 1, file) < 1) ||
+      (fread(&quality, sizeof(quality), 1, file) < 1) ||
+      (fread(&scan_threshold, sizeof(scan_threshold), 1, file) < 1) ||
+      (fread(&number, sizeof(number), 1, file) < 1))
+  {
+    goto function_end;
+  }
+
+  if ((file_size != size) || (file_mtime != mtime) || (file_hash != hash) ||
+      (number > (unsigned long long) LONG_MAX))
+  {
+    goto function_end;
+  }
+
+  short fast_scan = (quality & SPLT_ENVELOPE_FAST_SCAN) != 0;
+  short rechecked = (quality & SPLT_ENVELOPE_RECHECKED) != 0;
+  if (fast_scan && !splt_t_get_int_option(state, SPLT_OPT_FAST_SCAN))
+  {
+    goto function_end;
+  }
+  if (rechecked && !splt_t_get_int_option(state, SPLT_OPT_AUTO_THRESHOLD) &&
+      (scan_threshold !=
+       splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD)))
+  {
+    goto function_end;
+  }
+
+  splt_en_free(state);
+  if (number > 0)
+  {
+    int err = splt_en_alloc(&state->envelope, (long) number);
+    if (err < 0)
+    {
+      *error = err;
+      splt_en_free(state);
+      goto function_end;
+    }
+  }
+
+  splt_envelope *envelope = &state->envelope;
+  if ((fread(envelope->time, sizeof(double), number, file) < number) ||
+      (fread(envelope->peak, sizeof(float), number, file) < number) ||
+      (fread(envelope->level, sizeof(float), number, file) < number))
+  {
+    splt_en_free(state);
+    goto function_end;
+  }
+  envelope->number = (long) number;
+  envelope->fast_scan = fast_scan;
+  envelope->rechecked = rechecked;
+  envelope->scan_threshold = scan_threshold;
+
+  read_cache = SPLT_TRUE;
+
+function_end:
+  fclose(file);
+
+  return read_cache;
+}
+
+//writes the recorded envelope in the cache 'fname'
+void splt_en_write_cache(splt_state *state, const char *fname, int *error)
+{
+  unsigned long long size = 0, hash = 0;
+  long long mtime = 0;
+  if (splt_en_get_file_key(splt_t_get_filename_to_split(state),
+        &size, &mtime, &hash) == -1)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, splt_t_get_filename_to_split(state));
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    return;
+  }
+
+  FILE *file = splt_u_fopen(fname, "wb");
+  if (file == NULL)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, fname);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    return;
+  }
+
+  splt_envelope *envelope = &state->envelope;
+  unsigned int bom = SPLT_ENVELOPE_BOM;
+  unsigned long long number = (unsigned long long) envelope->number;
+  unsigned int quality = 0;
+  if (envelope->fast_scan)
+  {
+    quality |= SPLT_ENVELOPE_FAST_SCAN;
+  }
+  if (envelope->rechecked)
+  {
+    quality |= SPLT_ENVELOPE_RECHECKED;
+  }
+  if ((fwrite(SPLT_ENVELOPE_MAGIC, 1, 8, file) < 8) ||
+      (fwrite(&bom, sizeof(bom), 1, file) < 1) ||
+      (fwrite(&size, sizeof(size), 1, file) < 1) ||
+      (fwrite(&mtime, sizeof(mtime), 1, file) < 1) ||
+      (fwrite(&hash, sizeof(hash), 1, file) < 1) ||
+      (fwrite(&quality, sizeof(quality), 1, file) < 1) ||
+      (fwrite(&envelope->scan_threshold, sizeof(float), 1, file) < 1) ||
+      (fwrite(&number, sizeof(number), 1, file) < 1) ||
+      (fwrite(envelope->time, sizeof(double), number, file) < number) ||
+      (fwrite(envelope->peak, sizeof(float), number, file) < number) ||
+      (fwrite(envelope->level, sizeof(float), number, file) < number))
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, fname);
+    *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+  }
+
+  if (fclose(file) != 0)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, fname);
+    *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+  }
+}
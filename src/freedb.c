@@ -157,7 +157,7 @@ static int splt_freedb2_analyse_cd_buffer (char *buf, int size,
           splt_t_freedb_set_disc(state,splt_t_freedb_get_found_cds(state), 
               temp,buf,temp-buf);
 
-          char *full_artist_album = malloc(temp2-(temp+8)-1);
+          char *full_artist_album = splt_u_malloc(temp2-(temp+8)-1);
           if (full_artist_album)
           {
             int max_chars = temp2-(temp+8)-1;
@@ -246,7 +246,7 @@ static splt_addr splt_freedb_useproxy(splt_proxy *proxy, splt_addr dest,
 
     fprintf(stderr, "Using Proxy: %s on Port %d\n", dest.hostname, dest.port);
 
-    dest.auth = malloc(strlen(line)+1);
+    dest.auth = splt_u_malloc(strlen(line)+1);
     if (dest.auth==NULL)
     {
       perror("malloc");
@@ -424,7 +424,7 @@ int splt_freedb_process_search(splt_state *state, char *search,
             strlen(SPLT_FREEDB2_SEARCH)+strlen(cgi_path)+3;
 
           //we allocate the memory for the query string
-          if ((message = malloc(malloc_number)) == NULL)
+          if ((message = splt_u_malloc(malloc_number)) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
           }
@@ -663,7 +663,7 @@ char *splt_freedb_get_file(splt_state *state, int i, int *error,
       malloc_number = strlen(cd_category) + strlen(cd_id) +
         strlen(SPLT_FREEDB_CDDB_CGI_GET_FILE) + strlen(cgi_path);
     }
-    message = malloc(malloc_number);
+    message = splt_u_malloc(malloc_number);
     if (message != NULL)
     {
       //CDDB protocol (usually port 8880)
@@ -833,7 +833,7 @@ bloc_end:
             }
             else
             {
-              output = malloc(strlen(c)+1);
+              output = splt_u_malloc(strlen(c)+1);
               if (output != NULL)
               {
                 sprintf(output,c);
@@ -966,7 +966,7 @@ bloc_end2:
               }
               else
               {
-                output = malloc(strlen(c)+1);
+                output = splt_u_malloc(strlen(c)+1);
                 if (output != NULL)
                 {
                   //we write the output
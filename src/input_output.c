@@ -29,6 +29,12 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/falloc.h>
+#endif
 
 #include "splt.h"
 
@@ -56,7 +62,7 @@ static char *splt_io_readlink(const char *fname)
 
   while (bufsize < INT_MAX)
   {
-    char *linked_fname = malloc(sizeof(char) * bufsize);
+    char *linked_fname = splt_u_malloc(sizeof(char) * bufsize);
     if (linked_fname == NULL)
     {
       return NULL;
@@ -238,3 +244,132 @@ int splt_io_check_if_file(splt_state *state, const char *fname)
   return SPLT_FALSE;
 }
 
+/* I/O policy of the input and of the split files */
+
+//gives a buffer of 'size' bytes to the stream; the buffer is kept in
+//'buffer' and reused for the next stream of the same kind
+static void splt_io_set_buffer(FILE *file, char **buffer, int *buffer_size,
+    int size)
+{
+  if (size <= 0)
+  {
+    return;
+  }
+
+  if (*buffer_size != size)
+  {
+    char *new_buffer = splt_u_realloc(*buffer, size);
+    if (new_buffer == NULL)
+    {
+      return;
+    }
+    *buffer = new_buffer;
+    *buffer_size = size;
+  }
+
+  setvbuf(file, *buffer, _IOFBF, size);
+}
+
+//applies the I/O options to the input just opened, before any read
+void splt_io_set_input_policy(splt_state *state, FILE *file)
+{
+  state->io.input_dropped = 0;
+
+  if (file == stdin)
+  {
+    return;
+  }
+
+  splt_io_set_buffer(file, &state->io.input_buffer,
+      &state->io.input_buffer_size,
+      splt_t_get_int_option(state, SPLT_OPT_IO_BUFFER_SIZE));
+
+#ifdef POSIX_FADV_SEQUENTIAL
+  if (splt_t_get_int_option(state, SPLT_OPT_IO_ADVICE))
+  {
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+#endif
+}
+
+//applies the I/O options to a split file just opened, before any write;
+//'size' is the expected size of the file, 0 if unknown
+void splt_io_set_output_policy(splt_state *state, FILE *file, off_t size)
+{
+  if (file == stdout)
+  {
+    return;
+  }
+
+  splt_io_set_buffer(file, &state->io.output_buffer,
+      &state->io.output_buffer_size,
+      splt_t_get_int_option(state, SPLT_OPT_IO_BUFFER_SIZE));
+
+#if defined(__linux__) && defined(SYS_fallocate)
+  //the space is reserved without changing the size of the file, so a
+  //wrong estimation only costs the blocks freed when closing the file
+  if (size > 0 && splt_t_get_int_option(state, SPLT_OPT_PREALLOCATE_OUTPUT))
+  {
+    syscall(SYS_fallocate, fileno(file), FALLOC_FL_KEEP_SIZE,
+        (off_t) 0, size);
+  }
+#endif
+}
+
+//frees the space reserved after the end of a split file before closing it
+void splt_io_release_output(splt_state *state, FILE *file)
+{
+#if defined(__linux__) && defined(SYS_fallocate)
+  if (file != stdout &&
+      splt_t_get_int_option(state, SPLT_OPT_PREALLOCATE_OUTPUT))
+  {
+    struct stat file_stat;
+    if (fstat(fileno(file), &file_stat) == 0)
+    {
+      //truncating at the same size frees the blocks after the end
+      if (ftruncate(fileno(file), file_stat.st_size) == -1)
+      {
+        return;
+      }
+    }
+  }
+#endif
+}
+
+//drops from the page cache the input read before 'offset', by steps of
+//SPLT_IO_DROP_STEP
+void splt_io_input_consumed(splt_state *state, FILE *file, off_t offset)
+{
+#ifdef POSIX_FADV_DONTNEED
+  if (file == NULL || file == stdin ||
+      !splt_t_get_int_option(state, SPLT_OPT_IO_ADVICE))
+  {
+    return;
+  }
+
+  off_t end = offset - (offset % SPLT_IO_DROP_STEP);
+  if (end > state->io.input_dropped)
+  {
+    posix_fadvise(fileno(file), state->io.input_dropped,
+        end - state->io.input_dropped, POSIX_FADV_DONTNEED);
+    state->io.input_dropped = end;
+  }
+#endif
+}
+
+void splt_io_free(splt_state *state)
+{
+  if (state->io.input_buffer)
+  {
+    free(state->io.input_buffer);
+    state->io.input_buffer = NULL;
+  }
+  if (state->io.output_buffer)
+  {
+    free(state->io.output_buffer);
+    state->io.output_buffer = NULL;
+  }
+  state->io.input_buffer_size = 0;
+  state->io.output_buffer_size = 0;
+}
+
@@ -0,0 +1,624 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+
+
+#include <sys/stat.h>
+#include <string.h>
+
+#include "splt.h"
+
+//the journal records the plan of a split and each split file written,
+//so that a split with the same plan skips the split files that are
+//still there and only rewrites the tags of those with new tags;
+//it is a text file growing by one line for each split file:
+//
+// SPLTJOURNAL version plan
+// for each split file:
+//   splitpoint size checksum tags filename
+//
+//the plan and the tags are hashes of everything the split and the tags
+//depend on, the checksum is the Adler-32 of the split file
+
+//longest line of the journal
+#define SPLT_JOURNAL_LINE_SIZE 4352
+//longest split filename recorded in the journal
+#define SPLT_JOURNAL_MAX_FILENAME 4096
+
+#define SPLT_JOURNAL_HASH_INIT 14695981039346656037ULL
+#define SPLT_JOURNAL_HASH_PRIME 1099511628211ULL
+
+//a split file recorded in the journal
+typedef struct {
+  //index of the splitpoint starting the split file
+  int splitpoint;
+  off_t size;
+  unsigned long checksum;
+  unsigned long long tags;
+  char *filename;
+} splt_journal_segment;
+
+struct splt_journal {
+  FILE *file;
+  unsigned long long plan;
+  splt_journal_segment *segments;
+  int segments_num;
+  int segments_allocated;
+  //the segment found unchanged by splt_jn_resume_segment, or -1
+  int verified;
+};
+
+//FNV-1a hash of 'length' bytes of 'data'
+static unsigned long long splt_jn_hash(unsigned long long hash,
+    const void *data, size_t length)
+{
+  const unsigned char *bytes = data;
+  size_t i = 0;
+  for (i = 0;i < length;i++)
+  {
+    hash = (hash ^ bytes[i]) * SPLT_JOURNAL_HASH_PRIME;
+  }
+
+  return hash;
+}
+
+//the end of the string is hashed too, so that "a","bc" and "ab","c" differ
+static unsigned long long splt_jn_hash_string(unsigned long long hash,
+    const char *str)
+{
+  if (str == NULL)
+  {
+    return splt_jn_hash(hash, "\1", 1);
+  }
+
+  return splt_jn_hash(hash, str, strlen(str) + 1);
+}
+
+static unsigned long long splt_jn_hash_number(unsigned long long hash,
+    long long number)
+{
+  unsigned char bytes[8];
+  int i = 0;
+  for (i = 0;i < 8;i++)
+  {
+    bytes[i] = (unsigned char) ((number >> (i * 8)) & 0xFF);
+  }
+
+  return splt_jn_hash(hash, bytes, 8);
+}
+
+//hash of what the split files depend on, except their tags
+static unsigned long long splt_jn_plan(splt_state *state)
+{
+  unsigned long long plan = SPLT_JOURNAL_HASH_INIT;
+
+  const char *fname_to_split = splt_t_get_filename_to_split(state);
+  plan = splt_jn_hash_string(plan, fname_to_split);
+  struct stat file_stat;
+  if (stat(fname_to_split, &file_stat) == 0)
+  {
+    plan = splt_jn_hash_number(plan, (long long) file_stat.st_size);
+    plan = splt_jn_hash_number(plan, (long long) file_stat.st_mtime);
+  }
+
+  plan = splt_jn_hash_string(plan, splt_t_get_path_of_split(state));
+  plan = splt_jn_hash_string(plan, state->oformat.format_string);
+
+  //every option changing the audio data or the split points
+  int int_options[] = { SPLT_OPT_SPLIT_MODE, SPLT_OPT_XING,
+    SPLT_OPT_FRAME_MODE, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_OPT_AUTO_ADJUST,
+    SPLT_OPT_PARAM_GAP, SPLT_OPT_PARAM_NUMBER_TRACKS,
+    SPLT_OPT_PARAM_REMOVE_SILENCE, SPLT_OPT_LENGTH_SPLIT_FILE_NUMBER,
+    SPLT_OPT_AUTO_THRESHOLD, SPLT_OPT_FAST_SCAN, SPLT_OPT_SEEK_INDEX };
+  float float_options[] = {
+    splt_t_get_float_option(state, SPLT_OPT_SPLIT_TIME),
+    splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD),
+    splt_t_get_float_option(state, SPLT_OPT_PARAM_OFFSET),
+    splt_t_get_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH) };
+
+  int int_options_num = sizeof(int_options) / sizeof(int);
+  int float_options_num = sizeof(float_options) / sizeof(float);
+
+  int i = 0;
+  for (i = 0;i < int_options_num;i++)
+  {
+    plan = splt_jn_hash_number(plan,
+        splt_t_get_int_option(state, int_options[i]));
+  }
+  for (i = 0;i < float_options_num;i++)
+  {
+    plan = splt_jn_hash_number(plan, (long long) (float_options[i] * 1000));
+  }
+  plan = splt_jn_hash_number(plan,
+      splt_t_get_long_option(state, SPLT_OPT_OVERLAP_TIME));
+
+  int get_error = SPLT_OK;
+  int number_of_splitpoints = splt_t_get_splitnumber(state);
+  plan = splt_jn_hash_number(plan, number_of_splitpoints);
+  for (i = 0;i < number_of_splitpoints;i++)
+  {
+    plan = splt_jn_hash_number(plan,
+        splt_t_get_splitpoint_value(state, i, &get_error));
+    plan = splt_jn_hash_number(plan,
+        splt_t_get_splitpoint_type(state, i, &get_error));
+  }
+
+  return plan;
+}
+
+//hash of the tags written in the current split file
+static unsigned long long splt_jn_tags(splt_state *state)
+{
+  unsigned long long hash = SPLT_JOURNAL_HASH_INIT;
+
+  hash = splt_jn_hash_number(hash, splt_t_get_int_option(state, SPLT_OPT_TAGS));
+  hash = splt_jn_hash_number(hash,
+      splt_t_get_int_option(state, SPLT_OPT_FORCE_TAGS_VERSION));
+  hash = splt_jn_hash_number(hash, state->original_tags.tags_version);
+
+  splt_tags *tags = splt_tu_get_current_tags(state);
+  if (tags)
+  {
+    hash = splt_jn_hash_string(hash, tags->title);
+    hash = splt_jn_hash_string(hash, tags->artist);
+    hash = splt_jn_hash_string(hash, tags->album);
+    hash = splt_jn_hash_string(hash, tags->performer);
+    hash = splt_jn_hash_string(hash, tags->year);
+    hash = splt_jn_hash_string(hash, tags->comment);
+    hash = splt_jn_hash_number(hash, tags->track);
+    hash = splt_jn_hash_number(hash, tags->genre);
+  }
+
+  return hash;
+}
+
+//computes the size and the Adler-32 checksum of the file 'filename'
+//returns -1 if the file cannot be read
+static int splt_jn_checksum_file(const char *filename, off_t *size,
+    unsigned long *checksum)
+{
+  FILE *file = splt_u_fopen(filename, "rb");
+  if (file == NULL)
+  {
+    return -1;
+  }
+
+  unsigned char buffer[32768];
+  unsigned long a = 1, b = 0;
+  off_t total = 0;
+  size_t readed = 0;
+  while ((readed = fread(buffer, 1, sizeof(buffer), file)) > 0)
+  {
+    total += readed;
+
+    size_t i = 0;
+    while (i < readed)
+    {
+      //the sums may grow for 5552 bytes before overflowing 32 bits
+      size_t block_end = i + 5552;
+      if (block_end > readed)
+      {
+        block_end = readed;
+      }
+      for (;i < block_end;i++)
+      {
+        a += buffer[i];
+        b += a;
+      }
+      a %= 65521;
+      b %= 65521;
+    }
+  }
+
+  int error = ferror(file) ? -1 : 0;
+  fclose(file);
+
+  *size = total;
+  *checksum = (b << 16) | a;
+
+  return error;
+}
+
+//returns -1 if not enough memory
+static int splt_jn_append(splt_journal *journal, int splitpoint, off_t size,
+    unsigned long checksum, unsigned long long tags, const char *filename)
+{
+  if (journal->segments_num == journal->segments_allocated)
+  {
+    int allocated = journal->segments_allocated ?
+      journal->segments_allocated * 2 : 32;
+    splt_journal_segment *segments = splt_u_realloc(journal->segments,
+        sizeof(splt_journal_segment) * allocated);
+    if (segments == NULL)
+    {
+      return -1;
+    }
+    journal->segments = segments;
+    journal->segments_allocated = allocated;
+  }
+
+  int error = SPLT_OK;
+  char *segment_filename = splt_su_safe_strdup(filename, &error);
+  if (error < 0)
+  {
+    return -1;
+  }
+
+  splt_journal_segment *segment = &journal->segments[journal->segments_num];
+  segment->splitpoint = splitpoint;
+  segment->size = size;
+  segment->checksum = checksum;
+  segment->tags = tags;
+  segment->filename = segment_filename;
+  journal->segments_num++;
+
+  return 0;
+}
+
+//returns -1 if the line cannot be written
+static int splt_jn_write_segment(FILE *file, splt_journal_segment *segment)
+{
+  if (fprintf(file, "%d %lld %lx %llx %s\n", segment->splitpoint,
+        (long long) segment->size, segment->checksum, segment->tags,
+        segment->filename) < 0)
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+//reads the split files of the journal 'file' if it has the same plan
+//returns SPLT_TRUE if the whole journal has been read
+static int splt_jn_load(splt_journal *journal, FILE *file, int *error)
+{
+  char line[SPLT_JOURNAL_LINE_SIZE] = { '\0' };
+
+  char magic[16] = { '\0' };
+  int version = 0;
+  unsigned long long plan = 0;
+  if ((fgets(line, SPLT_JOURNAL_LINE_SIZE, file) == NULL) ||
+      (sscanf(line, "%15s %d %llx", magic, &version, &plan) != 3) ||
+      (strcmp(magic, SPLT_JOURNAL_MAGIC) != 0) ||
+      (version != SPLT_JOURNAL_VERSION) || (plan != journal->plan))
+  {
+    return SPLT_FALSE;
+  }
+
+  while (fgets(line, SPLT_JOURNAL_LINE_SIZE, file) != NULL)
+  {
+    //an interrupted split leaves an incomplete last line
+    size_t length = strlen(line);
+    if ((length == 0) || (line[length-1] != '\n'))
+    {
+      return SPLT_FALSE;
+    }
+    line[length-1] = '\0';
+
+    int splitpoint = 0, filename_offset = 0;
+    long long size = 0;
+    unsigned long checksum = 0;
+    unsigned long long tags = 0;
+    if ((sscanf(line, "%d %lld %lx %llx %n", &splitpoint, &size,
+            &checksum, &tags, &filename_offset) != 4) ||
+        (filename_offset == 0) || (line[filename_offset] == '\0'))
+    {
+      return SPLT_FALSE;
+    }
+
+    if (splt_jn_append(journal, splitpoint, (off_t) size, checksum, tags,
+          line + filename_offset) == -1)
+    {
+      *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+      return SPLT_FALSE;
+    }
+  }
+
+  return SPLT_TRUE;
+}
+
+//returns SPLT_TRUE if the split files are recorded in a journal
+int splt_jn_is_enabled(splt_state *state)
+{
+  return state->journal != NULL;
+}
+
+//opens the journal if we have a journal filename, reading the split
+//files already recorded with the same plan
+void splt_jn_open(splt_state *state, int *error)
+{
+  if ((splt_t_get_journal_filename(state) == NULL) ||
+      splt_mf_is_enabled(state) || splt_t_is_stdin(state) ||
+      splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+  {
+    return;
+  }
+
+  char *journal_fname = splt_t_get_journal_file_with_path(state, error);
+  if (*error < 0 || journal_fname == NULL) { return; }
+
+  splt_journal *journal = splt_u_malloc(sizeof(splt_journal));
+  if (journal == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto function_end;
+  }
+  journal->file = NULL;
+  journal->plan = splt_jn_plan(state);
+  journal->segments = NULL;
+  journal->segments_num = 0;
+  journal->segments_allocated = 0;
+  journal->verified = -1;
+  state->journal = journal;
+
+  int complete = SPLT_FALSE;
+  FILE *previous = splt_u_fopen(journal_fname, "rb");
+  if (previous)
+  {
+    complete = splt_jn_load(journal, previous, error);
+    fclose(previous);
+    if (*error < 0) { goto function_end; }
+  }
+
+  char message[2048] = { '\0' };
+  if (journal->segments_num > 0)
+  {
+    snprintf(message, 2048, _(" Resuming the split from journal '%s'.\n"),
+        journal_fname);
+  }
+  else
+  {
+    snprintf(message, 2048, _(" Journal file '%s' will be created.\n"),
+        journal_fname);
+  }
+  splt_t_put_info_message_to_client(state, message);
+
+  //a journal with another plan or with an incomplete last line is
+  //written again, with the split files read
+  const char *mode = complete ? "ab" : "wb";
+  if ((journal->file = splt_u_fopen(journal_fname, mode)) == NULL)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, journal_fname);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    goto function_end;
+  }
+
+  if (!complete)
+  {
+    int write_error =
+      (fprintf(journal->file, "%s %d %llx\n", SPLT_JOURNAL_MAGIC,
+               SPLT_JOURNAL_VERSION, journal->plan) < 0);
+
+    int i = 0;
+    for (i = 0;(i < journal->segments_num) && !write_error;i++)
+    {
+      write_error = (splt_jn_write_segment(journal->file,
+            &journal->segments[i]) == -1);
+    }
+
+    if (write_error || (fflush(journal->file) == EOF))
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, journal_fname);
+      *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+    }
+  }
+
+function_end:
+  if (*error < 0)
+  {
+    int err = SPLT_OK;
+    splt_jn_close(state, &err);
+  }
+
+  free(journal_fname);
+  journal_fname = NULL;
+}
+
+//returns the index of the last record of the split file starting at
+//'splitpoint', or -1
+static int splt_jn_find_segment(splt_journal *journal, int splitpoint)
+{
+  int i = 0;
+  for (i = journal->segments_num - 1;i >= 0;i--)
+  {
+    if (journal->segments[i].splitpoint == splitpoint)
+    {
+      break;
+    }
+  }
+
+  return i;
+}
+
+//returns SPLT_TRUE if the split file starting at 'splitpoint' is in the
+//journal, so that it may not be split again
+int splt_jn_has_segment(splt_state *state, int splitpoint)
+{
+  splt_journal *journal = state->journal;
+  if (journal == NULL)
+  {
+    return SPLT_FALSE;
+  }
+
+  return splt_jn_find_segment(journal, splitpoint) >= 0;
+}
+
+//checks if the split file 'output_fname' starting at 'splitpoint' is in
+//the journal and has not changed since; if only its tags changed, they
+//are rewritten when the plugin can do it
+//returns SPLT_TRUE if the split file does not need to be split again
+int splt_jn_resume_segment(splt_state *state, int splitpoint,
+    const char *output_fname)
+{
+  splt_journal *journal = state->journal;
+  if (journal == NULL)
+  {
+    return SPLT_FALSE;
+  }
+
+  journal->verified = -1;
+
+  //the last record of a split file is the right one
+  int i = splt_jn_find_segment(journal, splitpoint);
+  if ((i < 0) || (strcmp(journal->segments[i].filename, output_fname) != 0))
+  {
+    return SPLT_FALSE;
+  }
+
+  off_t size = 0;
+  unsigned long checksum = 0;
+  if ((splt_jn_checksum_file(output_fname, &size, &checksum) == -1) ||
+      (size != journal->segments[i].size) ||
+      (checksum != journal->segments[i].checksum))
+  {
+    splt_u_print_debug(state,"Journal segment changed",0,output_fname);
+    return SPLT_FALSE;
+  }
+
+  char message[2048] = { '\0' };
+  if (splt_jn_tags(state) != journal->segments[i].tags)
+  {
+    //the split file is put in the journal again with its new checksum;
+    //if the tags cannot be rewritten, it is split again
+    int err = SPLT_OK;
+    if (!splt_p_can_rewrite_tags(state) ||
+        !splt_p_rewrite_tags(state, output_fname, &err) || (err < 0))
+    {
+      splt_u_print_debug(state,"Journal segment tags not rewritten",0,output_fname);
+      return SPLT_FALSE;
+    }
+
+    snprintf(message, 2048, _(" info: tags of '%s' rewritten\n"),
+        splt_u_get_real_name(output_fname));
+  }
+  else
+  {
+    journal->verified = i;
+
+    snprintf(message, 2048, _(" info: '%s' is already split\n"),
+        splt_u_get_real_name(output_fname));
+  }
+  splt_t_put_info_message_to_client(state, message);
+
+  return SPLT_TRUE;
+}
+
+//puts the split file 'output_fname' of the current split in the journal
+//returns possible error
+int splt_jn_put_segment(splt_state *state, const char *output_fname)
+{
+  splt_journal *journal = state->journal;
+  if (journal == NULL)
+  {
+    return SPLT_OK;
+  }
+
+  int current_split = splt_t_get_current_split(state);
+
+  //an unchanged split file is already in the journal
+  if (journal->verified >= 0)
+  {
+    splt_journal_segment *verified = &journal->segments[journal->verified];
+    journal->verified = -1;
+    if ((verified->splitpoint == current_split) &&
+        (strcmp(verified->filename, output_fname) == 0))
+    {
+      return SPLT_OK;
+    }
+  }
+
+  //such split files are split again the next time
+  if ((strchr(output_fname, '\n') != NULL) ||
+      (strlen(output_fname) > SPLT_JOURNAL_MAX_FILENAME))
+  {
+    return SPLT_OK;
+  }
+
+  off_t size = 0;
+  unsigned long checksum = 0;
+  if (splt_jn_checksum_file(output_fname, &size, &checksum) == -1)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, output_fname);
+    return SPLT_ERROR_CANNOT_OPEN_FILE;
+  }
+
+  if (splt_jn_append(journal, current_split, size, checksum,
+        splt_jn_tags(state), output_fname) == -1)
+  {
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  }
+
+  if ((splt_jn_write_segment(journal->file,
+          &journal->segments[journal->segments_num - 1]) == -1) ||
+      (fflush(journal->file) == EOF))
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, splt_t_get_journal_filename(state));
+    return SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+  }
+
+  return SPLT_OK;
+}
+
+//closes the journal
+void splt_jn_close(splt_state *state, int *error)
+{
+  splt_journal *journal = state->journal;
+  if (journal == NULL)
+  {
+    return;
+  }
+
+  if (journal->file && (fclose(journal->file) != 0))
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, splt_t_get_journal_filename(state));
+    *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+  }
+
+  int i = 0;
+  for (i = 0;i < journal->segments_num;i++)
+  {
+    free(journal->segments[i].filename);
+  }
+  if (journal->segments)
+  {
+    free(journal->segments);
+  }
+  free(journal);
+
+  state->journal = NULL;
+}
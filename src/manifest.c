@@ -0,0 +1,166 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#include <string.h>
+
+#include "splt.h"
+
+//the manifest file describes each split file as a byte range of the
+//input file, with a prefix and a suffix to send around it;
+//all the integers are big endian:
+//
+// "SPLTMANI", version (4 bytes),
+// input filename length (4 bytes), input filename
+// for each split file:
+//   output filename length (4 bytes), output filename
+//   input offset (8 bytes), input length (8 bytes)
+//   prefix length (4 bytes), prefix
+//   suffix length (4 bytes), suffix
+
+#define SPLT_MANIFEST_MAGIC "SPLTMANI"
+#define SPLT_MANIFEST_VERSION 1
+
+//writes 'value' on 'bytes' bytes, big endian
+static int splt_mf_put_number(FILE *file, unsigned long long value, int bytes)
+{
+  int i = 0;
+  for (i = bytes - 1;i >= 0;i--)
+  {
+    if (fputc((int) ((value >> (i * 8)) & 0xFF), file) == EOF)
+    {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+//writes the length of 'data' followed by 'data'
+static int splt_mf_put_data(FILE *file, const void *data, unsigned long length)
+{
+  if (splt_mf_put_number(file, length, 4) == -1)
+  {
+    return -1;
+  }
+  if ((length > 0) && (fwrite(data, 1, length, file) < length))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+//returns SPLT_TRUE if we write a manifest instead of the split files
+int splt_mf_is_enabled(splt_state *state)
+{
+  return state->manifest != NULL;
+}
+
+//opens the manifest file if we have a manifest filename
+void splt_mf_open(splt_state *state, int *error)
+{
+  char *manifest_fname = splt_t_get_manifest_file_with_path(state, error);
+  if (*error < 0 || manifest_fname == NULL) { return; }
+
+  char message[2048] = { '\0' };
+  snprintf(message, 2048, _(" Manifest file '%s' will be created.\n"),
+      manifest_fname);
+  splt_t_put_info_message_to_client(state, message);
+
+  if ((state->manifest = splt_u_fopen(manifest_fname, "wb")) == NULL)
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, manifest_fname);
+    *error = SPLT_ERROR_CANNOT_OPEN_FILE;
+    goto function_end;
+  }
+
+  const char *fname_to_split = splt_t_get_filename_to_split(state);
+  if ((fwrite(SPLT_MANIFEST_MAGIC, 1, 8, state->manifest) < 8) ||
+      (splt_mf_put_number(state->manifest, SPLT_MANIFEST_VERSION, 4) == -1) ||
+      (splt_mf_put_data(state->manifest, fname_to_split,
+                        strlen(fname_to_split)) == -1))
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, manifest_fname);
+    *error = SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+  }
+
+function_end:
+  free(manifest_fname);
+  manifest_fname = NULL;
+}
+
+//puts the split file 'output_fname' in the manifest;
+//the split file is 'prefix', then 'length' bytes of the input file
+//starting from 'offset', then 'suffix'
+//returns possible error
+int splt_mf_put_segment(splt_state *state, const char *output_fname,
+    off_t offset, off_t length,
+    const void *prefix, unsigned long prefix_length,
+    const void *suffix, unsigned long suffix_length)
+{
+  FILE *manifest = state->manifest;
+
+  splt_u_print_debug(state,"Manifest segment for",0,output_fname);
+  splt_u_print_debug(state,"Manifest segment offset",offset,NULL);
+  splt_u_print_debug(state,"Manifest segment length",length,NULL);
+
+  if ((splt_mf_put_data(manifest, output_fname, strlen(output_fname)) == -1) ||
+      (splt_mf_put_number(manifest, (unsigned long long) offset, 8) == -1) ||
+      (splt_mf_put_number(manifest, (unsigned long long) length, 8) == -1) ||
+      (splt_mf_put_data(manifest, prefix, prefix_length) == -1) ||
+      (splt_mf_put_data(manifest, suffix, suffix_length) == -1))
+  {
+    splt_t_set_strerror_msg(state);
+    splt_t_set_error_data(state, splt_t_get_manifest_filename(state));
+    return SPLT_ERROR_CANT_WRITE_TO_OUTPUT_FILE;
+  }
+
+  return SPLT_OK;
+}
+
+//closes the manifest file
+void splt_mf_close(splt_state *state, int *error)
+{
+  if (state->manifest)
+  {
+    if (fclose(state->manifest) != 0)
+    {
+      splt_t_set_strerror_msg(state);
+      splt_t_set_error_data(state, splt_t_get_manifest_filename(state));
+      *error = SPLT_ERROR_CANNOT_CLOSE_FILE;
+    }
+    state->manifest = NULL;
+  }
+}
@@ -169,6 +169,64 @@ int mp3splt_set_m3u_filename(splt_state *state, const char *filename)
   return error;
 }
 
+//sets the manifest filename; if set, the split files are not
+//created but described in the manifest
+int mp3splt_set_manifest_filename(splt_state *state, const char *filename)
+{
+  int error = SPLT_OK;
+
+  if (state != NULL)
+  {
+    if (!splt_t_library_locked(state))
+    {
+      splt_t_lock_library(state);
+
+      error = splt_t_set_manifest_filename(state, filename);
+
+      splt_t_unlock_library(state);
+    }
+    else
+    {
+      error = SPLT_ERROR_LIBRARY_LOCKED;
+    }
+  }
+  else
+  {
+    error = SPLT_ERROR_STATE_NULL;
+  }
+
+  return error;
+}
+
+//sets the journal filename; if set, the split files are recorded in the
+//journal and a split with the same plan resumes from it
+int mp3splt_set_journal_filename(splt_state *state, const char *filename)
+{
+  int error = SPLT_OK;
+
+  if (state != NULL)
+  {
+    if (!splt_t_library_locked(state))
+    {
+      splt_t_lock_library(state);
+
+      error = splt_t_set_journal_filename(state, filename);
+
+      splt_t_unlock_library(state);
+    }
+    else
+    {
+      error = SPLT_ERROR_LIBRARY_LOCKED;
+    }
+  }
+  else
+  {
+    error = SPLT_ERROR_STATE_NULL;
+  }
+
+  return error;
+}
+
 //sets the m3u filename
 int mp3splt_set_silence_log_filename(splt_state *state, const char *filename)
 {
@@ -304,6 +362,64 @@ int mp3splt_set_silence_level_function(splt_state *state,
   return error;
 }
 
+//the entry i of 'levels' gets the highest level from i * resolution
+//to (i + 1) * resolution seconds; entries not scanned are not modified
+int mp3splt_set_silence_levels_buffer(splt_state *state,
+    float *levels, long number, float resolution)
+{
+  int error = SPLT_OK;
+
+  if (state != NULL)
+  {
+    if (!splt_t_library_locked(state))
+    {
+      splt_t_lock_library(state);
+
+      if (resolution <= 0)
+      {
+        resolution = SPLT_DEFAULT_SILENCE_LEVELS_RESOLUTION;
+      }
+
+      splt_silence_levels *silence_levels = &state->split.silence_levels;
+      silence_levels->levels = levels;
+      silence_levels->number = levels ? number : 0;
+      silence_levels->filled = 0;
+      silence_levels->resolution = resolution;
+      silence_levels->current = -1;
+
+      splt_t_unlock_library(state);
+    }
+    else
+    {
+      error = SPLT_ERROR_LIBRARY_LOCKED;
+    }
+  }
+  else
+  {
+    error = SPLT_ERROR_STATE_NULL;
+  }
+
+  return error;
+}
+
+//returns the number of entries of the silence levels buffer filled
+long mp3splt_get_silence_levels_filled(splt_state *state, int *error)
+{
+  int erro = SPLT_OK;
+  int *err = &erro;
+  if (error != NULL) { err = error; }
+
+  if (state != NULL)
+  {
+    return state->split.silence_levels.filled;
+  }
+  else
+  {
+    *err = SPLT_ERROR_STATE_NULL;
+    return -1;
+  }
+}
+
 /************************************/
 /* Splitpoints                      */
 
@@ -665,226 +781,130 @@ int mp3splt_split(splt_state *state)
     {
       splt_t_lock_library(state);
 
-      splt_u_print_debug(state,"Starting to split file...",0,NULL);
-
-      char *new_filename_path = NULL;
-      char *fname_to_split = splt_t_get_filename_to_split(state);
-
-      splt_u_print_debug(state,"Original filename/path to split is ",0, fname_to_split);
-
-      if (splt_t_is_stdin(state))
-      {
-        splt_t_set_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_TRUE);
-      }
-
       splt_t_set_stop_split(state, SPLT_FALSE);
 
-      //we set default internal options
-      splt_t_set_default_iopts(state);
-
-      //we put the real splitnumber in the splitnumber variable
-      //that could be changed (see splitnumber in mp3splt.h)
-      state->split.splitnumber = state->split.real_splitnumber;
-      splt_t_set_current_split(state,0);
-
-      if (!splt_io_check_if_file(state, fname_to_split))
-      {
-        error = SPLT_ERROR_INEXISTENT_FILE;
-        splt_t_unlock_library(state);
-        return error;
-      }
-
-#ifndef __WIN32__
-      char *linked_fname = splt_io_get_linked_fname(fname_to_split);
-      if (linked_fname)
-      {
-        char infos[2048] = { '\0' };
-        snprintf(infos, 2048, _(" info: resolving linked filename to '%s'\n"), linked_fname);
-        splt_t_put_info_message_to_client(state, infos);
-
-        splt_t_set_filename_to_split(state, linked_fname);
-        fname_to_split = splt_t_get_filename_to_split(state);
-
-        free(linked_fname);
-        linked_fname = NULL;
-      }
-#endif
-
-      //if the new_filename_path is "", we put the directory of
-      //the current song
-      new_filename_path = splt_check_put_dir_of_cur_song(fname_to_split,
-          splt_t_get_path_of_split(state), &error);
-      if (error < 0)
-      {
-        splt_t_unlock_library(state);
-        return error;
-      }
-
-      //checks and sets correct options
-      splt_check_set_correct_options(state);
-
-      //if we have compatible options
-      //this function is optional,
-      if (! splt_check_compatible_options(state))
-      {
-        error = SPLT_ERROR_INCOMPATIBLE_OPTIONS;
-        goto function_end;
-      }
-
-      int split_type = splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+      splt_s_split_file(state, &error);
 
-      //normal split checks
-      if (split_type == SPLT_OPTION_NORMAL_MODE)
-      {
-        if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
-        {
-          //check if we have at least 2 splitpoints
-          if (splt_t_get_splitnumber(state) < 2)
-          {
-            error = SPLT_ERROR_SPLITPOINTS;
-            goto function_end;
-          }
-        }
+      splt_t_unlock_library(state);
+    }
+    else
+    {
+      error = SPLT_ERROR_LIBRARY_LOCKED;
+    }
+  }
+  else
+  {
+    error = SPLT_ERROR_STATE_NULL;
+  }
 
-        //we check if the splitpoints are in order
-        splt_check_if_splitpoints_in_order(state, &error);
-        if (error < 0) { goto function_end; }
-      }
+  return error;
+}
 
-      splt_t_set_new_filename_path(state, new_filename_path, &error);
-      if (error < 0) { goto function_end; }
+//cancels the current split
+//returns possible errors
+void mp3splt_stop_split(splt_state *state, int *error)
+{
+  int erro = SPLT_OK;
+  int *err = &erro;
+  if (error != NULL) { err = error; }
 
-      error = splt_u_create_directories(state, new_filename_path);
-      if (error < 0) { goto function_end; }
+  if (state != NULL)
+  {
+    splt_t_set_stop_split(state, SPLT_TRUE);
+  }
+  else
+  {
+    *err = SPLT_ERROR_STATE_NULL;
+  }
+}
 
-      splt_check_if_new_filename_path_correct(state, new_filename_path, &error);
-      if (error < 0) { goto function_end; }
+//starts the split in a new thread
+//returns the handle or NULL if error
+splt_async_split *mp3splt_split_async(splt_state *state, int *error)
+{
+  int erro = SPLT_OK;
+  int *err = &erro;
+  if (error != NULL) { err = error; }
 
-      if (splt_t_get_int_option(state, SPLT_OPT_TAGS) == SPLT_TAGS_ORIGINAL_FILE)
-      {
-        splt_u_put_tags_from_string(state, SPLT_ORIGINAL_TAGS_DEFAULT, &error);
-        if (error < 0)
-        {
-          splt_p_end(state, &error);
-          goto function_end;
-        }
-      }
+  splt_async_split *as = NULL;
 
-      //we check if mp3 or ogg
-      splt_check_file_type(state, &error);
-      if (error < 0) { goto function_end; }
+  if (state != NULL)
+  {
+    if (!splt_t_library_locked(state))
+    {
+      splt_t_lock_library(state);
 
-      const char *plugin_name = splt_p_get_name(state,&error);
-      if (error < 0) { goto function_end; }
-      char infos[2048] = { '\0' };
-      snprintf(infos,2048,_(" info: file matches the plugin '%s'\n"), plugin_name);
-      splt_t_put_info_message_to_client(state, infos);
+      //cleared before the split thread starts, so that a cancel called
+      //right after we return is not lost
+      splt_t_set_stop_split(state, SPLT_FALSE);
 
-      //print the new m3u fname
-      char *m3u_fname_with_path = splt_t_get_m3u_file_with_path(state, &error);
-      if (error < 0) { goto function_end; }
-      if (m3u_fname_with_path)
+      //the library stays locked until mp3splt_async_join
+      as = splt_as_start(state, err);
+      if (as == NULL)
       {
-        int malloc_size = strlen(m3u_fname_with_path) + 200;
-        char *mess = malloc(sizeof(char) * (strlen(m3u_fname_with_path) + 200));
-        if (!mess) { error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; goto function_end; }
-        snprintf(mess, malloc_size, _(" M3U file '%s' will be created.\n"),
-            m3u_fname_with_path);
-        splt_t_put_info_message_to_client(state, mess);
-        free(mess);
-        mess = NULL;
-        free(m3u_fname_with_path);
-        m3u_fname_with_path = NULL;
+        splt_t_unlock_library(state);
       }
+    }
+    else
+    {
+      *err = SPLT_ERROR_LIBRARY_LOCKED;
+    }
+  }
+  else
+  {
+    *err = SPLT_ERROR_STATE_NULL;
+  }
 
-      //init the plugin for split
-      splt_p_init(state, &error);
-      if (error < 0) { goto function_end; }
-
-      splt_u_print_debug(state,"parse type of split...",0,NULL);
-
-      char message[1024] = { '\0' };
-      //print Working with auto adjust if necessary
-      if (splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST)
-          && !  splt_t_get_int_option(state, SPLT_OPT_QUIET_MODE))
-      {
-        if ((split_type != SPLT_OPTION_WRAP_MODE)
-            && (split_type != SPLT_OPTION_SILENCE_MODE)
-            && (split_type != SPLT_OPTION_ERROR_MODE))
-        {
-          snprintf(message, 1024, _(" Working with SILENCE AUTO-ADJUST (Threshold:"
-                " %.1f dB Gap: %d sec Offset: %.2f)\n"),
-              splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD),
-              splt_t_get_int_option(state, SPLT_OPT_PARAM_GAP),
-              splt_t_get_float_option(state, SPLT_OPT_PARAM_OFFSET));
-
-          splt_t_put_info_message_to_client(state, message);
-        }
-      }
+  return as;
+}
 
-      //the type of the split
-      switch (split_type)
-      {
-        case SPLT_OPTION_WRAP_MODE:
-          splt_s_wrap_split(state, &error);
-          break;
-        case SPLT_OPTION_SILENCE_MODE:
-          splt_s_silence_split(state, &error);
-          break; 
-        case SPLT_OPTION_TIME_MODE:
-          splt_s_time_split(state, &error);
-          break;
-        case SPLT_OPTION_LENGTH_MODE:
-          splt_s_equal_length_split(state, &error);
-          break;
-        case SPLT_OPTION_ERROR_MODE:
-          splt_s_error_split(state, &error);
-          break;
-        default:
-          //this is the normal split
-          if (split_type == SPLT_OPTION_NORMAL_MODE)
-          {
-            //if we don't have STDIN
-            if (! splt_t_is_stdin(state))
-            {
-              //total time of the song
-              splt_check_splitpts_inf_song_length(state, &error);
-              if (error < 0) { goto function_end; }
-            }
-          }
+//returns the file descriptor to poll or -1 if no handle
+int mp3splt_async_get_fd(splt_async_split *as)
+{
+  if (as != NULL)
+  {
+    return splt_as_get_fd(as);
+  }
 
-          splt_s_normal_split(state, &error);
-          break;
-      }
+  return -1;
+}
 
-      //ends the 'init' of the plugin for the split
-      splt_p_end(state, &error);
+//returns the status of the asynchronous split
+int mp3splt_async_get_status(splt_async_split *as, float *percent_progress)
+{
+  if (as != NULL)
+  {
+    return splt_as_get_status(as, percent_progress);
+  }
 
-function_end:
-      if (new_filename_path)
-      {
-        free(new_filename_path);
-        new_filename_path = NULL;
-      }
+  return SPLT_ASYNC_FINISHED;
+}
 
-      splt_t_unlock_library(state);
-    }
-    else
-    {
-      error = SPLT_ERROR_LIBRARY_LOCKED;
-    }
+//cancels the asynchronous split
+void mp3splt_async_cancel(splt_async_split *as)
+{
+  if (as != NULL)
+  {
+    splt_t_set_stop_split(splt_as_get_state(as), SPLT_TRUE);
   }
-  else
+}
+
+//waits for the asynchronous split and returns its result
+int mp3splt_async_join(splt_async_split *as)
+{
+  if (as != NULL)
   {
-    error = SPLT_ERROR_STATE_NULL;
+    splt_state *state = splt_as_get_state(as);
+    int error = splt_as_join(as);
+    splt_t_unlock_library(state);
+    return error;
   }
 
-  return error;
+  return SPLT_ERROR_STATE_NULL;
 }
 
-//cancels the current split
-//returns possible errors
-void mp3splt_stop_split(splt_state *state, int *error)
+//returns the performance counters of the current or last split
+const splt_stats *mp3splt_get_stats(splt_state *state, int *error)
 {
   int erro = SPLT_OK;
   int *err = &erro;
@@ -892,11 +912,18 @@ void mp3splt_stop_split(splt_state *state, int *error)
 
   if (state != NULL)
   {
-    splt_t_set_stop_split(state, SPLT_TRUE);
+    //the split thread may be changing the counters
+    if (state->async != NULL)
+    {
+      return splt_as_get_stats(state->async);
+    }
+
+    return &state->stats;
   }
   else
   {
     *err = SPLT_ERROR_STATE_NULL;
+    return NULL;
   }
 }
 
@@ -1021,7 +1048,7 @@ const splt_freedb_results *mp3splt_get_freedb_search(splt_state *state,
   if (state != NULL)
   {
     //we copy the search string, in order not to modify the original one
-    char *search = strdup(search_string);
+    char *search = splt_u_strdup(search_string);
     if (search != NULL)
     {
       *err = splt_freedb_process_search(state, search, search_type,
@@ -1395,7 +1422,7 @@ char **mp3splt_find_filenames(splt_state *state, const char *filename,
       {
         if (splt_u_file_is_supported_by_plugins(state, filename))
         {
-          found_files = malloc(sizeof(char *));
+          found_files = splt_u_malloc(sizeof(char *));
           if (!found_files)
           {
             *err = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -1403,7 +1430,7 @@ char **mp3splt_find_filenames(splt_state *state, const char *filename,
           }
 
           int fname_size = strlen(filename) + 1;
-          found_files[0] = malloc(sizeof(char) * fname_size);
+          found_files[0] = splt_u_malloc(sizeof(char) * fname_size);
           memset(found_files[0], '\0', fname_size);
 
           if (!found_files[0])
@@ -1418,7 +1445,7 @@ char **mp3splt_find_filenames(splt_state *state, const char *filename,
       }
       else
       {
-        char *dir = strdup(filename);
+        char *dir = splt_u_strdup(filename);
         if (dir == NULL)
         {
           *err = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
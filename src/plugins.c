@@ -50,11 +50,11 @@ int splt_p_append_plugin_scan_dir(splt_state *state, char *dir)
   if (pl->plugins_scan_dirs == NULL)
   {
     //allocate memory
-    pl->plugins_scan_dirs = malloc(sizeof(char *));
+    pl->plugins_scan_dirs = splt_u_malloc(sizeof(char *));
   }
   else
   {
-    pl->plugins_scan_dirs = realloc(pl->plugins_scan_dirs,
+    pl->plugins_scan_dirs = splt_u_realloc(pl->plugins_scan_dirs,
         sizeof(char *) * (pl->number_of_dirs_to_scan + 1));
   }
   if (pl->plugins_scan_dirs == NULL)
@@ -64,7 +64,7 @@ int splt_p_append_plugin_scan_dir(splt_state *state, char *dir)
   pl->plugins_scan_dirs[pl->number_of_dirs_to_scan] = NULL;
 
   //allocate memory for this directory name
-  pl->plugins_scan_dirs[pl->number_of_dirs_to_scan] = malloc(sizeof(char) * (strlen(dir)+1));
+  pl->plugins_scan_dirs[pl->number_of_dirs_to_scan] = splt_u_malloc(sizeof(char) * (strlen(dir)+1));
   if (pl->plugins_scan_dirs[pl->number_of_dirs_to_scan] == NULL)
   {
     return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -187,7 +187,7 @@ static int splt_p_scan_dir_for_plugins(splt_state *state, splt_plugins *pl, cons
 
       //get the full directory + filename
       int dir_and_fname_len = fname_len + directory_len + 3;
-      char *dir_and_fname = malloc(sizeof(char) * dir_and_fname_len);
+      char *dir_and_fname = splt_u_malloc(sizeof(char) * dir_and_fname_len);
       if (dir_and_fname == NULL)
       {
         return_value = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -224,7 +224,7 @@ static int splt_p_scan_dir_for_plugins(splt_state *state, splt_plugins *pl, cons
           goto end;
         }
 
-        pl->data[pl->number_of_plugins_found].func = malloc(sizeof(splt_plugin_func));
+        pl->data[pl->number_of_plugins_found].func = splt_u_malloc(sizeof(splt_plugin_func));
         if (pl->data[pl->number_of_plugins_found].func == NULL)
         {
           return_value = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -232,7 +232,7 @@ static int splt_p_scan_dir_for_plugins(splt_state *state, splt_plugins *pl, cons
         }
         memset(pl->data[pl->number_of_plugins_found].func,0,sizeof(splt_plugin_func));
 
-        pl->data[pl->number_of_plugins_found].plugin_filename = malloc(sizeof(char) *
+        pl->data[pl->number_of_plugins_found].plugin_filename = splt_u_malloc(sizeof(char) *
             dir_and_fname_len);
         if (pl->data[pl->number_of_plugins_found].plugin_filename == NULL)
         {
@@ -323,7 +323,7 @@ int splt_p_move_replace_plugin_data(splt_state *state, int old, int new)
 
   splt_t_free_plugin_data(&pl->data[new]);
 
-  pl->data[new].func = malloc(sizeof(splt_plugin_func));
+  pl->data[new].func = splt_u_malloc(sizeof(splt_plugin_func));
   if (pl->data[new].func == NULL)
   {
     return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -331,7 +331,7 @@ int splt_p_move_replace_plugin_data(splt_state *state, int old, int new)
   memset(pl->data[new].func,0,sizeof(splt_plugin_func));
 
   int plugin_fname_len = strlen(pl->data[old].plugin_filename) + 1;
-  pl->data[new].plugin_filename = malloc(sizeof(char) * plugin_fname_len);
+  pl->data[new].plugin_filename = splt_u_malloc(sizeof(char) * plugin_fname_len);
   if (pl->data[new].plugin_filename == NULL)
   {
     return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -389,11 +389,11 @@ static int splt_p_open_get_valid_plugins(splt_state *state)
       //afterwards
       if (! plugin_index_to_remove)
       {
-        plugin_index_to_remove = malloc(sizeof(int));
+        plugin_index_to_remove = splt_u_malloc(sizeof(int));
       }
       else
       {
-        plugin_index_to_remove = realloc(plugin_index_to_remove, sizeof(int) * (number_of_plugins_to_remove + 1));
+        plugin_index_to_remove = splt_u_realloc(plugin_index_to_remove, sizeof(int) * (number_of_plugins_to_remove + 1));
       }
       plugin_index_to_remove[number_of_plugins_to_remove] = i;
       number_of_plugins_to_remove++;
@@ -437,11 +437,11 @@ static int splt_p_open_get_valid_plugins(splt_state *state)
             {
               if (! plugin_index_to_remove)
               {
-                plugin_index_to_remove = malloc(sizeof(int));
+                plugin_index_to_remove = splt_u_malloc(sizeof(int));
               }
               else
               {
-                plugin_index_to_remove = realloc(plugin_index_to_remove,
+                plugin_index_to_remove = splt_u_realloc(plugin_index_to_remove,
                     sizeof(int) * (number_of_plugins_to_remove + 1));
               }
               plugin_index_to_remove[number_of_plugins_to_remove] = i;
@@ -544,6 +544,12 @@ int splt_p_find_get_plugins_data(splt_state *state)
         lt_dlsym(pl->data[i].plugin_handle, "splt_pl_end");
       pl->data[i].func->scan_silence =
         lt_dlsym(pl->data[i].plugin_handle, "splt_pl_scan_silence");
+      pl->data[i].func->scan_silence_window =
+        lt_dlsym(pl->data[i].plugin_handle, "splt_pl_scan_silence_window");
+      pl->data[i].func->stream_silence_split =
+        lt_dlsym(pl->data[i].plugin_handle, "splt_pl_stream_silence_split");
+      pl->data[i].func->rewrite_tags =
+        lt_dlsym(pl->data[i].plugin_handle, "splt_pl_rewrite_tags");
       pl->data[i].func->set_original_tags =
         lt_dlsym(pl->data[i].plugin_handle, "splt_pl_set_original_tags");
       pl->data[i].func->set_plugin_info =
@@ -650,7 +656,11 @@ int splt_p_check_plugin_is_for_file(splt_state *state, int *error)
   {
     if (pl->data[current_plugin].func->check_plugin_is_for_file != NULL)
     {
-      return pl->data[current_plugin].func->check_plugin_is_for_file(state, error);
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_PLUGIN_PROBE);
+      int is_for_file =
+        pl->data[current_plugin].func->check_plugin_is_for_file(state, error);
+      splt_st_leave_phase(state, phase);
+      return is_for_file;
     }
     else
     {
@@ -675,7 +685,10 @@ void splt_p_search_syncerrors(splt_state *state, int *error)
     {
       //we free previous sync errors if necesssary
       splt_t_serrors_free(state);
+      //the sync errors are the cut points of the error mode split
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_CUTPOINT_SEARCH);
       pl->data[current_plugin].func->search_syncerrors(state, error);
+      splt_st_leave_phase(state, phase);
     }
     else
     {
@@ -697,7 +710,9 @@ void splt_p_dewrap(splt_state *state, int listonly, const char *dir, int *error)
   {
     if (pl->data[current_plugin].func->dewrap != NULL)
     {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_WRITE);
       pl->data[current_plugin].func->dewrap(state, listonly, dir, error);
+      splt_st_leave_phase(state, phase);
     }
     else
     {
@@ -724,8 +739,10 @@ double splt_p_split(splt_state *state, const char *final_fname, double begin_poi
 
     if (pl->data[current_plugin].func->split != NULL)
     {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_WRITE);
       double new_end_point = pl->data[current_plugin].func->split(state, final_fname,
           begin_point, end_point, error, save_end_point);
+      splt_st_leave_phase(state, phase);
 
       splt_u_print_debug(state, "New end point after split ...",new_end_point,NULL);
 
@@ -753,7 +770,9 @@ void splt_p_init(splt_state *state, int *error)
   {
     if (pl->data[current_plugin].func->init != NULL)
     {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_INFO);
       pl->data[current_plugin].func->init(state, error);
+      splt_st_leave_phase(state, phase);
     }
     else
     {
@@ -799,7 +818,9 @@ int splt_p_simple_split(splt_state *state, const char *output_fname, off_t begin
   {
     if (pl->data[current_plugin].func->simple_split != NULL)
     {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_WRITE);
       error = pl->data[current_plugin].func->simple_split(state, output_fname, begin, end);
+      splt_st_leave_phase(state, phase);
     }
     else
     {
@@ -823,7 +844,10 @@ int splt_p_scan_silence(splt_state *state, int *error)
   {
     if (pl->data[current_plugin].func->scan_silence != NULL)
     {
-      return pl->data[current_plugin].func->scan_silence(state, error);
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_SILENCE_SCAN);
+      int found = pl->data[current_plugin].func->scan_silence(state, error);
+      splt_st_leave_phase(state, phase);
+      return found;
     }
     else
     {
@@ -834,6 +858,138 @@ int splt_p_scan_silence(splt_state *state, int *error)
   return 0;
 }
 
+//returns SPLT_TRUE if the current plugin can scan a part of the file
+int splt_p_can_scan_silence_window(splt_state *state)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_t_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    return SPLT_FALSE;
+  }
+
+  return pl->data[current_plugin].func->scan_silence_window != NULL;
+}
+
+//scans the part of the file from 'begin_point' to 'end_point' seconds,
+//recording the envelope; parts must be scanned in increasing order
+int splt_p_scan_silence_window(splt_state *state, double begin_point,
+    double end_point, int *error)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_t_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    *error = SPLT_ERROR_NO_PLUGIN_FOUND;
+    return 0;
+  }
+  else
+  {
+    if (pl->data[current_plugin].func->scan_silence_window != NULL)
+    {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_SILENCE_SCAN);
+      int found = pl->data[current_plugin].func->scan_silence_window(state,
+          begin_point, end_point, error);
+      splt_st_leave_phase(state, phase);
+      return found;
+    }
+    else
+    {
+      *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+    }
+  }
+
+  return 0;
+}
+
+//returns SPLT_TRUE if the current plugin can split a non seekable
+//input in silence mode
+int splt_p_can_stream_silence_split(splt_state *state)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_t_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    return SPLT_FALSE;
+  }
+
+  return pl->data[current_plugin].func->stream_silence_split != NULL;
+}
+
+//splits a non seekable input in silence mode, reading it only once
+//returns the number of tracks written
+int splt_p_stream_silence_split(splt_state *state, int *error)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_t_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    *error = SPLT_ERROR_NO_PLUGIN_FOUND;
+    return 0;
+  }
+  else
+  {
+    if (pl->data[current_plugin].func->stream_silence_split != NULL)
+    {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_SILENCE_SCAN);
+      int tracks =
+        pl->data[current_plugin].func->stream_silence_split(state, error);
+      splt_st_leave_phase(state, phase);
+      return tracks;
+    }
+    else
+    {
+      *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+    }
+  }
+
+  return 0;
+}
+
+//returns SPLT_TRUE if the current plugin can rewrite the tags of a
+//split file without splitting it again
+int splt_p_can_rewrite_tags(splt_state *state)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_t_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    return SPLT_FALSE;
+  }
+
+  return pl->data[current_plugin].func->rewrite_tags != NULL;
+}
+
+//rewrites the tags of the split file 'output_fname' with the current tags
+//returns SPLT_TRUE if the tags have been rewritten
+int splt_p_rewrite_tags(splt_state *state, const char *output_fname, int *error)
+{
+  splt_plugins *pl = state->plug;
+  int current_plugin = splt_t_get_current_plugin(state);
+  if ((current_plugin < 0) || (current_plugin >= pl->number_of_plugins_found))
+  {
+    *error = SPLT_ERROR_NO_PLUGIN_FOUND;
+    return SPLT_FALSE;
+  }
+  else
+  {
+    if (pl->data[current_plugin].func->rewrite_tags != NULL)
+    {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_TAGS);
+      int rewritten =
+        pl->data[current_plugin].func->rewrite_tags(state, output_fname, error);
+      splt_st_leave_phase(state, phase);
+      return rewritten;
+    }
+    else
+    {
+      *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+    }
+  }
+
+  return SPLT_FALSE;
+}
+
 void splt_p_set_original_tags(splt_state *state, int *error)
 {
   splt_plugins *pl = state->plug;
@@ -847,7 +1003,9 @@ void splt_p_set_original_tags(splt_state *state, int *error)
   {
     if (pl->data[current_plugin].func->set_original_tags != NULL)
     {
+      int phase = splt_st_enter_phase(state, SPLT_PHASE_TAGS);
       pl->data[current_plugin].func->set_original_tags(state, error);
+      splt_st_leave_phase(state, phase);
     }
   }
 }
@@ -84,9 +84,12 @@ static long splt_s_split(splt_state *state, int first_splitpoint,
 
   long new_end_point = split_end;
 
+  //the next split file may be skipped if it is in the journal: the
+  //plugin must then find its begin instead of starting from this end
   int save_end_point = SPLT_TRUE;
   if (splt_t_get_splitpoint_type(state, second_splitpoint, &get_error) == SPLT_SKIPPOINT ||
-      splt_t_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0)
+      splt_t_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0 ||
+      splt_jn_has_segment(state, second_splitpoint))
   {
     save_end_point = SPLT_FALSE;
   }
@@ -137,6 +140,206 @@ static long splt_s_split(splt_state *state, int first_splitpoint,
   return new_end_point;
 }
 
+//auto-adjusts all the end splitpoints before splitting: the windows
+//around the end splitpoints are merged and decoded in one ordered
+//pass, and the silences are then searched in the recorded envelope
+//returns SPLT_TRUE if the splitpoints have been adjusted
+static int splt_s_adjust_splitpoints(splt_state *state, int *error)
+{
+  int gap = splt_t_get_int_option(state, SPLT_OPT_PARAM_GAP);
+  float threshold = splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD);
+  float offset = splt_t_get_float_option(state, SPLT_OPT_PARAM_OFFSET);
+
+  if (!splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST) || (gap <= 0) ||
+      (splt_t_get_long_option(state, SPLT_OPT_OVERLAP_TIME) > 0) ||
+      !splt_p_can_scan_silence_window(state))
+  {
+    return SPLT_FALSE;
+  }
+
+  int adjusted = SPLT_FALSE;
+  int get_error = SPLT_OK;
+  int number_of_splitpoints = splt_t_get_splitnumber(state);
+
+  //window of each end splitpoint; a negative length means no adjust
+  double *window_begin = splt_u_malloc(sizeof(double) * number_of_splitpoints);
+  double *window_length = splt_u_malloc(sizeof(double) * number_of_splitpoints);
+  if (!window_begin || !window_length)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    goto function_end;
+  }
+
+  int i = 0;
+  for (i = 0;i < number_of_splitpoints;i++)
+  {
+    window_length[i] = -1;
+  }
+
+  double previous_begin = 0;
+  for (i = 0;i < number_of_splitpoints - 1;i++)
+  {
+    if (splt_t_get_splitpoint_type(state, i, &get_error) == SPLT_SKIPPOINT)
+    {
+      continue;
+    }
+
+    long split_begin = splt_t_get_splitpoint_value(state, i, &get_error);
+    long split_end = splt_t_get_splitpoint_value(state, i+1, &get_error);
+    if (split_end == LONG_MAX)
+    {
+      continue;
+    }
+
+    double begin = split_begin / 100.0;
+    double end = split_end / 100.0;
+    if (splt_u_fend_sec_is_bigger_than_total_time(state, end))
+    {
+      continue;
+    }
+
+    //as the in-split adjust does
+    double adj = gap;
+    if (adj > end - begin)
+    {
+      adj = end - begin;
+    }
+    if (adj <= 0)
+    {
+      continue;
+    }
+
+    window_begin[i+1] = (end > adj) ? end - adj : end;
+    window_length[i+1] = 2 * adj;
+
+    //unordered splitpoints are left to the in-split adjust
+    if (window_begin[i+1] < previous_begin)
+    {
+      goto function_end;
+    }
+    previous_begin = window_begin[i+1];
+  }
+
+  splt_en_start_recording(state);
+
+  //decode the merged windows in increasing order
+  double merged_begin = 0, merged_end = -1;
+  for (i = 0;i <= number_of_splitpoints;i++)
+  {
+    short last = (i == number_of_splitpoints);
+    if (!last && window_length[i] < 0)
+    {
+      continue;
+    }
+
+    //windows closer than a second are decoded together
+    if (!last && (merged_end >= 0) && (window_begin[i] <= merged_end + 1) &&
+        (window_begin[i] >= merged_begin))
+    {
+      if (window_begin[i] + window_length[i] > merged_end)
+      {
+        merged_end = window_begin[i] + window_length[i];
+      }
+      continue;
+    }
+
+    if (merged_end >= 0)
+    {
+      splt_u_print_debug(state, "Scanning adjust window from", merged_begin, NULL);
+      splt_p_scan_silence_window(state, merged_begin, merged_end, error);
+      splt_t_ssplit_free(&state->silence_list);
+      if (*error < 0) { goto function_end; }
+
+      if (splt_t_split_is_canceled(state))
+      {
+        *error = SPLT_SPLIT_CANCELLED;
+        goto function_end;
+      }
+    }
+
+    if (!last)
+    {
+      merged_begin = window_begin[i];
+      merged_end = window_begin[i] + window_length[i];
+    }
+  }
+
+  for (i = 0;i < number_of_splitpoints;i++)
+  {
+    if (window_length[i] < 0)
+    {
+      continue;
+    }
+
+    double new_end = window_begin[i] + gap;
+    int found = splt_en_detect_silence_in(state, window_begin[i],
+        window_length[i], threshold, 0.f, error);
+    if (found < 0) { goto function_end; }
+    if (found > 0)
+    {
+      int longest = splt_t_ssplit_get_longest(&state->silence_list);
+      new_end = window_begin[i] +
+        splt_u_silence_position(&state->silence_list, longest, offset);
+    }
+    splt_t_ssplit_free(&state->silence_list);
+
+    splt_t_set_splitpoint_value(state, i, (long) (new_end * 100));
+  }
+
+  adjusted = SPLT_TRUE;
+
+function_end:
+  splt_t_ssplit_free(&state->silence_list);
+  splt_en_free(state);
+
+  if (window_begin)
+  {
+    free(window_begin);
+    window_begin = NULL;
+  }
+  if (window_length)
+  {
+    free(window_length);
+    window_length = NULL;
+  }
+
+  return adjusted;
+}
+
+//puts the split file starting at the splitpoint 'index' if it has been
+//split before, as recorded in the journal
+//returns SPLT_TRUE if the split file does not need to be split again
+static int splt_s_resume_from_journal(splt_state *state, int index, int *error)
+{
+  if (!splt_jn_is_enabled(state))
+  {
+    return SPLT_FALSE;
+  }
+
+  int resumed = SPLT_FALSE;
+
+  char *final_fname = splt_u_get_fname_with_path_and_extension(state, error);
+  if (*error < 0) { goto function_end; }
+
+  resumed = splt_jn_resume_segment(state, index, final_fname);
+  if (resumed)
+  {
+    splt_t_update_progress(state,1.0,1.0,1,1,1);
+
+    int err = splt_t_put_split_file(state, final_fname);
+    if (err < 0) { *error = err; }
+  }
+
+function_end:
+  if (final_fname)
+  {
+    free(final_fname);
+    final_fname = NULL;
+  }
+
+  return resumed;
+}
+
 //splits the file with multiple points
 void splt_s_multiple_split(splt_state *state, int *error)
 {
@@ -145,6 +348,25 @@ void splt_s_multiple_split(splt_state *state, int *error)
 
   splt_t_set_oformat_digits(state);
 
+  //the plan of the journal has the splitpoints before they are adjusted
+  splt_jn_open(state, error);
+  if (*error < 0) { return; }
+
+  //the splitpoints are adjusted before splitting if we can
+  int auto_adjust = splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST);
+  int gap = splt_t_get_int_option(state, SPLT_OPT_PARAM_GAP);
+  int adjusted = splt_s_adjust_splitpoints(state, error);
+  if (*error < 0)
+  {
+    splt_jn_close(state, &err);
+    return;
+  }
+  if (adjusted)
+  {
+    splt_t_set_int_option(state, SPLT_OPT_AUTO_ADJUST, SPLT_FALSE);
+    splt_t_set_int_option(state, SPLT_OPT_PARAM_GAP, 0);
+  }
+
   if (split_type == SPLT_OPTION_NORMAL_MODE)
   {
     splt_t_put_info_message_to_client(state, _(" info: starting normal split\n"));
@@ -182,6 +404,20 @@ void splt_s_multiple_split(splt_state *state, int *error)
       err = splt_u_finish_tags_and_put_output_format_filename(state, i);
       if (err < 0) { *error = err; goto end; }
 
+      //the split files of the journal are not split again
+      if (splt_s_resume_from_journal(state, i, error))
+      {
+        splt_array_append(new_end_points, (void *)saved_end_point);
+        splt_t_set_splitpoint_value(state, i+1, saved_end_point);
+
+        if (*error < 0) { goto end; }
+        if (*error == SPLT_OK) { *error = SPLT_OK_SPLIT; }
+
+        i++;
+        continue;
+      }
+      if (*error < 0) { goto end; }
+
       long new_end_point = splt_s_split(state, i, i+1, error);
       splt_array_append(new_end_points, (void *)new_end_point);
 
@@ -209,6 +445,22 @@ end:
   }
 
   splt_array_free(&new_end_points);
+
+  if (adjusted)
+  {
+    splt_t_set_int_option(state, SPLT_OPT_AUTO_ADJUST, auto_adjust);
+    splt_t_set_int_option(state, SPLT_OPT_PARAM_GAP, gap);
+  }
+
+  if (*error >= 0)
+  {
+    splt_jn_close(state, error);
+  }
+  else
+  {
+    err = SPLT_OK;
+    splt_jn_close(state, &err);
+  }
 }
 
 void splt_s_normal_split(splt_state *state, int *error)
@@ -586,51 +838,20 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
   //found is the number of silence splits found
   int found = 0;
   int splitpoints_appended = 0;
-  struct splt_ssplit *temp = NULL;
+  int *selected = NULL;
   int append_error = SPLT_OK;
   //we get some options
   float offset = splt_t_get_float_option(state,SPLT_OPT_PARAM_OFFSET);
   int number_tracks = splt_t_get_int_option(state, SPLT_OPT_PARAM_NUMBER_TRACKS);
 
-  //if we have a log file, read silence from logs
+  //if we have a silence log file matching the file to split, we
+  //detect the silence from the envelope it holds
   int we_read_silence_from_logs = SPLT_FALSE;
-  FILE *log_file = NULL;
   char *log_fname = splt_t_get_silence_log_fname(state);
   if (splt_t_get_int_option(state, SPLT_OPT_ENABLE_SILENCE_LOG))
   {
-    if ((log_file = splt_u_fopen(log_fname, "r")))
-    {
-      char log_silence_fname[1024] = { '\0' };
-      fgets(log_silence_fname, 1024, log_file);
-      if (log_silence_fname[0] != '\0')
-      {
-        //remove '\n' at the end
-        log_silence_fname[strlen(log_silence_fname)-1] = '\0';
-        if (strcmp(log_silence_fname, splt_t_get_filename_to_split(state)) == 0)
-        {
-          we_read_silence_from_logs = SPLT_TRUE;
-          float threshold = SPLT_DEFAULT_PARAM_THRESHOLD;
-          float min = SPLT_DEFAULT_PARAM_MINIMUM_LENGTH;
-          int i = fscanf(log_file, "%f\t%f", &threshold, &min);
-
-          if ((i < 2) || (threshold != splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD))
-              || (splt_t_get_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH) != min))
-          {
-            we_read_silence_from_logs = SPLT_FALSE;
-          }
-          else
-          {
-            splt_t_set_float_option(state, SPLT_OPT_PARAM_THRESHOLD, threshold);
-            splt_t_set_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH, min);
-          }
-        }
-      }
-      if (!we_read_silence_from_logs && log_file)
-      {
-        fclose(log_file);
-        log_file = NULL;
-      }
-    }
+    we_read_silence_from_logs = splt_en_read_cache(state, log_fname, error);
+    if (*error < 0) { return -1; }
   }
 
   //put silence split infos
@@ -676,12 +897,9 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
     snprintf(message, 1024, _(" Found silence log file '%s' ! Reading"
           " silence points from file to save time ;)"), log_fname);
     splt_t_put_info_message_to_client(state, message);
-    found = splt_u_parse_ssplit_file(state, log_file, error);
-    if (log_file)
-    {
-      fclose(log_file);
-      log_file = NULL;
-    }
+    found = splt_en_detect_silence(state,
+        splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD),
+        splt_t_get_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH), error);
   }
   else
   {
@@ -690,7 +908,44 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
       //TODO
       state->split.get_silence_level(0, INT_MAX, state->split.silence_level_client_data);
     }
+    //record the envelope for the silence log file or the auto threshold
+    if (splt_t_get_int_option(state, SPLT_OPT_ENABLE_SILENCE_LOG) ||
+        splt_t_get_int_option(state, SPLT_OPT_AUTO_THRESHOLD))
+    {
+      splt_en_start_recording(state);
+    }
     found = splt_p_scan_silence(state, error);
+    state->envelope.recording = SPLT_FALSE;
+  }
+
+  //choose the threshold from the envelope and detect the silences again
+  if ((*error >= 0) && !splt_t_split_is_canceled(state) &&
+      splt_t_get_int_option(state, SPLT_OPT_AUTO_THRESHOLD))
+  {
+    float min_length = splt_t_get_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH);
+    float threshold = splt_en_auto_threshold(state, min_length,
+        number_tracks, error);
+    if (*error < 0) { found = 0; goto function_end; }
+
+    splt_t_set_float_option(state, SPLT_OPT_PARAM_THRESHOLD, threshold);
+    snprintf(message, 1024, _(" Auto threshold: %.1f dB\n"), threshold);
+    splt_t_put_info_message_to_client(state, message);
+
+    splt_t_ssplit_free(&state->silence_list);
+
+    //the fast scan only rechecks at full quality the blocks around the
+    //threshold it was given: scan again around the chosen threshold
+    if (state->envelope.rechecked &&
+        (state->envelope.scan_threshold != threshold))
+    {
+      splt_en_start_recording(state);
+      found = splt_p_scan_silence(state, error);
+      state->envelope.recording = SPLT_FALSE;
+    }
+    else
+    {
+      found = splt_en_detect_silence(state, threshold, min_length, error);
+    }
   }
 
   //if no error
@@ -721,15 +976,15 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
     if (!splt_t_split_is_canceled(state))
     {
       found++;
-      if ((number_tracks > 0) &&
-          (number_tracks < SPLT_MAXSILENCE))
+      if ((number_tracks > 0) && (number_tracks < found))
       {
-        if (number_tracks < found)
-        {
-          found = number_tracks;
-        }
+        found = number_tracks;
       }
 
+      //keep the longest silences if we want less tracks
+      selected = splt_t_ssplit_select_longest(&state->silence_list, found - 1, error);
+      if (*error < 0) { found = 0; goto function_end; }
+
       //put first splitpoint
       append_error = splt_t_append_splitpoint(state, 0, NULL, SPLT_SPLITPOINT);
       if (append_error != SPLT_OK)
@@ -738,36 +993,38 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
       }
       else
       {
-        temp = state->silence_list;
         int i;
 
         //we take all splitpoints found and we remove silence 
         //if needed
         for (i = 1; i < found; i++)
         {
-          if (temp == NULL)
+          if (i > state->silence_list.number)
           {
             found = i;
             break;
           }
 
+          int silence = selected[i-1];
           if (splt_t_get_int_option(state, SPLT_OPT_PARAM_REMOVE_SILENCE))
           {
             append_error = splt_t_append_splitpoint(state, 0, NULL, SPLT_SKIPPOINT);
             if (append_error < 0) { *error = append_error; found = i; break;}
             append_error = splt_t_append_splitpoint(state, 0, NULL, SPLT_SPLITPOINT);
             if (append_error < 0) { *error = append_error; found = i; break;}
-            splt_t_set_splitpoint_value(state, 2*i-1,splt_u_time_to_long(temp->begin_position));
-            splt_t_set_splitpoint_value(state, 2*i, splt_u_time_to_long(temp->end_position));
+            splt_t_set_splitpoint_value(state, 2*i-1,
+                splt_u_time_to_long(state->silence_list.begin_position[silence]));
+            splt_t_set_splitpoint_value(state, 2*i,
+                splt_u_time_to_long(state->silence_list.end_position[silence]));
           }
           else
           {
             //TODO
-            long temp_silence_pos = splt_u_silence_position(temp, offset) * 100;
+            long temp_silence_pos =
+              splt_u_silence_position(&state->silence_list, silence, offset) * 100;
             append_error = splt_t_append_splitpoint(state, temp_silence_pos, NULL, SPLT_SPLITPOINT);
             if (append_error != SPLT_OK) { *error = append_error; found = i; break; }
           }
-          temp = temp->next;
         }
 
         //we order the splitpoints
@@ -781,7 +1038,8 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
         }
 
         splt_u_print_debug(state,"We order splitpoints...",0,NULL);
-        splt_u_order_splitpoints(state, splitpoints_appended);
+        int order_error = splt_u_order_splitpoints(state, splitpoints_appended);
+        if (order_error < 0) { *error = order_error; }
 
         //last splitpoint, end of file
         append_error =
@@ -795,71 +1053,126 @@ int splt_s_set_silence_splitpoints(splt_state *state, int *error)
       *error = SPLT_SPLIT_CANCELLED;
     }
 
-    //if splitpoints are found
-    if ((found > 0) && !we_read_silence_from_logs)
+    //if we write the silence log file
+    if (!we_read_silence_from_logs && (*error >= 0) &&
+        !splt_t_split_is_canceled(state) &&
+        splt_t_get_int_option(state, SPLT_OPT_ENABLE_SILENCE_LOG))
     {
-      //if we write the silence points log file
-      if (splt_t_get_int_option(state, SPLT_OPT_ENABLE_SILENCE_LOG))
+      char *fname = splt_t_get_silence_log_fname(state);
+      snprintf(message, 1024, _(" Writing silence log file '%s' ...\n"), fname);
+      splt_t_put_info_message_to_client(state, message);
+      if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
       {
-        char *message = malloc(sizeof(char) * 1024);
-        if (message)
-        {
-          snprintf(message, 1023, _(" Writing silence log file '%s' ...\n"),
-              splt_t_get_silence_log_fname(state));
-          splt_t_put_info_message_to_client(state, message);
-          if (message)
-          {
-            free(message);
-            message = NULL;
-          }
-          char *fname = splt_t_get_silence_log_fname(state);
-          if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
-          {
-            FILE *log_file = NULL;
-            if (!(log_file = splt_u_fopen(fname, "w")))
-            {
-              splt_t_set_strerror_msg(state);
-              splt_t_set_error_data(state, fname);
-              *error = SPLT_ERROR_CANNOT_OPEN_FILE;
-            }
-            else
-            {
-              //do the effective write
-              struct splt_ssplit *temp = state->silence_list;
-              fprintf(log_file, "%s\n", splt_t_get_filename_to_split(state));
-              fprintf(log_file, "%.2f\t%.2f\n", 
-                  splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD),
-                  splt_t_get_float_option(state, SPLT_OPT_PARAM_MIN_LENGTH));
-              while (temp != NULL)
-              {
-                fprintf(log_file, "%f\t%f\t%ld\n",
-                    temp->begin_position, temp->end_position, temp->len);
-                temp = temp->next;
-              }
-              fflush(log_file);
-              if (log_file)
-              {
-                fclose(log_file);
-                log_file = NULL;
-              }
-              temp = NULL;
-            }
-          }
-        }
-        else
-        {
-          *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-        }
+        splt_en_write_cache(state, fname, error);
       }
     }
   }
+
+function_end:
+  if (selected)
+  {
+    free(selected);
+    selected = NULL;
+  }
   splt_t_ssplit_free(&state->silence_list);
+  splt_en_free(state);
 
   splt_t_set_splitnumber(state, splitpoints_appended + 1);
 
   return found;
 }
 
+//starts a track of the streaming silence split at 'begin' (hundreths of
+//seconds); the plugin calls it each time a cut is final
+//returns the provisional output filename of the track, to be freed
+char *splt_s_stream_track_begin(splt_state *state, long begin, int *error)
+{
+  int err = SPLT_OK;
+  int get_error = SPLT_OK;
+  int number = state->split.real_splitnumber;
+
+  if (number == 0)
+  {
+    err = splt_t_append_splitpoint(state, begin, NULL, SPLT_SPLITPOINT);
+    if (err < 0) { *error = err; return NULL; }
+  }
+  else if (splt_t_get_splitpoint_value(state, number - 1, &get_error) != begin)
+  {
+    //the removed silence is skipped
+    splt_t_set_splitpoint_type(state, number - 1, SPLT_SKIPPOINT);
+    err = splt_t_append_splitpoint(state, begin, NULL, SPLT_SPLITPOINT);
+    if (err < 0) { *error = err; return NULL; }
+  }
+
+  //the end of the track is set when the track ends
+  err = splt_t_append_splitpoint(state, begin, NULL, SPLT_SPLITPOINT);
+  if (err < 0) { *error = err; return NULL; }
+  splt_t_set_splitnumber(state, state->split.real_splitnumber);
+
+  int current_split = state->split.real_splitnumber - 2;
+  splt_t_set_current_split(state, current_split);
+  splt_tu_auto_increment_tracknumber(state);
+
+  err = splt_u_finish_tags_and_put_output_format_filename(state, current_split);
+  if (err < 0) { *error = err; return NULL; }
+
+  return splt_u_get_fname_with_path_and_extension(state, error);
+}
+
+//ends the current track of the streaming silence split at 'end'
+//returns the final output filename of the track, to be freed
+char *splt_s_stream_track_end(splt_state *state, long end, int *error)
+{
+  int current_split = state->split.real_splitnumber - 2;
+  splt_t_set_splitpoint_value(state, current_split + 1, end);
+
+  int err = splt_u_finish_tags_and_put_output_format_filename(state, current_split);
+  if (err < 0) { *error = err; return NULL; }
+
+  return splt_u_get_fname_with_path_and_extension(state, error);
+}
+
+//silence split of a non seekable input: the input is read only once and
+//the tracks are written by the plugin as the silences are found
+static void splt_s_stream_silence_split(splt_state *state, int *error)
+{
+  splt_u_print_debug(state,"Starting streaming silence split ...",0,NULL);
+
+  //the longest silences can't be chosen without reading all the input
+  if (splt_t_get_int_option(state, SPLT_OPT_PARAM_NUMBER_TRACKS) > 0)
+  {
+    *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+    return;
+  }
+
+  int output_filenames = splt_t_get_int_option(state,SPLT_OPT_OUTPUT_FILENAMES);
+  if (output_filenames == SPLT_OUTPUT_DEFAULT)
+  {
+    splt_t_set_oformat(state, SPLT_DEFAULT_SILENCE_OUTPUT, error, SPLT_TRUE);
+    if (*error < 0) { return; }
+  }
+
+  //we don't know the number of tracks of a stream
+  splt_t_set_oformat_digits_tracks(state, SPLT_STREAM_TRACKS_DIGITS);
+
+  int tracks = splt_p_stream_silence_split(state, error);
+  if (*error < 0) { return; }
+
+  char client_infos[512] = { '\0' };
+  snprintf(client_infos, 512, _("\n Total silence points found: %d.\n"),
+      tracks > 0 ? tracks - 1 : 0);
+  splt_t_put_info_message_to_client(state, client_infos);
+
+  if (tracks <= 1)
+  {
+    *error = SPLT_NO_SILENCE_SPLITPOINTS_FOUND;
+  }
+  else
+  {
+    *error = SPLT_SILENCE_OK;
+  }
+}
+
 //do the silence split
 //possible error in error
 void splt_s_silence_split(splt_state *state, int *error)
@@ -869,6 +1182,23 @@ void splt_s_silence_split(splt_state *state, int *error)
   //print some useful infos to the client
   splt_t_put_info_message_to_client(state, _(" info: starting silence mode split\n"));
 
+  if (splt_t_get_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE))
+  {
+    if (splt_p_can_stream_silence_split(state))
+    {
+      splt_s_stream_silence_split(state, error);
+      return;
+    }
+
+    //files can still be read twice by the plugins that can't stream
+    if (splt_t_is_stdin(state))
+    {
+      *error = SPLT_PLUGIN_ERROR_UNSUPPORTED_FEATURE;
+      return;
+    }
+    splt_t_set_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_FALSE);
+  }
+
   int found = 0;
   found = splt_s_set_silence_splitpoints(state, error);
 
@@ -930,3 +1260,226 @@ void splt_s_wrap_split(splt_state *state, int *error)
   splt_p_dewrap(state, SPLT_FALSE, new_filename_path, error);
 }
 
+/****************************/
+/* splt split file */
+
+//splits the file; the library must be locked by the caller
+void splt_s_split_file(splt_state *state, int *error)
+{
+
+  splt_u_print_debug(state,"Starting to split file...",0,NULL);
+
+  char *new_filename_path = NULL;
+  char *fname_to_split = splt_t_get_filename_to_split(state);
+
+  splt_u_print_debug(state,"Original filename/path to split is ",0, fname_to_split);
+
+  if (splt_t_is_stdin(state))
+  {
+    splt_t_set_int_option(state, SPLT_OPT_INPUT_NOT_SEEKABLE, SPLT_TRUE);
+  }
+
+  //we set default internal options
+  splt_t_set_default_iopts(state);
+  splt_st_reset(state);
+
+  //we put the real splitnumber in the splitnumber variable
+  //that could be changed (see splitnumber in mp3splt.h)
+  state->split.splitnumber = state->split.real_splitnumber;
+  splt_t_set_current_split(state,0);
+
+  if (!splt_io_check_if_file(state, fname_to_split))
+  {
+    *error = SPLT_ERROR_INEXISTENT_FILE;
+    return;
+  }
+
+#ifndef __WIN32__
+  char *linked_fname = splt_io_get_linked_fname(fname_to_split);
+  if (linked_fname)
+  {
+    char infos[2048] = { '\0' };
+    snprintf(infos, 2048, _(" info: resolving linked filename to '%s'\n"), linked_fname);
+    splt_t_put_info_message_to_client(state, infos);
+
+    splt_t_set_filename_to_split(state, linked_fname);
+    fname_to_split = splt_t_get_filename_to_split(state);
+
+    free(linked_fname);
+    linked_fname = NULL;
+  }
+#endif
+
+  //if the new_filename_path is "", we put the directory of
+  //the current song
+  new_filename_path = splt_check_put_dir_of_cur_song(fname_to_split,
+      splt_t_get_path_of_split(state), error);
+  if (*error < 0)
+  {
+    return;
+  }
+
+  //checks and sets correct options
+  splt_check_set_correct_options(state);
+
+  //if we have compatible options
+  //this function is optional,
+  if (! splt_check_compatible_options(state))
+  {
+    *error = SPLT_ERROR_INCOMPATIBLE_OPTIONS;
+    goto function_end;
+  }
+
+  int split_type = splt_t_get_int_option(state, SPLT_OPT_SPLIT_MODE);
+
+  //normal split checks
+  if (split_type == SPLT_OPTION_NORMAL_MODE)
+  {
+    if (! splt_t_get_int_option(state, SPLT_OPT_PRETEND_TO_SPLIT))
+    {
+      //check if we have at least 2 splitpoints
+      if (splt_t_get_splitnumber(state) < 2)
+      {
+        *error = SPLT_ERROR_SPLITPOINTS;
+        goto function_end;
+      }
+    }
+
+    //we check if the splitpoints are in order
+    splt_check_if_splitpoints_in_order(state, error);
+    if (*error < 0) { goto function_end; }
+  }
+
+  splt_t_set_new_filename_path(state, new_filename_path, error);
+  if (*error < 0) { goto function_end; }
+
+  *error = splt_u_create_directories(state, new_filename_path);
+  if (*error < 0) { goto function_end; }
+
+  splt_check_if_new_filename_path_correct(state, new_filename_path, error);
+  if (*error < 0) { goto function_end; }
+
+  if (splt_t_get_int_option(state, SPLT_OPT_TAGS) == SPLT_TAGS_ORIGINAL_FILE)
+  {
+    splt_u_put_tags_from_string(state, SPLT_ORIGINAL_TAGS_DEFAULT, error);
+    if (*error < 0)
+    {
+      splt_p_end(state, error);
+      goto function_end;
+    }
+  }
+
+  //we check if mp3 or ogg
+  splt_check_file_type(state, error);
+  if (*error < 0) { goto function_end; }
+
+  const char *plugin_name = splt_p_get_name(state,error);
+  if (*error < 0) { goto function_end; }
+  char infos[2048] = { '\0' };
+  snprintf(infos,2048,_(" info: file matches the plugin '%s'\n"), plugin_name);
+  splt_t_put_info_message_to_client(state, infos);
+
+  //print the new m3u fname
+  char *m3u_fname_with_path = splt_t_get_m3u_file_with_path(state, error);
+  if (*error < 0) { goto function_end; }
+  if (m3u_fname_with_path)
+  {
+    int malloc_size = strlen(m3u_fname_with_path) + 200;
+    char *mess = splt_u_malloc(sizeof(char) * (strlen(m3u_fname_with_path) + 200));
+    if (!mess) { *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY; goto function_end; }
+    snprintf(mess, malloc_size, _(" M3U file '%s' will be created.\n"),
+        m3u_fname_with_path);
+    splt_t_put_info_message_to_client(state, mess);
+    free(mess);
+    mess = NULL;
+    free(m3u_fname_with_path);
+    m3u_fname_with_path = NULL;
+  }
+
+  //open the manifest, if we describe the split files instead of creating them
+  splt_mf_open(state, error);
+  if (*error < 0) { goto function_end; }
+
+  //init the plugin for split
+  splt_p_init(state, error);
+  if (*error < 0) { goto function_end; }
+
+  splt_u_print_debug(state,"parse type of split...",0,NULL);
+
+  char message[1024] = { '\0' };
+  //print Working with auto adjust if necessary
+  if (splt_t_get_int_option(state, SPLT_OPT_AUTO_ADJUST)
+      && !  splt_t_get_int_option(state, SPLT_OPT_QUIET_MODE))
+  {
+    if ((split_type != SPLT_OPTION_WRAP_MODE)
+        && (split_type != SPLT_OPTION_SILENCE_MODE)
+        && (split_type != SPLT_OPTION_ERROR_MODE))
+    {
+      snprintf(message, 1024, _(" Working with SILENCE AUTO-ADJUST (Threshold:"
+            " %.1f dB Gap: %d sec Offset: %.2f)\n"),
+          splt_t_get_float_option(state, SPLT_OPT_PARAM_THRESHOLD),
+          splt_t_get_int_option(state, SPLT_OPT_PARAM_GAP),
+          splt_t_get_float_option(state, SPLT_OPT_PARAM_OFFSET));
+
+      splt_t_put_info_message_to_client(state, message);
+    }
+  }
+
+  //the type of the split
+  switch (split_type)
+  {
+    case SPLT_OPTION_WRAP_MODE:
+      splt_s_wrap_split(state, error);
+      break;
+    case SPLT_OPTION_SILENCE_MODE:
+      splt_s_silence_split(state, error);
+      break; 
+    case SPLT_OPTION_TIME_MODE:
+      splt_s_time_split(state, error);
+      break;
+    case SPLT_OPTION_LENGTH_MODE:
+      splt_s_equal_length_split(state, error);
+      break;
+    case SPLT_OPTION_ERROR_MODE:
+      splt_s_error_split(state, error);
+      break;
+    default:
+      //this is the normal split
+      if (split_type == SPLT_OPTION_NORMAL_MODE)
+      {
+        //if we don't have STDIN
+        if (! splt_t_is_stdin(state))
+        {
+          //total time of the song
+          splt_check_splitpts_inf_song_length(state, error);
+          if (*error < 0) { goto function_end; }
+        }
+      }
+
+      splt_s_normal_split(state, error);
+      break;
+  }
+
+  //ends the 'init' of the plugin for the split
+  splt_p_end(state, error);
+
+function_end:
+  if (*error >= 0)
+  {
+    splt_mf_close(state, error);
+  }
+  else
+  {
+    int err = SPLT_OK;
+    splt_mf_close(state, &err);
+  }
+
+  splt_st_update(state);
+  splt_st_print_debug(state);
+
+  if (new_filename_path)
+  {
+    free(new_filename_path);
+    new_filename_path = NULL;
+  }
+}
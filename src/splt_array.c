@@ -38,7 +38,7 @@
 
 splt_array *splt_array_new()
 {
-  splt_array *array = malloc(sizeof(splt_array));
+  splt_array *array = splt_u_malloc(sizeof(splt_array));
   if (array == NULL)
   {
     return NULL;
@@ -59,7 +59,7 @@ int splt_array_append(splt_array *array, void *element)
 
   if (array->number_of_elements == 0)
   {
-    array->elements = malloc(sizeof(element));
+    array->elements = splt_u_malloc(sizeof(element));
     if (!array->elements)
     {
       return -1;
@@ -70,7 +70,7 @@ int splt_array_append(splt_array *array, void *element)
   else
   {
     size_t malloc_number = sizeof(element) * (array->number_of_elements + 1);
-    void **new_elements = realloc(array->elements, malloc_number);
+    void **new_elements = splt_u_realloc(array->elements, malloc_number);
     if (! new_elements)
     {
       return -1;
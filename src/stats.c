@@ -0,0 +1,201 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "splt.h"
+
+static const char *splt_st_phase_names[SPLT_NUMBER_OF_PHASES] =
+{
+  "plugin probe",
+  "info",
+  "silence scan",
+  "cutpoint search",
+  "write",
+  "tags",
+};
+
+//returns a time in seconds that only grows, used to measure durations
+double splt_st_wall_time()
+{
+#if defined(CLOCK_MONOTONIC) && !defined(__WIN32__)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+  {
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+  }
+#endif
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+//returns the processor time of the calling thread only: the worker
+//threads and the other splits of the process are not counted
+static double splt_st_cpu_time()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID) && !defined(__WIN32__)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+  {
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+  }
+#endif
+
+  return clock() / (double) CLOCKS_PER_SEC;
+}
+
+//resets all the counters, called at the beginning of a split
+void splt_st_reset(splt_state *state)
+{
+  memset(&state->stats, 0, sizeof(splt_stats));
+  state->iopts.current_phase = -1;
+  state->iopts.allocations_start = splt_u_get_allocations();
+  state->iopts.worker_allocations = 0;
+}
+
+//counts the allocations of the split thread and of the worker threads
+static void splt_st_count_allocations(splt_state *state)
+{
+  state->stats.allocations =
+    splt_u_get_allocations() - state->iopts.allocations_start +
+    state->iopts.worker_allocations;
+}
+
+//adds the time spent since the last phase change to the current phase
+static void splt_st_account_time(splt_state *state)
+{
+  double wall_now = splt_st_wall_time();
+  double cpu_now = splt_st_cpu_time();
+
+  int phase = state->iopts.current_phase;
+  if (phase >= 0 && phase < SPLT_NUMBER_OF_PHASES)
+  {
+    state->stats.wall_time[phase] += wall_now - state->iopts.phase_wall_start;
+    state->stats.cpu_time[phase] += cpu_now - state->iopts.phase_cpu_start;
+  }
+
+  state->iopts.phase_wall_start = wall_now;
+  state->iopts.phase_cpu_start = cpu_now;
+
+  splt_st_count_allocations(state);
+}
+
+//brings the counters up to date, before they are read
+void splt_st_update(splt_state *state)
+{
+  splt_st_account_time(state);
+}
+
+//starts measuring 'phase'; the time of the enclosing phase is suspended
+//-returns the enclosing phase, to be given to splt_st_leave_phase
+int splt_st_enter_phase(splt_state *state, int phase)
+{
+  int previous_phase = state->iopts.current_phase;
+  splt_st_account_time(state);
+  state->iopts.current_phase = phase;
+  //progress calls come at a different rate in each phase
+  splt_t_reset_progress_rate(state);
+  return previous_phase;
+}
+
+//stops measuring the current phase and resumes 'previous_phase'
+void splt_st_leave_phase(splt_state *state, int previous_phase)
+{
+  splt_st_account_time(state);
+  state->iopts.current_phase = previous_phase;
+  splt_t_reset_progress_rate(state);
+}
+
+//gets the resources used by the calling thread since it started
+void splt_st_get_thread_usage(splt_thread_usage *usage)
+{
+  usage->cpu_time = splt_st_cpu_time();
+  usage->allocations = splt_u_get_allocations();
+}
+
+//adds 'usage' to 'sum'
+void splt_st_sum_thread_usage(splt_thread_usage *sum,
+    const splt_thread_usage *usage)
+{
+  sum->cpu_time += usage->cpu_time;
+  sum->allocations += usage->allocations;
+}
+
+//adds the resources used by a worker thread to 'phase'; if 'collected'
+//is not NULL, only the resources used since the last call are added
+void splt_st_add_thread_usage(splt_state *state, int phase,
+    const splt_thread_usage *usage, splt_thread_usage *collected)
+{
+  double cpu_time = usage->cpu_time;
+  unsigned long allocations = usage->allocations;
+  if (collected != NULL)
+  {
+    cpu_time -= collected->cpu_time;
+    allocations -= collected->allocations;
+    *collected = *usage;
+  }
+
+  if (phase >= 0 && phase < SPLT_NUMBER_OF_PHASES)
+  {
+    state->stats.cpu_time[phase] += cpu_time;
+  }
+  state->iopts.worker_allocations += allocations;
+  splt_st_count_allocations(state);
+}
+
+//prints the counters on the debug output
+void splt_st_print_debug(splt_state *state)
+{
+  splt_stats *stats = &state->stats;
+  char message[256] = { '\0' };
+
+  int i = 0;
+  for (i = 0;i < SPLT_NUMBER_OF_PHASES;i++)
+  {
+    snprintf(message, sizeof(message), "Stats: %s wall %.3fs cpu %.3fs",
+        splt_st_phase_names[i], stats->wall_time[i], stats->cpu_time[i]);
+    splt_u_print_debug(state, message, 0, NULL);
+  }
+
+  snprintf(message, sizeof(message),
+      "Stats: read %lld written %lld frames %lu decoded %lu"
+      " syncerrors %lu seeks %lu rechecked %lu allocations %lu",
+      (long long) stats->bytes_read, (long long) stats->bytes_written,
+      stats->frames_parsed, stats->frames_decoded, stats->sync_errors,
+      stats->seeks, stats->frames_rechecked, stats->allocations);
+  splt_u_print_debug(state, message, 0, NULL);
+}
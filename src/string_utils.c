@@ -94,7 +94,7 @@ char *splt_su_safe_strdup(const char *input, int *error)
     return NULL;
   }
 
-  char *dup_input = strdup(input);
+  char *dup_input = splt_u_strdup(input);
   if (dup_input != NULL)
   {
     return dup_input;
@@ -121,7 +121,7 @@ int splt_su_append(char **str, size_t *allocated_size,
 
   if (*str == NULL || *allocated_size == 0)
   {
-    *str = malloc(to_append_size + 1);
+    *str = splt_u_malloc(to_append_size + 1);
     if (*str == NULL)
     {
       return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -132,7 +132,7 @@ int splt_su_append(char **str, size_t *allocated_size,
   }
   else
   {
-    *str = realloc(*str, to_append_size + *allocated_size);
+    *str = splt_u_realloc(*str, to_append_size + *allocated_size);
     if (*str == NULL)
     {
       return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -185,7 +185,7 @@ int splt_su_copy(const char *src, char **dest)
   else
   {
     int length = strlen(src)+1;
-    if ((*dest = malloc(sizeof(char)*length)) == NULL)
+    if ((*dest = splt_u_malloc(sizeof(char)*length)) == NULL)
     {
       err = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
     }
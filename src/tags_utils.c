@@ -306,7 +306,7 @@ int splt_tu_new_tags_if_necessary(splt_state *state, int index)
     }
     else
     {
-      if ((state->split.tags = malloc(sizeof(splt_tags))) == NULL)
+      if ((state->split.tags = splt_u_malloc(sizeof(splt_tags))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
         return error;
@@ -328,7 +328,7 @@ int splt_tu_new_tags_if_necessary(splt_state *state, int index)
     {
       if (index == state->split.real_tagsnumber)
       {
-        if ((state->split.tags = realloc(state->split.tags,
+        if ((state->split.tags = splt_u_realloc(state->split.tags,
                 sizeof(splt_tags) * (index+1))) == NULL)
         {
           error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -390,7 +390,7 @@ int splt_tu_set_tags_char_field(splt_state *state, int index,
         }
         else
         {
-          if ((state->split.tags[index].title = malloc((strlen(data)+1) * 
+          if ((state->split.tags[index].title = splt_u_malloc((strlen(data)+1) * 
                   sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -414,7 +414,7 @@ int splt_tu_set_tags_char_field(splt_state *state, int index,
         }
         else
         {
-          if ((state->split.tags[index].artist = malloc((strlen(data)+1) * 
+          if ((state->split.tags[index].artist = splt_u_malloc((strlen(data)+1) * 
                   sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -438,7 +438,7 @@ int splt_tu_set_tags_char_field(splt_state *state, int index,
         }
         else
         {
-          if ((state->split.tags[index].album = malloc((strlen(data)+1) * 
+          if ((state->split.tags[index].album = splt_u_malloc((strlen(data)+1) * 
                   sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -462,7 +462,7 @@ int splt_tu_set_tags_char_field(splt_state *state, int index,
         }
         else
         {
-          if ((state->split.tags[index].year = malloc((strlen(data)+1) * 
+          if ((state->split.tags[index].year = splt_u_malloc((strlen(data)+1) * 
                   sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -485,7 +485,7 @@ int splt_tu_set_tags_char_field(splt_state *state, int index,
         }
         else
         {
-          if ((state->split.tags[index].comment = malloc((strlen(data)+1) * 
+          if ((state->split.tags[index].comment = splt_u_malloc((strlen(data)+1) * 
                   sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -509,7 +509,7 @@ int splt_tu_set_tags_char_field(splt_state *state, int index,
         }
         else
         {
-          if ((state->split.tags[index].performer = malloc((strlen(data)+1) * 
+          if ((state->split.tags[index].performer = splt_u_malloc((strlen(data)+1) * 
                   sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
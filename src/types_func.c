@@ -95,7 +95,7 @@ int splt_t_is_stdout(splt_state *state)
 //-error is the possible error and  NULL is returned
 splt_state *splt_t_new_state(splt_state *state, int *error)
 {
-  if ((state =malloc(sizeof(splt_state))) ==NULL)
+  if ((state =splt_u_malloc(sizeof(splt_state))) ==NULL)
   {
     *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
     return NULL;
@@ -103,14 +103,14 @@ splt_state *splt_t_new_state(splt_state *state, int *error)
   else
   {
     memset(state, 0x0, sizeof(splt_state));
-    if ((state->wrap = malloc(sizeof(splt_wrap))) == NULL)
+    if ((state->wrap = splt_u_malloc(sizeof(splt_wrap))) == NULL)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
       free(state);
       return NULL;
     }
     memset(state->wrap,0x0,sizeof(state->wrap));
-    if ((state->serrors = malloc(sizeof(splt_syncerrors))) == NULL)
+    if ((state->serrors = splt_u_malloc(sizeof(splt_syncerrors))) == NULL)
     {
       free(state->wrap);
       free(state);
@@ -118,7 +118,7 @@ splt_state *splt_t_new_state(splt_state *state, int *error)
       return NULL;
     }
     memset(state->serrors,0x0,sizeof(state->serrors));
-    if ((state->split.p_bar = malloc(sizeof(splt_progress))) == NULL)
+    if ((state->split.p_bar = splt_u_malloc(sizeof(splt_progress))) == NULL)
     {
       free(state->wrap);
       free(state->serrors);
@@ -126,7 +126,7 @@ splt_state *splt_t_new_state(splt_state *state, int *error)
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
       return NULL;
     }
-    if ((state->plug = malloc(sizeof(splt_plugins))) == NULL)
+    if ((state->plug = splt_u_malloc(sizeof(splt_plugins))) == NULL)
     {
       free(state->wrap);
       free(state->serrors);
@@ -173,6 +173,16 @@ static void splt_t_free_state_struct(splt_state *state)
       free(state->m3u_filename);
       state->m3u_filename = NULL;
     }
+    if (state->manifest_filename)
+    {
+      free(state->manifest_filename);
+      state->manifest_filename = NULL;
+    }
+    if (state->journal_filename)
+    {
+      free(state->journal_filename);
+      state->journal_filename = NULL;
+    }
     if (state->silence_log_fname)
     {
       free(state->silence_log_fname);
@@ -216,7 +226,7 @@ int splt_t_alloc_init_new_plugin(splt_plugins *pl)
   //allocate memory for the plugin data
   if (pl->data == NULL)
   {
-    pl->data = malloc(sizeof(splt_plugin_data) * (pl->number_of_plugins_found+1));
+    pl->data = splt_u_malloc(sizeof(splt_plugin_data) * (pl->number_of_plugins_found+1));
     if (pl->data == NULL)
     {
       return_value = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -225,7 +235,7 @@ int splt_t_alloc_init_new_plugin(splt_plugins *pl)
   }
   else
   {
-    pl->data = realloc(pl->data,sizeof(splt_plugin_data) *
+    pl->data = splt_u_realloc(pl->data,sizeof(splt_plugin_data) *
         (pl->number_of_plugins_found+1));
     if (pl->data == NULL)
     {
@@ -322,6 +332,8 @@ void splt_t_free_state(splt_state *state)
 {
   if (state)
   {
+    splt_wb_free(state);
+    splt_io_free(state);
     splt_tu_free_original_tags(state);
     splt_t_free_oformat(state);
     splt_t_wrap_free(state);
@@ -402,7 +414,7 @@ void splt_t_set_new_filename_path(splt_state *state,
   }
   else
   {
-    state->iopts.new_filename_path = strdup(new_filename_path);
+    state->iopts.new_filename_path = splt_u_strdup(new_filename_path);
     if (state->iopts.new_filename_path == NULL)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -433,7 +445,7 @@ int splt_t_set_path_of_split(splt_state *state, const char *path)
 
   if (path != NULL)
   {
-    if((state->path_of_split = malloc(sizeof(char)*(strlen(path)+1))) != NULL)
+    if((state->path_of_split = splt_u_malloc(sizeof(char)*(strlen(path)+1))) != NULL)
     {
       snprintf(state->path_of_split,(strlen(path)+1), "%s", path);
     }
@@ -467,7 +479,7 @@ int splt_t_set_m3u_filename(splt_state *state, const char *filename)
 
   if (filename != NULL)
   {
-    if((state->m3u_filename = malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
+    if((state->m3u_filename = splt_u_malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
     {
       snprintf(state->m3u_filename,(strlen(filename)+1), 
           "%s", filename);
@@ -485,6 +497,76 @@ int splt_t_set_m3u_filename(splt_state *state, const char *filename)
   return error;
 }
 
+//sets the manifest filename
+//returns possible error
+int splt_t_set_manifest_filename(splt_state *state, const char *filename)
+{
+  int error = SPLT_OK;
+
+  //free previous memory
+  if (splt_t_get_manifest_filename(state))
+  {
+    free(state->manifest_filename);
+    state->manifest_filename = NULL;
+  }
+
+  splt_u_print_debug(state,"Setting manifest filename...",0,filename);
+
+  if (filename != NULL)
+  {
+    if((state->manifest_filename = splt_u_malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
+    {
+      snprintf(state->manifest_filename,(strlen(filename)+1), 
+          "%s", filename);
+    }
+    else
+    {
+      error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    }
+  }
+  else
+  {
+    state->manifest_filename = NULL;
+  }
+
+  return error;
+}
+
+//sets the journal filename
+//returns possible error
+int splt_t_set_journal_filename(splt_state *state, const char *filename)
+{
+  int error = SPLT_OK;
+
+  //free previous memory
+  if (splt_t_get_journal_filename(state))
+  {
+    free(state->journal_filename);
+    state->journal_filename = NULL;
+  }
+
+  splt_u_print_debug(state,"Setting journal filename...",0,filename);
+
+  if (filename != NULL)
+  {
+    if((state->journal_filename = splt_u_malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
+    {
+      snprintf(state->journal_filename,(strlen(filename)+1), 
+          "%s", filename);
+    }
+    else
+    {
+      error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    }
+  }
+  else
+  {
+    state->journal_filename = NULL;
+  }
+
+  return error;
+}
+
 //sets the m3u filename
 //returns possible error
 int splt_t_set_silence_log_fname(splt_state *state, const char *filename)
@@ -502,7 +584,7 @@ int splt_t_set_silence_log_fname(splt_state *state, const char *filename)
 
   if (filename != NULL)
   {
-    if((state->silence_log_fname = malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
+    if((state->silence_log_fname = splt_u_malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
     {
       snprintf(state->silence_log_fname,(strlen(filename)+1), "%s", filename);
     }
@@ -536,7 +618,7 @@ int splt_t_set_filename_to_split(splt_state *state, const char *filename)
 
   if (filename != NULL)
   {
-    if ((state->fname_to_split = malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
+    if ((state->fname_to_split = splt_u_malloc(sizeof(char)*(strlen(filename)+1))) != NULL)
     {
       snprintf(state->fname_to_split,strlen(filename)+1,"%s", filename);
     }
@@ -571,6 +653,16 @@ char *splt_t_get_m3u_filename(splt_state *state)
   return state->m3u_filename;
 }
 
+char *splt_t_get_manifest_filename(splt_state *state)
+{
+  return state->manifest_filename;
+}
+
+char *splt_t_get_journal_filename(splt_state *state)
+{
+  return state->journal_filename;
+}
+
 //returns path of split
 char *splt_t_get_silence_log_fname(splt_state *state)
 {
@@ -664,7 +756,7 @@ int splt_t_new_oformat(splt_state *state, const char *format_string)
   if (format_string != NULL)
   {
     if ((state->oformat.format_string =
-          malloc(sizeof(char)*(strlen(format_string)+1))) == NULL)
+          splt_u_malloc(sizeof(char)*(strlen(format_string)+1))) == NULL)
     {
       error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
     }
@@ -732,7 +824,7 @@ void splt_t_set_oformat(splt_state *state, const char *format_string,
   err = splt_t_new_oformat(state, format_string);
   if (err < 0) { *error = err; return; }
 
-  char *new_str = strdup(format_string);
+  char *new_str = splt_u_strdup(format_string);
   if (new_str)
   {
     err = splt_u_parse_outformat(new_str, state);
@@ -807,7 +899,7 @@ int splt_t_append_splitpoint(splt_state *state, long split_value, const char *na
     //we allocate memory for this splitpoint
     if (!state->split.points)
     {
-      if ((state->split.points = malloc(sizeof(splt_point))) == NULL)
+      if ((state->split.points = splt_u_malloc(sizeof(splt_point))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
         return error;
@@ -815,7 +907,7 @@ int splt_t_append_splitpoint(splt_state *state, long split_value, const char *na
     }
     else
     {
-      if ((state->split.points = realloc(state->split.points,
+      if ((state->split.points = splt_u_realloc(state->split.points,
               state->split.real_splitnumber * sizeof(splt_point))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -938,7 +1030,7 @@ int splt_t_set_splitpoint_name(splt_state *state, int index, const char *name)
     {
       //allocate memory for this split name
       if((state->split.points[index].name =
-            malloc((strlen(name)+1)*sizeof(char))) == NULL)
+            splt_u_malloc((strlen(name)+1)*sizeof(char))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
         return error;
@@ -1105,7 +1197,7 @@ void splt_t_set_iopt(splt_state *state, int type, int value)
       state->iopts.frame_mode_enabled = value;
       break;
     case SPLT_INTERNAL_PROGRESS_RATE:
-      state->iopts.current_refresh_rate = value;
+      state->iopts.progress_countdown = value;
       break;
     default:
       break;
@@ -1121,7 +1213,7 @@ int splt_t_get_iopt(splt_state *state, int type)
       return state->iopts.frame_mode_enabled;
       break;
     case SPLT_INTERNAL_PROGRESS_RATE:
-      return state->iopts.current_refresh_rate;
+      return state->iopts.progress_countdown;
       break;
     default:
       break;
@@ -1134,7 +1226,8 @@ int splt_t_get_iopt(splt_state *state, int type)
 void splt_t_set_default_iopts(splt_state *state)
 {
   splt_t_set_iopt(state, SPLT_INTERNAL_FRAME_MODE_ENABLED,SPLT_FALSE);
-  splt_t_set_iopt(state, SPLT_INTERNAL_PROGRESS_RATE,0);
+  splt_t_reset_progress_rate(state);
+  state->iopts.progress_time = 0;
   int error = SPLT_OK;
   //cannot fail because second argument is NULL
   splt_t_set_new_filename_path(state,NULL,&error);
@@ -1150,12 +1243,22 @@ static void splt_t_state_put_default_options(splt_state *state, int *error)
   state->fname_to_split = NULL;
   state->path_of_split = NULL;
   state->m3u_filename = NULL;
+  state->manifest_filename = NULL;
+  state->manifest = NULL;
+  state->journal_filename = NULL;
+  state->journal = NULL;
   state->silence_log_fname = NULL;
   state->split.real_tagsnumber = 0;
   state->split.real_splitnumber = 0;
   state->split.splitnumber = 0;
   state->split.current_split_file_number = 1;
   state->split.get_silence_level = NULL;
+  state->split.silence_levels.levels = NULL;
+  state->split.silence_levels.number = 0;
+  state->split.silence_levels.filled = 0;
+  state->split.silence_levels.resolution =
+    SPLT_DEFAULT_SILENCE_LEVELS_RESOLUTION;
+  state->split.silence_levels.current = -1;
   //plugins
   state->plug->plugins_scan_dirs = NULL;
   state->plug->number_of_plugins_found = 0;
@@ -1164,6 +1267,7 @@ static void splt_t_state_put_default_options(splt_state *state, int *error)
   //syncerrors
   state->serrors->serrors_points = NULL;
   state->serrors->serrors_points_num = 0;
+  state->serrors->serrors_points_alloc = 0;
   state->syncerrors = 0;
   //freedb
   state->fdb.search_results = NULL;
@@ -1189,14 +1293,21 @@ static void splt_t_state_put_default_options(splt_state *state, int *error)
   state->split.p_bar->user_data = 0;
   state->split.p_bar->progress = NULL;
   state->cancel_split = SPLT_FALSE;
+  state->async = NULL;
+  state->write_behind = NULL;
+  memset(&state->io, 0x0, sizeof(splt_io_policy));
   //internal
   state->iopts.library_locked = SPLT_FALSE;
   state->iopts.messages_locked = SPLT_FALSE;
-  state->iopts.current_refresh_rate = SPLT_DEFAULT_PROGRESS_RATE;
+  state->iopts.progress_countdown = 0;
+  state->iopts.progress_calls = 0;
+  state->iopts.progress_check_time = 0;
+  state->iopts.progress_time = 0;
   state->iopts.frame_mode_enabled = SPLT_FALSE;
   state->iopts.new_filename_path = NULL;
   state->iopts.split_begin = 0;
   state->iopts.split_end = 0;
+  splt_st_reset(state);
   //options
   state->options.split_mode = SPLT_OPTION_NORMAL_MODE;
   state->options.tags = SPLT_CURRENT_TAGS;
@@ -1223,6 +1334,15 @@ static void splt_t_state_put_default_options(splt_state *state, int *error)
   state->options.remaining_tags_like_x = -1;
   state->options.auto_increment_tracknumber_tags = 0;
   state->options.enable_silence_log = SPLT_FALSE;
+  state->options.auto_threshold = SPLT_FALSE;
+  state->options.fast_scan = SPLT_FALSE;
+  state->options.seek_index = SPLT_FALSE;
+  state->options.read_ahead = SPLT_FALSE;
+  state->options.write_behind = SPLT_FALSE;
+  state->options.sync_output = SPLT_FALSE;
+  state->options.io_advice = SPLT_FALSE;
+  state->options.preallocate_output = SPLT_FALSE;
+  state->options.io_buffer_size = 0;
   state->options.force_tags_version = 0;
   state->options.length_split_file_number = 1;
   state->options.replace_tags_in_tags = SPLT_FALSE;
@@ -1238,7 +1358,7 @@ void splt_t_set_error_data(splt_state *state, const char *error_data)
   }
   if (error_data)
   {
-    state->err.error_data = malloc(sizeof(char) * (strlen(error_data) + 1));
+    state->err.error_data = splt_u_malloc(sizeof(char) * (strlen(error_data) + 1));
     if (state->err.error_data)
     {
       snprintf(state->err.error_data,strlen(error_data)+1,"%s",error_data);
@@ -1291,7 +1411,7 @@ void splt_t_set_strerr_msg(splt_state *state, const char *message)
   //if we have a message
   if (message)
   {
-    state->err.strerror_msg = malloc(sizeof(char) * (strlen(message) + 1));
+    state->err.strerror_msg = splt_u_malloc(sizeof(char) * (strlen(message) + 1));
     if (state->err.strerror_msg)
     {
       snprintf(state->err.strerror_msg,strlen(message)+1,"%s",message);
@@ -1404,6 +1524,33 @@ void splt_t_set_int_option(splt_state *state, int option_name, int value)
     case SPLT_OPT_REPLACE_TAGS_IN_TAGS:
       state->options.replace_tags_in_tags = value;
       break;
+    case SPLT_OPT_AUTO_THRESHOLD:
+      state->options.auto_threshold = value;
+      break;
+    case SPLT_OPT_FAST_SCAN:
+      state->options.fast_scan = value;
+      break;
+    case SPLT_OPT_SEEK_INDEX:
+      state->options.seek_index = value;
+      break;
+    case SPLT_OPT_READ_AHEAD:
+      state->options.read_ahead = value;
+      break;
+    case SPLT_OPT_WRITE_BEHIND:
+      state->options.write_behind = value;
+      break;
+    case SPLT_OPT_SYNC_OUTPUT:
+      state->options.sync_output = value;
+      break;
+    case SPLT_OPT_IO_ADVICE:
+      state->options.io_advice = value;
+      break;
+    case SPLT_OPT_PREALLOCATE_OUTPUT:
+      state->options.preallocate_output = value;
+      break;
+    case SPLT_OPT_IO_BUFFER_SIZE:
+      state->options.io_buffer_size = value;
+      break;
     default:
       splt_u_error(SPLT_IERROR_INT,__func__, option_name, NULL);
       break;
@@ -1508,6 +1655,33 @@ int splt_t_get_int_option(splt_state *state, int option_name)
     case SPLT_OPT_REPLACE_TAGS_IN_TAGS:
       return state->options.replace_tags_in_tags;
       break;
+    case SPLT_OPT_AUTO_THRESHOLD:
+      return state->options.auto_threshold;
+      break;
+    case SPLT_OPT_FAST_SCAN:
+      return state->options.fast_scan;
+      break;
+    case SPLT_OPT_SEEK_INDEX:
+      return state->options.seek_index;
+      break;
+    case SPLT_OPT_READ_AHEAD:
+      return state->options.read_ahead;
+      break;
+    case SPLT_OPT_WRITE_BEHIND:
+      return state->options.write_behind;
+      break;
+    case SPLT_OPT_SYNC_OUTPUT:
+      return state->options.sync_output;
+      break;
+    case SPLT_OPT_IO_ADVICE:
+      return state->options.io_advice;
+      break;
+    case SPLT_OPT_PREALLOCATE_OUTPUT:
+      return state->options.preallocate_output;
+      break;
+    case SPLT_OPT_IO_BUFFER_SIZE:
+      return state->options.io_buffer_size;
+      break;
     default:
       splt_u_error(SPLT_IERROR_INT,__func__, option_name, NULL);
       break;
@@ -1622,7 +1796,7 @@ int splt_t_freedb_append_result(splt_state *state, const char *album_name, int r
   //search_results variable, do it now
   if (state->fdb.search_results->number == 0)
   {
-    state->fdb.search_results->results = malloc(sizeof(splt_freedb_one_result));
+    state->fdb.search_results->results = splt_u_malloc(sizeof(splt_freedb_one_result));
     if (state->fdb.search_results->results == NULL)
     {
       error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -1630,7 +1804,7 @@ int splt_t_freedb_append_result(splt_state *state, const char *album_name, int r
     else
     {
       state->fdb.search_results->results[0].revisions = NULL;
-      state->fdb.search_results->results[0].name = strdup(album_name);
+      state->fdb.search_results->results[0].name = splt_u_strdup(album_name);
       if (state->fdb.search_results->results[0].name == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -1652,7 +1826,7 @@ int splt_t_freedb_append_result(splt_state *state, const char *album_name, int r
     if (revision != -1)
     {
       state->fdb.search_results->results = 
-        realloc(state->fdb.search_results->results,
+        splt_u_realloc(state->fdb.search_results->results,
             (state->fdb.search_results->number + 1)
             * sizeof(splt_freedb_one_result));
       state->fdb.search_results->results[state->fdb.search_results->number].revisions = NULL;
@@ -1663,7 +1837,7 @@ int splt_t_freedb_append_result(splt_state *state, const char *album_name, int r
       else
       {
         state->fdb.search_results->results[state->fdb.search_results->number]
-          .name = strdup(album_name);
+          .name = splt_u_strdup(album_name);
         if (state->fdb.search_results->results[state->fdb.search_results->number]
             .name == NULL)
         {
@@ -1689,7 +1863,7 @@ int splt_t_freedb_append_result(splt_state *state, const char *album_name, int r
           .revision_number == 0)
       {
         state->fdb.search_results->results[state->fdb.search_results->number-1].revisions =
-          malloc(sizeof(int));
+          splt_u_malloc(sizeof(int));
         if (state->fdb.search_results->results[state->fdb.search_results->number-1].revisions
             == NULL)
         {
@@ -1706,7 +1880,7 @@ int splt_t_freedb_append_result(splt_state *state, const char *album_name, int r
         //if it's not the first revision
       {
         state->fdb.search_results->results[state->fdb.search_results->number-1].revisions =
-          realloc(state->fdb.search_results->results
+          splt_u_realloc(state->fdb.search_results->results
               [state->fdb.search_results->number-1].revisions,
               (state->fdb.search_results->results[state->fdb.search_results->number-1]
                .revision_number + 1)
@@ -1736,7 +1910,7 @@ int splt_t_freedb_init_search(splt_state *state)
 {
   int error = SPLT_OK;
 
-  if ((state->fdb.cdstate = malloc(sizeof(splt_cd_state))) == NULL)
+  if ((state->fdb.cdstate = splt_u_malloc(sizeof(splt_cd_state))) == NULL)
   {
     error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
   }
@@ -1745,7 +1919,7 @@ int splt_t_freedb_init_search(splt_state *state)
     state->fdb.cdstate->foundcd = 0;
     //initialise the search results
     if ((state->fdb.search_results =
-          malloc(sizeof(splt_freedb_results))) == NULL)
+          splt_u_malloc(sizeof(splt_freedb_results))) == NULL)
     {
       free(state->fdb.cdstate);
       state->fdb.cdstate = NULL;
@@ -1844,86 +2018,162 @@ const char *splt_t_freedb_get_disc_id(splt_state *state, int index)
 /********************************/
 /* types: silence access */
 
-//creates a new ssplit structure
-int splt_t_ssplit_new(struct splt_ssplit **silence_list, 
+//appends a silence to the silence list
+int splt_t_ssplit_new(struct splt_ssplit *silence_list, 
     float begin_position, float end_position, int len, int *error)
 {
-  struct splt_ssplit *temp = NULL;
-  struct splt_ssplit *s_new = NULL;
+  if (silence_list->number >= silence_list->allocated)
+  {
+    int allocated = SPLT_SILENCE_LIST_ALLOC;
+    if (silence_list->allocated > 0)
+    {
+      allocated = silence_list->allocated * 2;
+    }
+
+    double *begin = splt_u_realloc(silence_list->begin_position,
+        sizeof(double) * allocated);
+    if (begin == NULL) { goto alloc_error; }
+    silence_list->begin_position = begin;
+
+    double *end = splt_u_realloc(silence_list->end_position,
+        sizeof(double) * allocated);
+    if (end == NULL) { goto alloc_error; }
+    silence_list->end_position = end;
+
+    long *lengths = splt_u_realloc(silence_list->len, sizeof(long) * allocated);
+    if (lengths == NULL) { goto alloc_error; }
+    silence_list->len = lengths;
 
-  if ((s_new = malloc(sizeof(struct splt_ssplit)))==NULL)
+    silence_list->allocated = allocated;
+  }
+
+  int i = silence_list->number;
+  silence_list->begin_position[i] = begin_position;
+  silence_list->end_position[i] = end_position;
+  silence_list->len[i] = len;
+  silence_list->number++;
+
+  return 0;
+
+alloc_error:
+  *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  return -1;
+}
+
+//free the silence list
+void splt_t_ssplit_free(struct splt_ssplit *silence_list)
+{
+  if (silence_list)
   {
-    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
-    return -1;
+    if (silence_list->begin_position)
+    {
+      free(silence_list->begin_position);
+      silence_list->begin_position = NULL;
+    }
+    if (silence_list->end_position)
+    {
+      free(silence_list->end_position);
+      silence_list->end_position = NULL;
+    }
+    if (silence_list->len)
+    {
+      free(silence_list->len);
+      silence_list->len = NULL;
+    }
+    silence_list->number = 0;
+    silence_list->allocated = 0;
   }
-  s_new->len = len;
-  s_new->begin_position = begin_position;
-  s_new->end_position = end_position;
-  s_new->next = NULL;
+}
 
-  temp = *silence_list;
-  if (temp == NULL)
+//returns SPLT_TRUE if silence 'i' is a better splitpoint than silence 'j':
+//it is longer, or as long and found before
+static int splt_t_ssplit_is_longer(struct splt_ssplit *silence_list,
+    int i, int j)
+{
+  if (silence_list->len[i] != silence_list->len[j])
   {
-    *silence_list = s_new; // No elements
+    return silence_list->len[i] > silence_list->len[j];
   }
-  else 
+
+  return i < j;
+}
+
+//returns the index of the longest silence or -1 if we have none
+int splt_t_ssplit_get_longest(struct splt_ssplit *silence_list)
+{
+  int longest = -1;
+
+  int i = 0;
+  for (i = 0;i < silence_list->number;i++)
   {
-    if (temp->len < len)
-    {
-      s_new->next = temp;
-      *silence_list = s_new;
-    }
-    else
+    if ((longest == -1) || splt_t_ssplit_is_longer(silence_list, i, longest))
     {
-      if (temp->next == NULL)
-        temp->next = s_new;
-      else 
-      {
-        while (temp != NULL) 
-        {
-          if (temp->next != NULL) 
-          {
-            if (temp->next->len < len) 
-            {
-              // We build an ordered list by len to keep most probable silence points
-              s_new->next = temp->next;
-              temp->next = s_new;
-              break;
-            }
-          }
-          else 
-          {
-            temp->next = s_new;
-            break;
-          }
-          temp = temp->next;
-        }
-      }
+      longest = i;
     }
   }
 
-  return 0;
+  return longest;
 }
 
-//free the ssplit structure
-void splt_t_ssplit_free (struct splt_ssplit **silence_list)
+//returns the indexes of all the silences, with the 'number' longest
+//ones first (in no particular order), by quick selection
+//-result must be freed
+int *splt_t_ssplit_select_longest(struct splt_ssplit *silence_list,
+    int number, int *error)
 {
-  struct splt_ssplit *temp = NULL, *saved = NULL;
+  int count = silence_list->number;
 
-  if (silence_list)
+  int *indexes = splt_u_malloc(sizeof(int) * (count + 1));
+  if (indexes == NULL)
+  {
+    *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+    return NULL;
+  }
+
+  int i = 0;
+  for (i = 0;i < count;i++)
   {
-    temp = *silence_list;
+    indexes[i] = i;
+  }
 
-    while (temp != NULL)
+  int left = 0, right = count - 1;
+  while ((number > 0) && (number < count) && (left < right))
+  {
+    //partition around the middle element
+    int pivot = indexes[left + (right - left) / 2];
+    int l = left, r = right;
+    while (l <= r)
     {
-      saved = temp->next;
-      free(temp);
-      temp = saved;
+      while (splt_t_ssplit_is_longer(silence_list, indexes[l], pivot)) { l++; }
+      while (splt_t_ssplit_is_longer(silence_list, pivot, indexes[r])) { r--; }
+      if (l <= r)
+      {
+        int temp = indexes[l];
+        indexes[l] = indexes[r];
+        indexes[r] = temp;
+        l++;
+        r--;
+      }
     }
 
-    *silence_list = NULL;
+    //continue in the part containing the 'number'-th element
+    if (number - 1 <= r)
+    {
+      right = r;
+    }
+    else if (number - 1 >= l)
+    {
+      left = l;
+    }
+    else
+    {
+      break;
+    }
   }
+
+  return indexes;
 }
+
 /********************************/
 /* types: sync errors access */
 
@@ -1937,26 +2187,32 @@ int splt_t_serrors_append_point(splt_state *state, off_t point)
 
   if (point >= 0)
   {
-    //allocate memory for the splitpoints
+    //allocate memory for the splitpoints, doubling the size
     if (state->serrors->serrors_points == NULL)
     {
       if((state->serrors->serrors_points = 
-            malloc(sizeof(off_t) * (serrors_num + 2))) == NULL)
+            splt_u_malloc(sizeof(off_t) * SPLT_SERRORS_ALLOC)) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
       }
       else
       {
+        state->serrors->serrors_points_alloc = SPLT_SERRORS_ALLOC;
         state->serrors->serrors_points[0] = 0;
       }
     }
-    else
+    else if (serrors_num + 2 > state->serrors->serrors_points_alloc)
     {
-      if((state->serrors->serrors_points = realloc(state->serrors->serrors_points,
-              sizeof(off_t) * (serrors_num + 2))) == NULL)
+      long int alloc = state->serrors->serrors_points_alloc * 2;
+      if((state->serrors->serrors_points = splt_u_realloc(state->serrors->serrors_points,
+              sizeof(off_t) * alloc)) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
       }
+      else
+      {
+        state->serrors->serrors_points_alloc = alloc;
+      }
     }
 
     if (error == SPLT_OK)
@@ -2012,6 +2268,7 @@ void splt_t_serrors_free(splt_state *state)
     free(state->serrors->serrors_points);
     state->serrors->serrors_points = NULL;
     state->serrors->serrors_points_num = 0;
+    state->serrors->serrors_points_alloc = 0;
   }
 }
 
@@ -2027,7 +2284,7 @@ int splt_t_wrap_put_file(splt_state *state,
   //we allocate memory the first time for all files
   if (index == 0)
   {
-    if ((state->wrap->wrap_files = malloc(wrapfiles * sizeof(char*))) == NULL)
+    if ((state->wrap->wrap_files = splt_u_malloc(wrapfiles * sizeof(char*))) == NULL)
     {
       error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
     }
@@ -2046,7 +2303,7 @@ int splt_t_wrap_put_file(splt_state *state,
     }
     else
     {
-      if ((state->wrap->wrap_files[index] = strdup(filename)) == NULL)
+      if ((state->wrap->wrap_files[index] = splt_u_strdup(filename)) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
       }
@@ -2116,6 +2373,12 @@ int splt_t_put_split_file(splt_state *state, const char *filename)
     //splt_u_error(SPLT_IERROR_INT,__func__, -500, NULL);
   }
 
+  //so that a split with the same plan does not split it again
+  if (error >= 0)
+  {
+    error = splt_jn_put_segment(state, filename);
+  }
+
   return error;
 }
 
@@ -2194,48 +2457,103 @@ void splt_t_put_debug_message_to_client(splt_state *state, char *message)
   splt_t_put_message_to_client(state, message, SPLT_MESSAGE_DEBUG);
 }
 
+//forgets the estimated rate of progress calls;
+//the next call will read the clock
+void splt_t_reset_progress_rate(splt_state *state)
+{
+  splt_t_set_iopt(state, SPLT_INTERNAL_PROGRESS_RATE, 0);
+  state->iopts.progress_calls = 0;
+  state->iopts.progress_check_time = 0;
+}
+
 //update the progress,
 //current_point = the current progress point
 //total_points = total progress points
 //split_stage = 1 means we put on the whole progress bar,
 //if split_stage = 2,
 //progress_start = from where to start the progress (fraction)
-//refresh_rate = the refresh rate of the display
+//refresh_rate = the number of calls before the first clock reading
+//
+//the progress callback is called at most every SPLT_PROGRESS_INTERVAL
+//seconds; between two clock readings we only count down the number
+//of calls estimated from the previous readings
+//
+//a call with refresh_rate = 1 or at the end of the progress is always
+//passed to the callback
 void splt_t_update_progress(splt_state *state, double current_point,
     double total_points, int progress_stage,
     float progress_start, int refresh_rate)
 {
-  //if we have a progress callback function
-  if (state->split.p_bar->progress != NULL)
+  int forced = (refresh_rate == 1) || (current_point >= total_points);
+
+  if (!forced && (--state->iopts.progress_countdown > 0))
   {
-    if (splt_t_get_iopt(state, SPLT_INTERNAL_PROGRESS_RATE) > refresh_rate)
-    {
-      //shows the progress
-      state->split.p_bar->percent_progress = (float) (current_point / total_points);
+    return;
+  }
 
-      state->split.p_bar->percent_progress = 
-        state->split.p_bar->percent_progress / progress_stage + progress_start;
+  double now = splt_st_wall_time();
 
-      //security check
-      if (state->split.p_bar->percent_progress < 0)
-      {
-        state->split.p_bar->percent_progress = 0;
-      }
-      if (state->split.p_bar->percent_progress > 1)
-      {
-        state->split.p_bar->percent_progress = 1;
-      }
+  //if we have a progress callback function or an asynchronous split
+  if (((state->split.p_bar->progress != NULL) || (state->async != NULL))
+      && (forced || (state->iopts.progress_time == 0) ||
+        (now - state->iopts.progress_time >= SPLT_PROGRESS_INTERVAL)))
+  {
+    //shows the progress
+    state->split.p_bar->percent_progress = (float) (current_point / total_points);
+
+    state->split.p_bar->percent_progress = 
+      state->split.p_bar->percent_progress / progress_stage + progress_start;
+
+    //security check
+    if (state->split.p_bar->percent_progress < 0)
+    {
+      state->split.p_bar->percent_progress = 0;
+    }
+    if (state->split.p_bar->percent_progress > 1)
+    {
+      state->split.p_bar->percent_progress = 1;
+    }
 
-      //call
+    //call
+    if (state->split.p_bar->progress != NULL)
+    {
       state->split.p_bar->progress(state->split.p_bar);
-      splt_t_set_iopt(state, SPLT_INTERNAL_PROGRESS_RATE, 0);
     }
-    else
+    //wake up the client of the asynchronous split
+    if (state->async != NULL)
     {
-      splt_t_set_iopt(state, SPLT_INTERNAL_PROGRESS_RATE,
-          splt_t_get_iopt(state, SPLT_INTERNAL_PROGRESS_RATE)+1);
+      splt_as_put_progress(state->async, state->split.p_bar->percent_progress);
     }
+
+    state->iopts.progress_time = now;
+  }
+
+  //forced calls don't count in the rate of the regular calls
+  if (forced)
+  {
+    return;
+  }
+
+  //estimate how many calls we will get until the next clock reading
+  double calls = refresh_rate;
+  double elapsed = now - state->iopts.progress_check_time;
+  if ((state->iopts.progress_calls > 0) && (elapsed > 0))
+  {
+    calls = state->iopts.progress_calls *
+      (SPLT_PROGRESS_INTERVAL / SPLT_PROGRESS_CHECKS) / elapsed;
+  }
+  if (calls < 1)
+  {
+    calls = 1;
+  }
+  if (calls > SPLT_PROGRESS_MAX_CALLS)
+  {
+    calls = SPLT_PROGRESS_MAX_CALLS;
   }
+
+  state->iopts.progress_calls = (int) calls;
+  state->iopts.progress_countdown = state->iopts.progress_calls;
+  state->iopts.progress_check_time = now;
 }
 
 /********************************/
@@ -2332,6 +2650,20 @@ char *splt_t_get_m3u_file_with_path(splt_state *state, int *error)
   return splt_u_get_file_with_output_path(state, m3u_file, error);
 }
 
+//-result must be freed
+char *splt_t_get_manifest_file_with_path(splt_state *state, int *error)
+{
+  char *manifest_file = splt_t_get_manifest_filename(state);
+  return splt_u_get_file_with_output_path(state, manifest_file, error);
+}
+
+//-result must be freed
+char *splt_t_get_journal_file_with_path(splt_state *state, int *error)
+{
+  char *journal_file = splt_t_get_journal_filename(state);
+  return splt_u_get_file_with_output_path(state, journal_file, error);
+}
+
 int splt_t_get_current_plugin(splt_state *state)
 {
   return state->current_plugin;
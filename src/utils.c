@@ -41,7 +41,10 @@
 #ifdef __WIN32__
 #include <windows.h>
 #include <direct.h>
+#include <io.h>
 #include "win32.h"
+#else
+#include <unistd.h>
 #endif
 
 extern short global_debug;
@@ -51,6 +54,51 @@ extern short global_debug;
 
 static void splt_u_cut_extension(char *str);
 
+/****************************/
+/* utils for memory */
+
+//number of allocations of the calling thread; each thread counts its
+//own, see splt_st_get_thread_usage
+#ifndef __WIN32__
+static __thread unsigned long splt_u_allocations = 0;
+#else
+static unsigned long splt_u_allocations = 0;
+#endif
+
+//malloc counting the allocation
+void *splt_u_malloc(size_t size)
+{
+  splt_u_allocations++;
+  return malloc(size);
+}
+
+//realloc counting the allocation
+void *splt_u_realloc(void *ptr, size_t size)
+{
+  splt_u_allocations++;
+  return realloc(ptr, size);
+}
+
+//calloc counting the allocation
+void *splt_u_calloc(size_t nmemb, size_t size)
+{
+  splt_u_allocations++;
+  return calloc(nmemb, size);
+}
+
+//strdup counting the allocation
+char *splt_u_strdup(const char *s)
+{
+  splt_u_allocations++;
+  return strdup(s);
+}
+
+//returns the number of allocations of the calling thread
+unsigned long splt_u_get_allocations()
+{
+  return splt_u_allocations;
+}
+
 /****************************/
 /* utils for conversion */
 
@@ -198,7 +246,7 @@ void splt_u_cleanstring_(splt_state *state, char *s, int *error, int ignore_dirc
   char *copy = NULL;
   if (s)
   {
-    copy = strdup(s);
+    copy = splt_u_strdup(s);
     if (copy)
     {
       for (i=0; i<=strlen(copy); i++)
@@ -301,10 +349,10 @@ static char *splt_u_get_mins_secs_filename(const char *filename, splt_state *sta
 
   long old_split_end = split_end;
 
-  if((fname = malloc(fname_malloc_number*sizeof(char))) != NULL)
+  if((fname = splt_u_malloc(fname_malloc_number*sizeof(char))) != NULL)
   {
     memset(fname,'\0',fname_malloc_number*sizeof(char));
-    if((fname2 = malloc(fname2_malloc_number*sizeof(char))) != NULL)
+    if((fname2 = splt_u_malloc(fname2_malloc_number*sizeof(char))) != NULL)
     {
       memset(fname2,'\0',fname2_malloc_number*sizeof(char));
       long hundr = 0, secs = 0, mins = 0;
@@ -412,7 +460,7 @@ void splt_u_set_complete_mins_secs_filename(splt_state *state, int *error)
   long split_end = splt_t_get_splitpoint_value(state, current_split+1, &get_error);
   if (get_error < 0) { *error = get_error; return; }
 
-  char *filename2 = strdup(filename);
+  char *filename2 = splt_u_strdup(filename);
   if (!filename2)
   {
     *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -469,7 +517,7 @@ char *splt_u_get_fname_with_path_and_extension(splt_state *state, int *error)
   //if we don't output to stdout
   if (output_fname && (strcmp(output_fname,"-") != 0))
   {
-    if ((output_fname_with_path = malloc(malloc_number)) != NULL)
+    if ((output_fname_with_path = splt_u_malloc(malloc_number)) != NULL)
     {
       //we put the full output filename (with the path)
       //construct full filename with path
@@ -531,11 +579,11 @@ char *splt_u_get_fname_with_path_and_extension(splt_state *state, int *error)
     char *returned_result = NULL;
     if (output_fname)
     {
-      returned_result = strdup(output_fname);
+      returned_result = splt_u_strdup(output_fname);
     }
     else
     {
-      returned_result = strdup("-");
+      returned_result = splt_u_strdup("-");
     }
     if (returned_result)
     {
@@ -580,7 +628,7 @@ int splt_u_cut_splitpoint_extension(splt_state *state, int index)
     {
       if (temp_name)
       {
-        char *new_name = strdup(temp_name);
+        char *new_name = splt_u_strdup(temp_name);
         if (new_name == NULL)
         {
           return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -599,29 +647,53 @@ int splt_u_cut_splitpoint_extension(splt_state *state, int index)
   return change_error;
 }
 
+static int splt_u_compare_splitpoint_values(const void *v1, const void *v2)
+{
+  long value1 = *((const long *) v1);
+  long value2 = *((const long *) v2);
+
+  if (value1 < value2)
+  {
+    return -1;
+  }
+
+  return value1 > value2;
+}
+
 //order the splitpoints (used in the silence split)
 //only works for the values, the names are not ordered!
-void splt_u_order_splitpoints(splt_state *state, int len)
+//returns possible error
+int splt_u_order_splitpoints(splt_state *state, int len)
 {
-  long temp = 0;
+  if (len < 2)
+  {
+    return SPLT_OK;
+  }
+
+  long *values = splt_u_malloc(sizeof(long) * len);
+  if (values == NULL)
+  {
+    return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
+  }
 
   int err = SPLT_OK;
+  int i = 0;
+  for (i = 0;i < len;i++)
+  {
+    values[i] = splt_t_get_splitpoint_value(state,i,&err);
+  }
+
+  qsort(values, len, sizeof(long), splt_u_compare_splitpoint_values);
 
-  int i, j;
-  float key;
-  for (j=1; j < len; j++)
+  for (i = 0;i < len;i++)
   {
-    key = splt_t_get_splitpoint_value(state,j,&err);
-    i = j -1;
-    while ((i >= 0) && 
-        (splt_t_get_splitpoint_value(state,i,&err) > key))
-    {
-      temp = splt_t_get_splitpoint_value(state,i,&err);
-      splt_t_set_splitpoint_value(state,i+1,temp);
-      i--;
-    }
-    splt_t_set_splitpoint_value(state,i+1,key);
+    splt_t_set_splitpoint_value(state,i,values[i]);
   }
+
+  free(values);
+  values = NULL;
+
+  return SPLT_OK;
 }
 
 /****************************/
@@ -670,7 +742,7 @@ static char *splt_u_parse_tag_word(const char *cur_pos,
       int string_length = word_end-(equal_sign+1);
       if (string_length > 0)
       {
-        word = malloc((string_length+1)*sizeof(char));
+        word = splt_u_malloc((string_length+1)*sizeof(char));
         memset(word,'\0',(string_length+1)*sizeof(char));
         if (word)
         {
@@ -882,27 +954,27 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                     //set new all tags
                     if (last_tags.title != NULL)
                     {
-                      all_title = strdup(last_tags.title);
+                      all_title = splt_u_strdup(last_tags.title);
                     }
                     if (last_tags.artist != NULL)
                     {
-                      all_artist = strdup(last_tags.artist);
+                      all_artist = splt_u_strdup(last_tags.artist);
                     }
                     if (last_tags.album != NULL)
                     {
-                      all_album = strdup(last_tags.album);
+                      all_album = splt_u_strdup(last_tags.album);
                     }
                     if (last_tags.performer != NULL)
                     {
-                      all_performer = strdup(last_tags.performer);
+                      all_performer = splt_u_strdup(last_tags.performer);
                     }
                     if (last_tags.year != NULL)
                     {
-                      all_year = strdup(last_tags.year);
+                      all_year = splt_u_strdup(last_tags.year);
                     }
                     if (last_tags.comment != NULL)
                     {
-                      all_comment = strdup(last_tags.comment);
+                      all_comment = splt_u_strdup(last_tags.comment);
                     }
                     all_genre = last_tags.genre;
                     all_tracknumber = last_tags.track;
@@ -938,7 +1010,7 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                 if (all_tags)
                 {
                   if (all_artist) { free(all_artist); all_artist = NULL; }
-                  all_artist = strdup(artist);
+                  all_artist = splt_u_strdup(artist);
                 }
                 cur_pos += strlen(artist)+2;
                 s_artist++;
@@ -957,7 +1029,7 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                 if (all_tags)
                 {
                   if (all_performer) { free(all_performer); all_performer = NULL; }
-                  all_performer = strdup(performer);
+                  all_performer = splt_u_strdup(performer);
                 }
                 cur_pos += strlen(performer)+2;
                 s_performer++;
@@ -976,7 +1048,7 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                 if (all_tags)
                 {
                   if (all_album) { free(all_album); all_album = NULL; }
-                  all_album = strdup(album);
+                  all_album = splt_u_strdup(album);
                 }
                 cur_pos += strlen(album)+2;
                 s_album++;
@@ -995,7 +1067,7 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                 if (all_tags)
                 {
                   if (all_title) { free(all_title); all_title = NULL; }
-                  all_title = strdup(title);
+                  all_title = splt_u_strdup(title);
                 }
 
                 cur_pos += strlen(title)+2;
@@ -1015,7 +1087,7 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                 if (all_tags)
                 {
                   if (all_comment) { free(all_comment); all_comment = NULL; }
-                  all_comment = strdup(comment);
+                  all_comment = splt_u_strdup(comment);
                 }
 
                 cur_pos += strlen(comment)+2;
@@ -1035,7 +1107,7 @@ int splt_u_put_tags_from_string(splt_state *state, const char *tags, int *error)
                 if (all_tags)
                 {
                   if (all_year) { free(all_year); all_year = NULL; }
-                  all_year = strdup(year);
+                  all_year = splt_u_strdup(year);
                 }
 
                 cur_pos += strlen(year)+2;
@@ -1498,7 +1570,7 @@ void splt_u_create_output_dirs_if_necessary(splt_state *state,
 {
   if (splt_t_get_int_option(state, SPLT_OPT_CREATE_DIRS_FROM_FILENAMES))
   {
-    char *only_dirs = strdup(output_filename);
+    char *only_dirs = splt_u_strdup(output_filename);
     if (! only_dirs)
     {
       *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -1611,7 +1683,7 @@ static int splt_u_put_output_format_filename(splt_state *state, int current_spli
       }
 
       int temp_len = strlen(state->oformat.format[i])+10;
-      if ((temp = malloc(temp_len * sizeof(char))) == NULL)
+      if ((temp = splt_u_malloc(temp_len * sizeof(char))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
         goto end;
@@ -1652,7 +1724,7 @@ put_value:
               eof_written = SPLT_TRUE;
 
               fm_length = strlen(temp) + 4;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+              if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
               {
                 error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
                 goto end;
@@ -1697,7 +1769,7 @@ put_value:
               snprintf(temp + offset, temp_len, format + 2);
 
               fm_length = strlen(temp) + 1 + max_number_of_digits;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+              if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
               {
                 error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
                 goto end;
@@ -1743,7 +1815,7 @@ put_value:
             fm_length = strlen(temp) + 1;
           }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+          if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
             goto end;
@@ -1789,7 +1861,7 @@ put_value:
             fm_length = strlen(temp) + 1;
           }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+          if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
             goto end;
@@ -1834,7 +1906,7 @@ put_value:
             fm_length = strlen(temp) + 1;
           }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+          if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
             goto end;
@@ -1878,7 +1950,7 @@ put_value:
             fm_length = strlen(temp) + 1;
           }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+          if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
             goto end;
@@ -1922,7 +1994,7 @@ put_value:
             fm_length = strlen(temp) + 1;
           }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+          if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
             goto end;
@@ -1989,7 +2061,7 @@ put_value:
             fm_length = strlen(state->oformat.format[i]) + 1 + alpha_max_num_of_digits;
           }
 
-          if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+          if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
           {
             error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
             goto end;
@@ -2010,7 +2082,7 @@ put_value:
           if (splt_t_get_filename_to_split(state) != NULL)
           {
             //we get the filename
-            original_filename = strdup(splt_u_get_real_name(splt_t_get_filename_to_split(state)));
+            original_filename = splt_u_strdup(splt_u_get_real_name(splt_t_get_filename_to_split(state)));
             if (original_filename)
             {
               snprintf(temp+2,temp_len, state->oformat.format[i]+2);
@@ -2021,7 +2093,7 @@ put_value:
               int filename_length = strlen(original_filename);
 
               fm_length = strlen(temp) + filename_length;
-              if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+              if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
               {
                 error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
                 goto end;
@@ -2043,7 +2115,7 @@ put_value:
     else
     {
       fm_length = SPLT_MAXOLEN;
-      if ((fm = malloc(fm_length * sizeof(char))) == NULL)
+      if ((fm = splt_u_malloc(fm_length * sizeof(char))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
         goto end;
@@ -2061,7 +2133,7 @@ put_value:
     //allocate memory for the output filename
     if (!output_filename)
     {
-      if ((output_filename = malloc((1+fm_size)*sizeof(char))) == NULL)
+      if ((output_filename = splt_u_malloc((1+fm_size)*sizeof(char))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
         goto end;
@@ -2072,7 +2144,7 @@ put_value:
     else
     {
       output_filename_size += fm_size+1;
-      if ((output_filename = realloc(output_filename, output_filename_size
+      if ((output_filename = splt_u_realloc(output_filename, output_filename_size
               * sizeof(char))) == NULL)
       {
         error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -2167,11 +2239,12 @@ void splt_u_error(int error_type, const char *function,
 /****************************/
 /* utils miscellaneous */
 
-//get silence position depending of the offset
-float splt_u_silence_position(struct splt_ssplit *temp, float off)
+//get the position of silence 'i' depending of the offset
+float splt_u_silence_position(struct splt_ssplit *silence_list, int i, float off)
 {
-  float length_of_silence = (temp->end_position - temp->begin_position);
-  float position = temp->begin_position + (length_of_silence * off);
+  float length_of_silence =
+    (silence_list->end_position[i] - silence_list->begin_position[i]);
+  float position = silence_list->begin_position[i] + (length_of_silence * off);
 
   return position;
 }
@@ -2181,7 +2254,7 @@ float splt_u_silence_position(struct splt_ssplit *temp, float off)
 char *splt_u_strerror(splt_state *state, splt_code error_code)
 {
   int max_error_size = 4096;
-  char *error_msg = malloc(sizeof(char) * max_error_size);
+  char *error_msg = splt_u_malloc(sizeof(char) * max_error_size);
   if (error_msg)
   {
     memset(error_msg,'\0',4096);
@@ -2368,6 +2441,11 @@ char *splt_u_strerror(splt_state *state, splt_code error_code)
       case SPLT_ERROR_CANNOT_GET_TOTAL_TIME:
         snprintf(error_msg,max_error_size, _(" error: cannot get total audio length"));
         break;
+      case SPLT_ERROR_CANNOT_START_ASYNC_SPLIT:
+        snprintf(error_msg,max_error_size,
+            _(" error: cannot start the asynchronous split (%s)"),
+            state->err.strerror_msg);
+        break;
       case SPLT_ERROR_SPLITPOINTS_NOT_IN_ORDER:
         snprintf(error_msg,max_error_size,
             _(" error: the splitpoints are not in order (%s)"),
@@ -2525,7 +2603,7 @@ void splt_u_print_debug(splt_state *state, const char *message,
     {
       mess_size += strlen(optional2);
     }
-    char *mess = malloc(sizeof(char) * mess_size);
+    char *mess = splt_u_malloc(sizeof(char) * mess_size);
 
     if (optional != 0)
     {
@@ -2596,29 +2674,6 @@ void splt_u_get_mins_secs_hundr(long split_hundr, long *mins, long *secs, long *
   }
 }
 
-int splt_u_parse_ssplit_file(splt_state *state, FILE *log_file, int *error)
-{
-  char line[512] = { '\0' };
-  int found = 0;
-
-  while(fgets(line, 512, log_file)!=NULL)
-  {
-    int len = 0;
-    float begin_position = 0, end_position = 0;
-    if (sscanf(line, "%f\t%f\t%d", &begin_position, &end_position, &len) == 3)
-    {
-      splt_t_ssplit_new(&state->silence_list, begin_position, end_position, len, error);
-      if (*error < 0)
-      {
-        break;
-      }
-      found++;
-    }
-  }
-
-  return found;
-}
-
 //create recursive directories
 int splt_u_create_directories(splt_state *state, const char *dir)
 {
@@ -2628,7 +2683,7 @@ int splt_u_create_directories(splt_state *state, const char *dir)
   {
     return result;
   }
-  char *junk = malloc(sizeof(char) * (strlen(dir)+100));
+  char *junk = splt_u_malloc(sizeof(char) * (strlen(dir)+100));
   if (!junk)
   {
     return SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -2681,7 +2736,7 @@ int splt_u_create_directories(splt_state *state, const char *dir)
   if (dir)
   {
     //we have created all the directories except the last one
-    char *last_dir = strdup(dir);
+    char *last_dir = splt_u_strdup(dir);
     if (!last_dir)
     {
       result = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -2731,7 +2786,7 @@ static wchar_t *splt_u_win32_encoding_to_utf16(UINT encoding, const char *source
   int converted_size = MultiByteToWideChar(encoding, 0, source, -1, NULL, 0);
   if (converted_size > 0)
   {
-    dest = malloc(sizeof(wchar_t) * converted_size);
+    dest = splt_u_malloc(sizeof(wchar_t) * converted_size);
     if (dest)
     {
       MultiByteToWideChar(encoding, 0, source, -1, dest, converted_size);
@@ -2748,7 +2803,7 @@ static char *splt_u_win32_utf16_to_encoding(UINT encoding, const wchar_t *source
   int converted_size = WideCharToMultiByte(encoding, 0, source, -1, NULL, 0, NULL, NULL);
   if (converted_size > 0)
   {
-    dest = malloc(sizeof(char *) * converted_size);
+    dest = splt_u_malloc(sizeof(char *) * converted_size);
     if (dest)
     {
       WideCharToMultiByte(encoding, 0, source, -1, dest, converted_size, NULL, NULL);
@@ -2957,7 +3012,7 @@ char *splt_u_str_to_upper(const char *str, int *error)
 {
   int i = 0;
 
-  char *result = strdup(str);
+  char *result = splt_u_strdup(str);
   if (result == NULL)
   {
     *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -3040,7 +3095,7 @@ void splt_u_find_filenames(splt_state *state, const char *directory,
     if (*error >= 0)
     {
       int path_with_fname_size = fname_size + strlen(directory) + 2;
-      char *path_with_fname = malloc(sizeof(char) * path_with_fname_size);
+      char *path_with_fname = splt_u_malloc(sizeof(char) * path_with_fname_size);
       if (path_with_fname == NULL)
       {
         *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -3058,11 +3113,11 @@ void splt_u_find_filenames(splt_state *state, const char *directory,
         {
           if (!(*found_files))
           {
-            (*found_files) = malloc(sizeof(char *));
+            (*found_files) = splt_u_malloc(sizeof(char *));
           }
           else
           {
-            (*found_files) = realloc((*found_files),
+            (*found_files) = splt_u_realloc((*found_files),
                 sizeof(char *) * ((*number_of_found_files) + 1));
           }
           if (*found_files == NULL)
@@ -3072,7 +3127,7 @@ void splt_u_find_filenames(splt_state *state, const char *directory,
           }
 
           int fname_size = strlen(path_with_fname) + 1;
-          (*found_files)[(*number_of_found_files)] = malloc(sizeof(char) * fname_size);
+          (*found_files)[(*number_of_found_files)] = splt_u_malloc(sizeof(char) * fname_size);
           if ((*found_files)[(*number_of_found_files)] == NULL)
           {
             *error = SPLT_ERROR_CANNOT_ALLOCATE_MEMORY;
@@ -3179,8 +3234,63 @@ size_t splt_u_fwrite(splt_state *state, const void *ptr,
   }
   else
   {
-    return fwrite(ptr, size, nmemb, stream);
+    size_t written = 0;
+    if (splt_t_get_int_option(state, SPLT_OPT_WRITE_BEHIND))
+    {
+      written = splt_wb_fwrite(state, ptr, size, nmemb, stream);
+    }
+    else
+    {
+      written = fwrite(ptr, size, nmemb, stream);
+    }
+    state->stats.bytes_written += written * size;
+    return written;
+  }
+}
+
+//closes a split file after its data written behind the split, if any;
+//the file is synchronized to the disk with SPLT_OPT_SYNC_OUTPUT, and
+//stdout is flushed but not closed
+//-returns 0, or EOF with errno set like fclose
+int splt_u_fclose_output(splt_state *state, FILE *stream)
+{
+  int result = splt_wb_flush(state, stream);
+
+  if (fflush(stream) != 0)
+  {
+    result = EOF;
+  }
+
+  splt_io_release_output(state, stream);
+
+  if (result == 0 && splt_t_get_int_option(state, SPLT_OPT_SYNC_OUTPUT) &&
+      stream != stdout)
+  {
+#ifdef __WIN32__
+    if (_commit(_fileno(stream)) != 0)
+#else
+    if (fsync(fileno(stream)) != 0)
+#endif
+    {
+      result = EOF;
+    }
+  }
+
+  if (stream != stdout)
+  {
+    if (result != 0)
+    {
+      int error_number = errno;
+      fclose(stream);
+      errno = error_number;
+    }
+    else
+    {
+      result = fclose(stream);
+    }
   }
+
+  return result;
 }
 
 //result must be freed
@@ -3201,7 +3311,7 @@ char *splt_u_get_file_with_output_path(splt_state *state,
       malloc_number += strlen(path_of_split);
     }
     //allocate memory for the m3u file
-    if ((new_fname = malloc(malloc_number)) != NULL)
+    if ((new_fname = splt_u_malloc(malloc_number)) != NULL)
     {
       if (path_of_split)
       {
@@ -68,11 +68,11 @@ int scandir(const char *dir, struct dirent ***namelist,
     {
       if (files == NULL)
       {
-        files = malloc((sizeof *files));
+        files = splt_u_malloc((sizeof *files));
       }
       else
       {
-        files = realloc(files, (sizeof *files) * (number_of_files + 1));
+        files = splt_u_realloc(files, (sizeof *files) * (number_of_files + 1));
       }
       if (files == NULL)
       {
@@ -81,7 +81,7 @@ int scandir(const char *dir, struct dirent ***namelist,
         break;
       }
 
-      files[number_of_files] = malloc(sizeof(struct dirent));
+      files[number_of_files] = splt_u_malloc(sizeof(struct dirent));
       if (files[number_of_files] == NULL)
       {
         free_memory = 1;
@@ -164,11 +164,11 @@ int wscandir(const char *dir, struct _wdirent ***namelist,
     {
       if (files == NULL)
       {
-        files = malloc((sizeof *files));
+        files = splt_u_malloc((sizeof *files));
       }
       else
       {
-        files = realloc(files, (sizeof *files) * (number_of_files + 1));
+        files = splt_u_realloc(files, (sizeof *files) * (number_of_files + 1));
       }
       if (files == NULL)
       {
@@ -177,7 +177,7 @@ int wscandir(const char *dir, struct _wdirent ***namelist,
         break;
       }
 
-      files[number_of_files] = malloc(sizeof(struct _wdirent));
+      files[number_of_files] = splt_u_malloc(sizeof(struct _wdirent));
       if (files[number_of_files] == NULL)
       {
         free_memory = 1;
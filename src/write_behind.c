@@ -0,0 +1,307 @@
+/**********************************************************
+ *
+ * libmp3splt -- library based on mp3splt,
+ *               for mp3/ogg splitting without decoding
+ *
+ * Copyright (c) 2002-2005 M. Trotta - <mtrotta@users.sourceforge.net>
+ * Copyright (c) 2005-2010 Alexandru Munteanu - io_fx@yahoo.fr
+ *
+ * http://mp3splt.sourceforge.net
+ *
+ *********************************************************/
+
+/**********************************************************
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307,
+ * USA.
+ *
+ *********************************************************/
+
+
+#include <string.h>
+#include <errno.h>
+
+#ifndef __WIN32__
+#include <pthread.h>
+#endif
+
+#include "splt.h"
+
+#ifndef __WIN32__
+
+//data of one split file, written by the writer thread
+struct splt_wb_block {
+  FILE *stream;
+  size_t length;
+  unsigned char data[SPLT_WB_BLOCK_SIZE];
+};
+
+//queue of the blocks written behind the split, see SPLT_OPT_WRITE_BEHIND
+struct splt_write_behind {
+  pthread_t thread;
+  //protects the counters and the error, shared with the writer thread
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  //the block 'queued' is filled by the split while the queue is not
+  //full; the blocks from 'written' to 'queued' belong to the writer
+  struct splt_wb_block blocks[SPLT_WB_BLOCKS];
+  unsigned long queued;
+  unsigned long written;
+  //SPLT_TRUE while the split fills the block 'queued'
+  short filling;
+  //first stream which could not be written, and the errno of the error
+  FILE *error_stream;
+  int error_number;
+  short stop;
+  //resources used by the writer thread, and the part of them
+  //already added to the stats of the split
+  splt_thread_usage usage;
+  splt_thread_usage collected;
+};
+
+static void *splt_wb_writer_thread(void *data)
+{
+  splt_write_behind *wb = data;
+
+  pthread_mutex_lock(&wb->mutex);
+  for (;;)
+  {
+    while (wb->written == wb->queued && !wb->stop)
+    {
+      pthread_cond_wait(&wb->cond, &wb->mutex);
+    }
+    if (wb->written == wb->queued)
+    {
+      break;
+    }
+
+    struct splt_wb_block *block = &wb->blocks[wb->written % SPLT_WB_BLOCKS];
+    //the blocks following an error are dropped
+    short skip = (block->stream == wb->error_stream);
+    pthread_mutex_unlock(&wb->mutex);
+
+    size_t written = 0;
+    int error_number = 0;
+    if (!skip)
+    {
+      written = fwrite(block->data, 1, block->length, block->stream);
+      error_number = errno;
+    }
+
+    pthread_mutex_lock(&wb->mutex);
+    if (!skip && written < block->length && wb->error_stream == NULL)
+    {
+      wb->error_stream = block->stream;
+      wb->error_number = error_number;
+    }
+    wb->written++;
+    splt_st_get_thread_usage(&wb->usage);
+    pthread_cond_broadcast(&wb->cond);
+  }
+  pthread_mutex_unlock(&wb->mutex);
+
+  return NULL;
+}
+
+//returns the queue of the state, started on the first write
+//-returns NULL if error
+static splt_write_behind *splt_wb_get(splt_state *state)
+{
+  if (state->write_behind)
+  {
+    return state->write_behind;
+  }
+
+  splt_write_behind *wb = splt_u_malloc(sizeof(splt_write_behind));
+  if (wb == NULL)
+  {
+    return NULL;
+  }
+  memset(wb, 0x0, sizeof(splt_write_behind));
+
+  pthread_mutex_init(&wb->mutex, NULL);
+  pthread_cond_init(&wb->cond, NULL);
+
+  if (pthread_create(&wb->thread, NULL, splt_wb_writer_thread, wb) != 0)
+  {
+    pthread_cond_destroy(&wb->cond);
+    pthread_mutex_destroy(&wb->mutex);
+    free(wb);
+    return NULL;
+  }
+
+  state->write_behind = wb;
+
+  return wb;
+}
+
+//gives the block being filled to the writer thread
+static void splt_wb_queue_block(splt_write_behind *wb)
+{
+  if (wb->filling)
+  {
+    pthread_mutex_lock(&wb->mutex);
+    wb->queued++;
+    wb->filling = SPLT_FALSE;
+    pthread_cond_broadcast(&wb->cond);
+    pthread_mutex_unlock(&wb->mutex);
+  }
+}
+
+//copies the data in the queue of the writer thread, like fwrite
+//-returns less than 'nmemb' if a previous write to 'stream' failed
+size_t splt_wb_fwrite(splt_state *state, const void *ptr,
+    size_t size, size_t nmemb, FILE *stream)
+{
+  splt_write_behind *wb = splt_wb_get(state);
+  if (wb == NULL)
+  {
+    return fwrite(ptr, size, nmemb, stream);
+  }
+
+  pthread_mutex_lock(&wb->mutex);
+  short failed = (wb->error_stream == stream);
+  if (failed)
+  {
+    errno = wb->error_number;
+  }
+  pthread_mutex_unlock(&wb->mutex);
+
+  if (failed)
+  {
+    return 0;
+  }
+
+  const unsigned char *data = ptr;
+  size_t length = size * nmemb;
+
+  while (length > 0)
+  {
+    struct splt_wb_block *block = &wb->blocks[wb->queued % SPLT_WB_BLOCKS];
+
+    if (wb->filling &&
+        (block->stream != stream || block->length == SPLT_WB_BLOCK_SIZE))
+    {
+      splt_wb_queue_block(wb);
+      block = &wb->blocks[wb->queued % SPLT_WB_BLOCKS];
+    }
+
+    if (!wb->filling)
+    {
+      //waits for a free block if the writer is behind
+      pthread_mutex_lock(&wb->mutex);
+      while (wb->queued - wb->written == SPLT_WB_BLOCKS)
+      {
+        pthread_cond_wait(&wb->cond, &wb->mutex);
+      }
+      pthread_mutex_unlock(&wb->mutex);
+
+      block->stream = stream;
+      block->length = 0;
+      wb->filling = SPLT_TRUE;
+    }
+
+    size_t to_copy = SPLT_WB_BLOCK_SIZE - block->length;
+    if (to_copy > length)
+    {
+      to_copy = length;
+    }
+    memcpy(block->data + block->length, data, to_copy);
+    block->length += to_copy;
+    data += to_copy;
+    length -= to_copy;
+  }
+
+  return nmemb;
+}
+
+//waits until the queued data is written; must be called before any
+//other operation than splt_wb_fwrite on the stream
+//-returns 0, or EOF with errno set if a write to 'stream' failed
+int splt_wb_flush(splt_state *state, FILE *stream)
+{
+  splt_write_behind *wb = state->write_behind;
+  if (wb == NULL)
+  {
+    return 0;
+  }
+
+  splt_wb_queue_block(wb);
+
+  pthread_mutex_lock(&wb->mutex);
+  while (wb->written != wb->queued)
+  {
+    pthread_cond_wait(&wb->cond, &wb->mutex);
+  }
+  short failed = (wb->error_stream == stream);
+  if (failed)
+  {
+    errno = wb->error_number;
+    wb->error_stream = NULL;
+  }
+  splt_thread_usage usage = wb->usage;
+  pthread_mutex_unlock(&wb->mutex);
+
+  //the writer thread is kept from one split to another
+  splt_st_add_thread_usage(state, SPLT_PHASE_WRITE, &usage, &wb->collected);
+
+  return failed ? EOF : 0;
+}
+
+//stops the writer thread; the split files must be flushed before
+void splt_wb_free(splt_state *state)
+{
+  splt_write_behind *wb = state->write_behind;
+  if (wb == NULL)
+  {
+    return;
+  }
+
+  splt_wb_queue_block(wb);
+
+  pthread_mutex_lock(&wb->mutex);
+  wb->stop = SPLT_TRUE;
+  pthread_cond_broadcast(&wb->cond);
+  pthread_mutex_unlock(&wb->mutex);
+
+  pthread_join(wb->thread, NULL);
+
+  pthread_cond_destroy(&wb->cond);
+  pthread_mutex_destroy(&wb->mutex);
+  free(wb);
+  state->write_behind = NULL;
+}
+
+#else
+
+//no threads on windows for the moment, the data is written directly
+size_t splt_wb_fwrite(splt_state *state, const void *ptr,
+    size_t size, size_t nmemb, FILE *stream)
+{
+  return fwrite(ptr, size, nmemb, stream);
+}
+
+int splt_wb_flush(splt_state *state, FILE *stream)
+{
+  return 0;
+}
+
+void splt_wb_free(splt_state *state)
+{
+}
+
+#endif
+